@@ -0,0 +1,32 @@
+#ifndef IVY_ASSET_LOADER_H
+#define IVY_ASSET_LOADER_H
+
+#include "ivy/types.h"
+#include "raylib/raylib.h"
+
+#include <stddef.h>
+
+#define ASSET_LOADER_WORKERS        2
+#define ASSET_LOADER_CAPACITY       512     // power of two
+#define ASSET_UPLOADS_PER_FRAME     8
+
+// 0 is never handed out; it means "already loaded" (e.g. synchronous fallback).
+typedef u32 TextureHandle;
+
+typedef enum {
+    TEXTURE_FILE_IMAGE_BIN = 0,     // raw RGBA with a 16-byte header
+    TEXTURE_FILE_PNG_BIN            // u32 size followed by PNG bytes
+} TextureFileType;
+
+void            InitAssetLoader(u32 workerCount);
+void            ShutdownAssetLoader(void);
+
+TextureHandle   LoadTextureAsync(const char *path, TextureFileType type, Texture2D *target);
+void            CancelTextureLoads(const void *owner, size_t ownerSize);
+
+bool            IsTextureLoaded(TextureHandle handle);
+bool            IsTextureLoadPending(const Texture2D *target);
+bool            IsAssetLoaderIdle(void);
+u32             UploadLoadedTextures(u32 maxUploads);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef IVY_ATLAS_H
+#define IVY_ATLAS_H
+
+#include "ivy/types.h"
+
+#include <stdbool.h>
+
+// Kept free of raylib.h so the atlas packer can share the file layout.
+
+#define ATLAS_INDEX_PATH    "assets/atlases/index.bin"
+#define ATLAS_MAGIC         0x4C545649u     // "IVTL"
+#define ATLAS_VERSION       1
+#define ATLAS_PATH_LEN      64
+#define ATLAS_MAX_SIZE      4096
+#define ATLAS_PADDING       1
+
+// Layout: AtlasHeader | AtlasPage[pageCount] | AtlasRegion[regionCount] sorted by (hash, path).
+typedef struct {
+    u32 magic;
+    u32 version;
+    u32 pageCount;
+    u32 regionCount;
+} AtlasHeader;
+
+typedef struct {
+    char    path[ATLAS_PATH_LEN];
+    u32     width;
+    u32     height;
+} AtlasPage;
+
+typedef struct {
+    char    path[ATLAS_PATH_LEN];   // the standalone image this region replaces
+    u32     hash;
+    u32     page;
+    u32     x;
+    u32     y;
+    u32     width;
+    u32     height;
+} AtlasRegion;
+
+bool                LoadAtlasIndex(const char *path);
+void                UnloadAtlasIndex(void);
+
+const AtlasRegion  *FindAtlasRegion(const char *path);
+const AtlasPage    *GetAtlasPage(u32 page);
+
+#endif
\ No newline at end of file
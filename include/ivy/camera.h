@@ -15,5 +15,6 @@ typedef struct {
 
 GameCamera  InitGameCamera(u32 virtualWidth, u32 virtualHeight);
 void        UpdateGameCamera(GameCamera *camera, const Player *player, const Tilemap *tilemap, float frameTime);
+Rectangle   GetGameCameraView(const GameCamera *camera);
 
 #endif
\ No newline at end of file
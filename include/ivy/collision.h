@@ -7,12 +7,46 @@ typedef struct {
     int x, y, w, h;
 } RectInfo;
 
+#define COLLISION_MERGE_THREADS     8               // layers merged in parallel at most
+#define COLLISION_PARALLEL_TILES    (256u * 256u)   // smaller maps merge on the calling thread
+#define COLLISION_BUCKET_SHIFT      4               // 16x16 tile blocks
+
+typedef struct {
+    u32        *rects;          // indices of the rects touching the block, unordered
+    u32         count;
+    u32         capacity;
+} CollisionBucket;
+
 typedef struct {
-    Rectangle  *rect;
-    u32         rectCount;
+    Rectangle       *rect;
+    u32             rectCount;
+    u32             rectCapacity;
+    u64             *solid;         // one bit per tile, rows padded to whole words
+    u32             width;          // in tiles
+    u32             height;
+    u32             wordsPerRow;
+    float           tileWidth;
+    float           tileHeight;
+    CollisionBucket *buckets;       // finds the rects of an area without a scan of all of them
+    u32             bucketsX;
+    u32             bucketsY;
 } Collision;
 
+u32         CollectCollisionRects(const Tilemap *tilemap, RectInfo **outRects);
+Collision  *CreateCollision(const RectInfo *rects, u32 rectCount, u32 width, u32 height, float tileWidth, float tileHeight);
 Collision  *InitCollisionAllLayers(const Tilemap *tilemap);
 void        DestroyCollision(Collision *collision);
 
+// Refreshes the bitmap under region (in tiles) and re-merges only the rects touching it.
+// Untouched rects keep their index, except that when the region needs fewer rects than
+// it had, rects from the end of the array move into the gaps.
+void        UpdateCollisionRegion(Collision *collision, const Tilemap *tilemap, TileRect region);
+
+// Tiles outside the map are open, as no rect covers them
+static inline bool IsCollisionTileSolid(const Collision *collision, const int x, const int y)
+{
+    if ((u32)x >= collision->width || (u32)y >= collision->height) return false;
+    return (collision->solid[(u32)y * collision->wordsPerRow + ((u32)x >> 6)] >> ((u32)x & 63)) & 1;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef IVY_ENTITY_H
+#define IVY_ENTITY_H
+
+#include "ivy/collision.h"
+#include "ivy/texture_registry.h"
+#include "ivy/player/player_internal.h"
+
+// Tile-stepping characters other than the player, kept as parallel arrays so the movement
+// and animation systems stream through only the fields they touch. Entity i lives at index i
+// of every array; despawning swaps the last entity into the hole, so indices move and an
+// EntityId is what to hold on to. An id is a slot in its low ENTITY_SLOT_SHIFT bits and the
+// slot's generation above them, so the id of a despawned entity stays dead once its slot
+// is reused. Stepping follows the player's rules (StartMoving and
+// UpdatePlayerMovement), with a per-entity intent in place of the keyboard.
+
+#define ENTITY_DEFAULT_CAPACITY     64
+#define ENTITY_MAX_APPEARANCES      64
+#define ENTITY_APPEARANCE_LAYERS    4
+#define ENTITY_FRAME_SIZE           64.0f
+#define ENTITY_SLOT_SHIFT           20
+#define ENTITY_SLOT_MASK            ((1u << ENTITY_SLOT_SHIFT) - 1)
+
+#define ENTITY_INTENT_NONE          0       // stands still once the current step ends
+#define ENTITY_INTENT_DIR_MASK      0x07    // Direction + 1
+#define ENTITY_INTENT_RUN           0x80
+
+typedef u32 EntityId;           // generation << ENTITY_SLOT_SHIFT | slot; 0 is never an entity
+
+typedef struct {
+    TextureRegion   layers[ENTITY_APPEARANCE_LAYERS];   // drawn first to last, like the player's stack
+    u32             layerCount;
+} EntityAppearance;
+
+typedef struct {
+    u32         count;
+    u32         capacity;
+
+    // Components, all indexed by entity
+    int        *tileX;
+    int        *tileY;
+    int        *targetX;
+    int        *targetY;
+    float      *moveTimer;
+    float      *moveDuration;
+    Vector2    *position;       // pixel center, lerped between tile centers
+    u8         *direction;      // Direction
+    u8         *action;         // PlayerAction
+    u8         *moving;
+    u8         *intent;         // ENTITY_INTENT_*; written by whatever drives the entity
+    u8         *frame;
+    u8         *frameDirection;
+    float      *frameTimer;
+    u16        *appearance;
+    EntityId   *id;
+    u32        *stepping;       // scratch for UpdateEntityMovement
+
+    // Slot to index; freed slots are reused newest first
+    u32        *indexOf;
+    u32        *generation;     // bumped when the slot's entity despawns
+    u32        *freeSlots;
+    u32         freeCount;
+    u32         slotCount;      // highest slot handed out
+    u32         slotCapacity;
+
+    EntityAppearance appearances[ENTITY_MAX_APPEARANCES];
+    u32              appearanceCount;
+} EntityStore;
+
+static inline u8 MakeEntityIntent(const Direction dir, const bool run)
+{
+    return (u8)((dir + 1) | (run ? ENTITY_INTENT_RUN : 0));
+}
+
+EntityStore *CreateEntityStore(u32 capacity);
+void         DestroyEntityStore(EntityStore *store);
+
+// Sheets laid out like the player's; returns the handle SpawnEntity takes
+u16          AddEntityAppearance(EntityStore *store, const char *const *sheetPaths, u32 layerCount);
+
+EntityId     SpawnEntity(EntityStore *store, int tileX, int tileY, Direction facing, u16 appearance, u32 tileSize);
+void         DespawnEntity(EntityStore *store, EntityId id);
+// UINT32_MAX once the entity is gone, even if its slot holds a newer one
+u32          GetEntityIndex(const EntityStore *store, EntityId id);
+void         SetEntityIntent(EntityStore *store, EntityId id, u8 intent);
+
+void         UpdateEntityMovement(EntityStore *store, float frameTime, const Collision *collision, u32 tileSize);
+void         UpdateEntityAnimation(EntityStore *store, float frameTime);
+void         UpdateEntities(EntityStore *store, float frameTime, const Collision *collision, u32 tileSize);
+// Only entities whose frame overlaps view
+void         DrawEntities(const EntityStore *store, Rectangle view);
+
+#endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define IVY_GAME_H
 
 #include "ivy/scenes.h"
+#include "ivy/glyph_cache.h"
 
 typedef struct {
     u32 screenWidth;
@@ -12,6 +13,7 @@ struct Game {
     ScreenData          screen;
     VirtualResolution   viewport;
     Font                fonts[2];
+    GlyphCache         *glyphCache;     // secondary (CJK) font, rasterized on demand
     Texture2D           cursors[2];
     SceneManager        sceneManager;
 };
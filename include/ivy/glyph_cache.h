@@ -0,0 +1,37 @@
+#ifndef IVY_GLYPH_CACHE_H
+#define IVY_GLYPH_CACHE_H
+
+#include "ivy/types.h"
+#include "raylib/raylib.h"
+
+// Rasterizes glyphs the first time text needs them and packs them into a few
+// atlas pages; when every page is full the least recently drawn page is recycled.
+// Meant for fonts with far too many codepoints to bake up front (CJK).
+
+#define GLYPH_PAGE_SIZE         1024
+#define GLYPH_CACHE_PAGES       4       // 8 MB of GRAY_ALPHA pages at most
+#define GLYPH_CACHE_CAPACITY    2048
+#define GLYPH_PADDING           1
+#define GLYPH_LINE_SPACING      2       // raylib's default text line spacing
+
+typedef struct GlyphCache GlyphCache;
+
+typedef struct {
+    u32 glyphs;
+    u32 pages;
+    u32 rasterized;
+    u32 evictions;
+} GlyphCacheStats;
+
+// Without font data the cache draws everything with fallback instead
+GlyphCache     *CreateGlyphCache(const char *path, int baseSize, Font fallback);
+void            DestroyGlyphCache(GlyphCache *cache);
+void            UpdateGlyphCache(GlyphCache *cache);    // once per frame, before any text is drawn
+
+// Same parameters and layout rules as DrawTextEx / MeasureTextEx
+void            DrawTextCached(GlyphCache *cache, const char *text, Vector2 position, float fontSize, float spacing, Color tint);
+Vector2         MeasureTextCached(GlyphCache *cache, const char *text, float fontSize, float spacing);
+
+GlyphCacheStats GetGlyphCacheStats(const GlyphCache *cache);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef IVY_IMAGE_CODEC_H
+#define IVY_IMAGE_CODEC_H
+
+#include "ivy/types.h"
+
+#include <stdbool.h>
+
+// Lossless RGBA8 codec (QOI-style op stream). No raylib here so tools can link it directly.
+
+#define IMAGE_CODEC_MAGIC       0x5A595649u     // "IVYZ"
+#define IMAGE_CODEC_VERSION     1
+#define IMAGE_CODEC_FORMAT      7               // PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+
+typedef struct {
+    u32 magic;
+    u32 version;
+    u32 width;
+    u32 height;
+    u32 format;
+    u32 encodedSize;    // op stream bytes following the header
+} ImageCodecHeader;
+
+bool    ReadEncodedImageHeader(const u8 *data, u32 size, ImageCodecHeader *outHeader);
+
+u8     *EncodeImagePixels(const u8 *rgba, u32 width, u32 height, u32 *outSize);
+bool    DecodeImagePixels(const u8 *data, u32 size, u8 *outRgba);
+
+#endif
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "raylib/raylib.h"
 
 typedef struct Player Player;
+typedef struct GlyphCache GlyphCache;
 
 typedef enum {
     INV_TAB_BAG = 0,
@@ -28,6 +29,6 @@ void            InventoryUIOpen(InventoryUI *ui, const VirtualResolution *vr);
 void            InventoryUIClose(InventoryUI *ui);
 
 bool            InventoryUIUpdate(InventoryUI *ui, Player *player);
-void            InventoryUIDraw(const InventoryUI *ui, const Player *player, const VirtualResolution *vr, const Font *font);
+void            InventoryUIDraw(const InventoryUI *ui, const Player *player, const VirtualResolution *vr, const Font *font, GlyphCache *names);
 
 #endif
\ No newline at end of file
@@ -2,7 +2,7 @@
 #define IVY_ITEM_H
 
 #include "ivy/types.h"
-#include "raylib/raylib.h"
+#include "ivy/texture_registry.h"
 
 #define ITEM_MANAGER_CAPACITY 256
 
@@ -43,8 +43,8 @@ typedef enum {
 } ItemType;
 
 typedef struct {
-    Texture2D       iconTexture;
-    Texture2D       charTexture;
+    TextureRegion   icon;
+    TextureRegion   sprite;
     Texture2D       portraitTex;
     Vector2         position;
     EquipmentSlot   slot;
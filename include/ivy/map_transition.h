@@ -0,0 +1,49 @@
+#ifndef IVY_MAP_TRANSITION_H
+#define IVY_MAP_TRANSITION_H
+
+#include "ivy/pathfinding.h"
+#include "ivy/entity.h"
+#include "ivy/platform.h"
+
+// A map's event tile (TilemapHeader.eventGoto*) leads to map eventGotoMapId; the player
+// arrives on that map's spawn point. Walking near the tile loads the destination ahead of
+// time so stepping on it only swaps pointers, and the map left behind stays loaded so
+// turning straight back is just as quick. The destination is read on a thread of its own;
+// only what needs the main thread (the texture registry, GL) is done there.
+
+#define MAP_PRELOAD_TILES   4       // the destination starts loading this close to the event tile
+#define MAP_RELEASE_TILES   6       // and is let go past this distance
+
+typedef struct {
+    Tilemap     *tilemap;
+    Collision   *collision;
+    PathService *paths;         // built with the map, shared by everything that routes on it
+    EntityStore *entities;      // the map's NPCs; they stay put while the player is elsewhere
+    u32         id;             // 0 when the slot is empty
+} LoadedMap;
+
+typedef struct {
+    LoadedMap   map;            // everything but the textures, filled in by the thread
+    Thread      thread;
+    u32         id;             // 0 when no load is under way
+    u32         done;           // set once map is complete
+} MapLoadJob;
+
+typedef struct {
+    LoadedMap   next;           // destination of the event tile nearby
+    LoadedMap   previous;       // the map the player came from
+    MapLoadJob  load;           // a destination still being read; it becomes next once done
+    bool        armed;          // false until the player leaves the tile they arrived on
+} MapTransition;
+
+LoadedMap   LoadMapById(u32 id);
+void        UnloadLoadedMap(LoadedMap *map);
+
+// Returns true when the player stepped on the event tile this frame; current then holds the
+// destination and the player belongs on its spawn point
+bool        UpdateMapTransition(MapTransition *mt, LoadedMap *current, u32 tileX, u32 tileY);
+// Bakes the destination's chunks around its spawn point, view sized like the camera's
+void        StreamMapTransition(MapTransition *mt, Vector2 viewSize);
+void        DestroyMapTransition(MapTransition *mt);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef IVY_PACK_H
+#define IVY_PACK_H
+
+#include "ivy/types.h"
+
+#include <stdbool.h>
+
+#define PACK_FILE_PATH  "assets.pack"
+#define PACK_MAGIC      0x4B505649u     // "IVPK"
+#define PACK_VERSION    1
+#define PACK_ALIGNMENT  16
+
+// Layout: PackHeader | PackEntry[entryCount] sorted by (hash, path) | path strings | data blobs.
+typedef struct {
+    u32 magic;
+    u32 version;
+    u32 entryCount;
+    u32 stringTableSize;
+} PackHeader;
+
+typedef struct {
+    u32 hash;
+    u32 pathOffset;
+    u32 pathLength;
+    u32 size;
+    u64 offset;
+} PackEntry;
+
+static inline u32 PackHashPath(const char *path)
+{
+    u32 hash = 2166136261u;
+    for (const u8 *c = (const u8 *)path; *c; c++) {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool        MountPack(const char *path);
+void        UnmountPack(void);
+bool        IsPackMounted(void);
+const u8   *PackFind(const char *path, u32 *outSize);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef IVY_PATHFINDING_H
+#define IVY_PATHFINDING_H
+
+#include "ivy/collision.h"
+
+// Routes over the collision bitmap, moving between edge-adjacent tiles like the player.
+// Close goals run a jump point search straight on the grid. Farther ones plan over a
+// graph of cluster entrances (HPA*), then refine each leg back to tiles with the same
+// search, kept inside one cluster. A cluster is built the first time a search reaches it,
+// and a tile edit only rebuilds the clusters around it.
+
+#define PATH_CLUSTER_SHIFT      4       // 16x16 tile clusters
+#define PATH_CLUSTER_TILES      (1u << PATH_CLUSTER_SHIFT)
+#define PATH_CLUSTER_NODES      32      // a side holds 8 entrances at most
+#define PATH_REQUEST_SHIFT      8
+#define PATH_MAX_REQUESTS       (1u << PATH_REQUEST_SHIFT)
+#define PATH_FRAME_BUDGET_US    1000    // queued requests served per frame
+
+typedef struct PathService PathService;
+
+typedef struct {
+    int x, y;
+} PathTile;
+
+typedef struct {
+    PathTile   *tiles;          // start to goal, both included
+    u32         count;
+    u32         capacity;
+} Path;
+
+typedef enum {
+    PATH_NONE = 0,              // never requested, cancelled or already collected
+    PATH_PENDING,
+    PATH_FOUND,
+    PATH_UNREACHABLE
+} PathStatus;
+
+typedef u32 PathRequest;        // 0 is never a request
+
+typedef struct {
+    u32 clusters;
+    u32 nodes;
+    u32 clusterRebuilds;
+    u32 directSearches;
+    u32 clusterSearches;
+    u32 pending;
+} PathServiceStats;
+
+// The collision has to outlive the service; no cluster is built yet
+PathService *CreatePathService(const Collision *collision);
+void         DestroyPathService(PathService *service);
+// After UpdateCollisionRegion over the same tiles; clusters rebuild on the next search
+void         InvalidatePathRegion(PathService *service, TileRect region);
+
+// Solves right away. out keeps its allocation between calls.
+bool         FindPath(PathService *service, PathTile start, PathTile goal, Path *out);
+void         FreePath(Path *path);
+
+// Queued requests are solved by UpdatePathService, oldest first, in slices of a few dozen
+// heap pops until budgetMicros have passed (at least one slice per call); a search left
+// unfinished carries on from there next call. Returns 0 when every slot is taken.
+PathRequest  RequestPath(PathService *service, PathTile start, PathTile goal);
+void         UpdatePathService(PathService *service, u64 budgetMicros);
+// A finished request hands its route to out and frees its slot
+PathStatus   CollectPath(PathService *service, PathRequest request, Path *out);
+void         CancelPath(PathService *service, PathRequest request);
+
+PathServiceStats GetPathServiceStats(const PathService *service);
+
+#endif
\ No newline at end of file
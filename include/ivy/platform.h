@@ -0,0 +1,39 @@
+#ifndef IVY_PLATFORM_H
+#define IVY_PLATFORM_H
+
+#include "ivy/types.h"
+
+#include <stdbool.h>
+
+// Kept free of raylib.h so the OS headers never see its symbols.
+
+typedef struct {
+    const u8   *data;
+    u64         size;
+    void       *handle;
+} MappedFile;
+
+typedef void (*ThreadFunc)(void *arg);
+
+typedef struct {
+    void   *handle;
+} Thread;
+
+typedef struct {
+    void   *handle;
+} Semaphore;
+
+bool    MapFile(const char *path, MappedFile *out);
+void    UnmapFile(MappedFile *file);
+
+bool    StartThread(Thread *thread, ThreadFunc func, void *arg);
+void    JoinThread(Thread *thread);
+u32     GetCpuCount(void);
+u64     GetMonotonicMicros(void);
+
+void    InitSemaphore(Semaphore *sem, u32 initialCount);
+void    DestroySemaphore(Semaphore *sem);
+void    SignalSemaphore(Semaphore *sem, u32 count);
+void    WaitSemaphore(Semaphore *sem);
+
+#endif
\ No newline at end of file
@@ -17,6 +17,7 @@ struct Player {
 };
 
 Player  *InitPlayer(u32 spawnX, u32 spawnY, u32 tileSize);
+void     PlacePlayer(Player *player, u32 tileX, u32 tileY, u32 tileSize);     // stops any move in progress
 void     UpdatePlayer(Player *player, float frameTime, const Collision *collision, u32 tileSize);
 void     DrawPlayer(const Player *player, const VirtualResolution *vr);
 void     DrawPlayerDebug(const Player *player);
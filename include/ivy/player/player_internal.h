@@ -3,7 +3,7 @@
 
 #include "ivy/types.h"
 #include "ivy/collision.h"
-#include "raylib/raylib.h"
+#include "ivy/texture_registry.h"
 
 #define BASE_MOVE_DURATION      0.42f
 #define RUN_SPEED_MULTIPLIER    0.595f
@@ -19,9 +19,9 @@ typedef enum {
 } PlayerAction;
 
 typedef struct {
-    Texture2D       hairTexture;
-    Texture2D       headTexture;
-    Texture2D       bodyTexture;
+    TextureRegion   hairSprite;
+    TextureRegion   headSprite;
+    TextureRegion   bodySprite;
 
     Texture2D       headPortrait;
     Texture2D       bodyPortrait;
@@ -54,12 +54,13 @@ typedef struct {
 
 
 u32     GetSpriteRow(const Player *player);
+u32     GetActionSpriteRow(PlayerAction action, Direction direction);
 float   GetMoveDuration(PlayerAction action);
 
 bool    GetMovementInput(Vector2 *outDir, Direction *outFacing);
 bool    DirectionKeyPressed(Direction dir);
-bool    IsTileSolid(Vector2 tilePos, const Collision *collision, u32 tileSize);
-bool    StartMoving(Player *player, Vector2 inputDir, Direction nextDir, bool isRunning, const Collision *collision, u32 tileSize);
+bool    IsTileSolid(Vector2 tilePos, const Collision *collision);
+bool    StartMoving(Player *player, Vector2 inputDir, Direction nextDir, bool isRunning, const Collision *collision);
 
 void    UpdatePlayerMovement(Player *player, float frameTime, const Collision *collision, u32 tileSize);
 void    UpdateAnimation(Player *player, float frameTime);
@@ -4,6 +4,7 @@
 #include "ivy/types.h"
 #include "ivy/camera.h"
 #include "ivy/collision.h"
+#include "ivy/map_transition.h"
 #include "ivy/item.h"
 #include "ivy/inventory_ui.h"
 #include "raylib/raylib.h"
@@ -28,11 +29,12 @@ typedef struct {
 
 typedef struct {
     GameCamera      gameCamera;
-    Tilemap        *tilemap;
-    Collision      *collision;
+    LoadedMap       map;
+    MapTransition   transition;
     Player         *player;
     ItemManager    *itemManager;
     InventoryUI     inventoryUI;
+    bool            assetsPending;
 } SceneGameplayData;
 
 typedef struct {
@@ -0,0 +1,47 @@
+#ifndef IVY_TEXTURE_REGISTRY_H
+#define IVY_TEXTURE_REGISTRY_H
+
+#include "ivy/asset_loader.h"
+
+#define TEXTURE_REGISTRY_CAPACITY   512
+#define TEXTURE_REGISTRY_WAITERS    1024
+#define TEXTURE_CACHE_BYTES         (64ull * 1024ull * 1024ull)  // kept for unreferenced textures
+
+// source.width == 0 means the whole texture (standalone image, no atlas entry)
+typedef struct {
+    Texture2D   texture;
+    Rectangle   source;
+} TextureRegion;
+
+typedef enum {
+    TEXTURE_PENDING = 0,
+    TEXTURE_READY,
+    TEXTURE_FAILED              // the load gave up; the target stays empty
+} TextureState;
+
+typedef struct {
+    u32 acquires;
+    u32 hits;
+    u32 misses;
+    u32 evictions;
+    u32 entries;
+    u64 bytesResident;
+} TextureRegistryStats;
+
+const char *InternPath(const char *path);
+
+void        AcquireTexture(const char *path, TextureFileType type, Texture2D *target);
+void        ReleaseTexture(Texture2D *target);
+TextureState GetTextureState(const Texture2D *target);
+
+void        AcquireTextureRegion(const char *path, TextureRegion *region);
+void        ReleaseTextureRegion(TextureRegion *region);
+Rectangle   GetRegionSource(const TextureRegion *region);
+Rectangle   GetRegionSubRect(const TextureRegion *region, Rectangle local);
+
+void        UpdateTextureRegistry(void);
+void        DestroyTextureRegistry(void);
+
+TextureRegistryStats GetTextureRegistryStats(void);
+
+#endif
\ No newline at end of file
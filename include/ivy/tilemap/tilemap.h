@@ -6,21 +6,52 @@
 
 
 struct Tilemap {
-    TilemapHeader   header;
-    Layer           *layers;
-    Tileset         *tilesets;
-
-    RenderTexture2D canva;
-
-    u8              *tileTypeTable;
-    u8              *tilesetIndexTable;
-    TileDrawInfo    *tileDrawInfoTable;
-    u32             maxGid;
+    TilemapHeader           header;
+    TilemapFileHeader       file;               // zeroed for v1 maps
+    Tileset                 *tilesets;
+
+    AssetData               source;             // kept for the map's lifetime, chunks are read from it on demand
+    const u8                *layerData;         // v1: first layer record
+    const u8                *chunkIndex;        // v3: TilemapChunkEntry table
+    TileStream              *stream;            // chunk cache, mutable through const accessors
+    bool                    drawInfoReady;
+    float                   animTime;           // seconds, the clock every animated tile shares
+    bool                    hasAnimatedTiles;
+
+    const TilemapRect       *cookedRects;       // cooked sections, NULL when missing
+    u32                     cookedRectCount;
+    const TilemapQuadRange  *cookedRanges;
+    const TilemapQuad       *cookedQuads;
+    u32                     cookedQuadCount;
+
+    // Layer data holds local tile ids rather than gids (see tilemap_format.h), and every
+    // table below is indexed by them; 0 is the empty tile
+    u8                      *tileTypeTable;
+    u16                     *tilesetIndexTable;
+    u32                     *tileFlagTable;     // TILE_PROP_* bits of every tile
+    TileDrawInfo            *tileDrawInfoTable;
+    u32                     *tileGids;
+    u32                     *tileOrder;         // local ids sorted by gid
+    u32                     *tilesetsByGid;     // tileset indices sorted by firstGid
+    u32                     tileCount;          // ids run from 1 to tileCount
+    u32                     tileCapacity;
+    TileAutotileTable       *autotileTable;
 };
 
 
 Tilemap    *LoadTilemapById(u32 id);
-void        DrawTilemapFromCanva(const Tilemap *tilemap);
+// LoadTilemapById split in two: the first touches no GL or texture registry state, so it
+// may run on any thread; the second finishes the map on the main thread
+Tilemap    *ReadTilemapById(u32 id);
+void        AcquireTilemapTextures(Tilemap *tilemap);
+Tilemap    *LoadTilemapFromAsset(AssetData asset);     // takes the asset, acquires no textures
+void        UpdateTilemapStreaming(Tilemap *tilemap, Rectangle view);
+// Both draw the baked canvases at the mip level that suits zoom, then the animated
+// tiles of their half on top
+void        DrawTilemap(const Tilemap *tilemap, Rectangle view, float zoom);              // below entities
+void        DrawTilemapForeground(const Tilemap *tilemap, Rectangle view, float zoom);    // after entities
+void        DrawTilemapOverview(const Tilemap *tilemap, Rectangle dest, Color tint);     // every chunk baked so far
+void        SetTile(Tilemap *tilemap, u32 layer, u32 x, u32 y, u32 gid);  // any tileset gid, redrawn on the next streaming update
 void        UnloadTilemap(Tilemap *tilemap);
 
 
@@ -0,0 +1,17 @@
+#ifndef IVY_TILEMAP_COMPOSE_H
+#define IVY_TILEMAP_COMPOSE_H
+
+#include "ivy/tilemap/tilemap.h"
+
+// CPU twin of the chunk bake: the same autotile-resolved quads, composited from decoded
+// tileset images with the GPU's default alpha blend. Needs no GL context, so tools can
+// render and hash whole maps, and the result uploads once with LoadTextureFromImage.
+
+#define TILEMAP_COMPOSE_THREADS     8       // row bands composited in parallel at most
+#define TILEMAP_COMPOSE_MIN_ROWS    32      // below this a band is not worth a thread
+
+// tilesets holds one PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 image per map tileset. Draw info must
+// be built. Returns an RGBA8 image of rect holding its background or its foreground quads.
+Image   ComposeTilemapImage(const Tilemap *tilemap, const Image *tilesets, TileRect rect, bool foreground);
+
+#endif
\ No newline at end of file
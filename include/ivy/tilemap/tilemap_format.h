@@ -0,0 +1,113 @@
+#ifndef IVY_TILEMAP_FORMAT_H
+#define IVY_TILEMAP_FORMAT_H
+
+#include "ivy/types.h"
+
+// On-disk map layout, kept free of raylib.h so the map tools can share it.
+//
+// v1: TilemapHeader | tilesets | per layer { u32 width, u32 height, u32 gids[width * height] }
+// v3: TilemapFileHeader | TilemapHeader | tilesets | u32 tileGids[tileCount]
+//     | TilemapChunkEntry[chunksX * chunksY] | chunk blobs
+//     | optional cooked sections, listed by a u32 count and TilemapSection[count] at sectionOffset
+//     Each blob holds layerCount planes of TILEMAP_CHUNK_TILES^2 local tile ids, zero-padded at the
+//     map edge. Id i > 0 stands for tileGids[i - 1]; the table is ascending and holds every gid
+//     the layers use plus the frames of their animated tiles, so frames keep consecutive ids.
+//
+// Cooked sections let the loader skip work it can do itself, so a missing one is never an error:
+//     COLLISION: u32 rectCount | TilemapRect[rectCount], merged solid tiles of every layer
+//     QUADS:     TilemapQuadRange[chunksX * chunksY] | TilemapQuad[], each range holds the
+//                autotile-resolved draw list of one chunk bake, apron included, with the
+//                foreground quads last
+
+#define TILEMAP_MAGIC           0x50414D56u     // "VMAP", never a plausible v1 width
+#define TILEMAP_VERSION         3
+#define TILEMAP_CHUNK_SHIFT     4               // 512x512 px chunk canvases with 32 px tiles
+#define TILEMAP_CHUNK_TILES     (1u << TILEMAP_CHUNK_SHIFT)
+#define TILEMAP_CHUNK_MASK      (TILEMAP_CHUNK_TILES - 1)
+#define TILEMAP_BLOB_ALIGNMENT  16
+
+#define TILEMAP_SECTION_COLLISION   0x4C4C4F43u     // "COLL"
+#define TILEMAP_SECTION_QUADS       0x32445551u     // "QUD2", older "QUAD" ranges had no foreground count
+
+typedef enum {
+    TILE_NONE = 0,
+    TILE_GROUND,
+    TILE_WALL,
+    TILE_BORDER,
+    TILE_COLLISION,
+    TILE_CARPET,
+    TILE_TABLE
+} TileType;
+
+#define TILE_PROP_TYPE_MASK     0xFFFFu
+#define TILE_PROP_FOREGROUND    (1u << 16)      // drawn above entities
+
+// Animated tiles play the tiles that follow them in their tileset, one frame every
+// (duration * 10) ms. Autotiles ignore these bits.
+#define TILE_PROP_FRAMES_SHIFT      20          // frame count - 1, 0 when not animated
+#define TILE_PROP_FRAMES_MASK       0xFu
+#define TILE_PROP_DURATION_SHIFT    24          // frame duration in 10 ms steps
+#define TILE_PROP_DURATION_MASK     0xFFu
+
+typedef struct {
+    u32         id;
+    u32         type;       // TileType, TILE_PROP_* flags above TILE_PROP_TYPE_MASK
+} TileProp;
+
+typedef struct {
+    u32 width;
+    u32 height;
+    u32 tileWidth;
+    u32 tileHeight;
+    u32 tilesetCount;
+    u32 layerCount;
+    u32 mapId;
+    u32 spawnPointX;
+    u32 spawnPointY;
+
+    u32 eventGotoMapId;
+    u32 eventGotoTileX;
+    u32 eventGotoTileY;
+} TilemapHeader;
+
+typedef struct {
+    u32 magic;
+    u32 version;
+    u32 chunkTiles;
+    u32 chunksX;
+    u32 chunksY;
+    u32 maxGid;         // highest gid of the source layers
+    u32 indexOffset;
+    u32 sectionOffset;  // 0 when the map has not been cooked
+    u32 tileOffset;
+    u32 tileCount;
+} TilemapFileHeader;
+
+typedef struct {
+    u32 offset;
+    u32 size;       // 0 for a chunk with no tiles on any layer
+} TilemapChunkEntry;
+
+typedef struct {
+    u32 tag;
+    u32 offset;
+    u32 size;
+} TilemapSection;
+
+typedef struct {
+    u32 x, y, w, h;     // in tiles
+} TilemapRect;
+
+typedef struct {
+    float   srcX, srcY, srcWidth, srcHeight;
+    float   dstX, dstY;
+    u32     tileset;
+} TilemapQuad;
+
+typedef struct {
+    u32 first;          // index into the section's TilemapQuad array
+    u32 count;
+    u32 foreground;     // trailing quads of the range that go above entities
+} TilemapQuadRange;
+
+#endif
\ No newline at end of file
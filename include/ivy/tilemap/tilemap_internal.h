@@ -3,94 +3,201 @@
 
 #include "raylib/raylib.h"
 #include "ivy/types.h"
-
-#include <stdio.h>
+#include "ivy/utils.h"
+#include "ivy/tilemap/tilemap_format.h"
 
 #define TILEMAP_ASSET_PATH "assets/tilemaps"
 #define TILESET_ASSET_PATH "assets/tilesets"
 
-#define IS_TILE_VALID(x, y, w, h) \
-    ((x) >= 0 && (x) < (w) && (y) >= 0 && (y) < (h))
-
-#define HAS_TILE(layer, x, y, width, height) \
-    (IS_TILE_VALID((x), (y), (width), (height)) && (layer)->data[(y) * (width) + (x)] != 0)
+#define TILEMAP_CHUNK_DATA_BUDGET   (8u * 1024u * 1024u)    // resident tile id data
+#define TILEMAP_CHUNK_VRAM_BUDGET   (64u * 1024u * 1024u)   // baked chunk textures
+#define TILEMAP_BAKES_PER_FRAME     8
+#define TILEMAP_CANVAS_LEVELS       2       // at least 2; full size and half cover the camera's 0.5 zoom floor
+#define TILEMAP_OVERVIEW_SHIFT      2       // 1/4 size, half of the smallest level
+#define TILEMAP_OVERVIEW_MAX_SIZE   2048    // bigger maps shrink further, to at most this many pixels a side
+#define TILEMAP_ANIM_STILLS         0xFFFFFFFFu     // TM_CollectQuads animLayer that bakes animated tiles too
+
+#define HAS_TILE(tilemap, layer, x, y) (TM_GetTileId((tilemap), (layer), (x), (y)) != 0)
+
+// Neighbour bits of an autotile mask, clockwise from north. A neighbour mask holds the
+// same-type bits in its low byte and the occupied (id != 0) bits in its high byte.
+#define TILE_NEIGHBOUR_N        (1u << 0)
+#define TILE_NEIGHBOUR_NE       (1u << 1)
+#define TILE_NEIGHBOUR_E        (1u << 2)
+#define TILE_NEIGHBOUR_SE       (1u << 3)
+#define TILE_NEIGHBOUR_S        (1u << 4)
+#define TILE_NEIGHBOUR_SW       (1u << 5)
+#define TILE_NEIGHBOUR_W        (1u << 6)
+#define TILE_NEIGHBOUR_NW       (1u << 7)
+#define TILE_NEIGHBOUR_CARDINAL (TILE_NEIGHBOUR_N | TILE_NEIGHBOUR_E | TILE_NEIGHBOUR_S | TILE_NEIGHBOUR_W)
 
 typedef struct Tilemap Tilemap;
 
+typedef struct {
+    Texture2D       texture;
+    const char      *texturePath;       // interned, NULL until TM_InternTilesetPaths
+    const char      *name;              // view into the map source
+    u32             nameLength;
+    const TileProp  *properties;        // view into the map source when aligned
+    u32             *propIndex;         // local id -> property + 1, 0 when the tile has none
+    u32             firstGid;
+    u32             propertyCount;
+    u32             propIndexCount;
+    bool            propertiesOwned;
+} Tileset;
+
+// Half-open range of tiles
+typedef struct {
+    u32 x0, y0;
+    u32 x1, y1;
+} TileRect;
+
 typedef enum {
-    TILE_NONE = 0,
-    TILE_GROUND,
-    TILE_WALL,
-    TILE_BORDER,
-    TILE_COLLISION,
-    TILE_CARPET,
-    TILE_TABLE
-} TileType;
+    CHUNK_CANVAS_BELOW = 0,     // background under the animated layer, all of it when there is none
+    CHUNK_CANVAS_ABOVE,         // foreground
+    CHUNK_CANVAS_OVER,          // background from the animated layer up, drawn over the animated cells
+    CHUNK_CANVAS_COUNT
+} ChunkCanvas;
 
+// A cell left out of the bake because its tile animates, or one quad of a still cell stacked on it
 typedef struct {
-    u32         id;
-    TileType    type;
-} TileProp;
+    Rectangle       src;            // still quads only, animated cells take it from their frame
+    Vector2         pos;
+    u32             localId;        // first frame, 0 for a still quad
+    u32             tileset;
+    u32             layer;
+    bool            foreground;
+} TileAnimCell;
 
 typedef struct {
-    Texture2D   texture;
-    u8          *texturePath;
-    TileProp    *properties;
-    u32         firstGid;
-    u32         propertyCount;
-} Tileset;
+    const u32       *data;          // layerCount planes of TILEMAP_CHUNK_TILES^2 local ids, NULL until touched
+    RenderTexture2D canva;
+    RenderTexture2D canvaAbove;     // foreground tiles, only for chunks that have any
+    RenderTexture2D canvaOver;      // background from animLayer up, only for chunks that have any
+    RenderTexture2D mips[CHUNK_CANVAS_COUNT][TILEMAP_CANVAS_LEVELS - 1];  // each level half the one before
+    TileRect        dirty;          // canvas tiles to redraw, empty when x0 == x1
+    TileAnimCell    *anims;         // drawn every frame over the canvases, grouped by layer then tileset
+    u32             animCount;
+    u32             animLayer;      // lowest layer with an animated background cell, layerCount when none
+    u32             lastUsed;
+    u32             lastSeen;
+    bool            owned;          // false when data points into the map source
+    bool            modified;       // touched by SetTile: data is pinned and the cooked quads are stale
+} TileChunk;
 
 typedef struct {
-    u32 *data;
-    u32  width;
-    u32  height;
-} Layer;
+    TilemapQuad *quads;
+    u32         count;
+    u32         capacity;
+} TileQuadList;
+
+typedef enum {
+    AUTOTILE_WALL = 0,
+    AUTOTILE_TABLE,
+    AUTOTILE_BORDER,
+    AUTOTILE_CARPET,
+    AUTOTILE_KIND_COUNT
+} AutotileKind;
+
+// Sub-tile quads of every autotile kind for every neighbour mask, relative to the
+// tile's source and destination origin. Built once per map since it only depends on tile size.
+typedef struct {
+    TilemapQuadRange    ranges[AUTOTILE_KIND_COUNT][256];
+    TileQuadList        quads;
+} TileAutotileTable;
+
+// Per-layer planes over a rect plus a one tile ring, filled by one gather and one sweep
+typedef struct {
+    u32         *ids;           // layerCount planes of stride * (height + 2)
+    u16         *masks;         // layerCount planes of stride * (height + 2), ring left at 0
+    u8          *types;         // one plane, reused per layer by the sweep
+    u32         stride;         // width + 2
+    u32         capacity;       // cells per plane
+} TileNeighbourPlanes;
 
 typedef struct {
-    u32 width;
-    u32 height;
-    u32 tileWidth;
-    u32 tileHeight;
-    u32 tilesetCount;
-    u32 layerCount;
-    u32 mapId;
-    u32 spawnPointX;
-    u32 spawnPointY;
-
-    u32 eventGotoMapId;
-    u32 eventGotoTileX;
-    u32 eventGotoTileY;
-} TilemapHeader;
+    TileChunk   *chunks;
+    u32         *emptyChunk;    // shared by every v3 chunk stored with size 0
+    u32         chunksX;
+    u32         chunksY;
+    u32         chunkBytes;
+    u32         residentCount;
+    u32         bakedCount;
+    u64         residentBytes;
+    u64         bakedBytes;
+    u32         tick;
+    u32         dirtyCount;     // chunks with a pending redraw
+    u32         bakeQuads;      // totals over every bake and redraw since load
+    u32         bakeBatches;    // tileset runs drawn, one raylib batch each
+    u32         mapOrderBatches;    // runs the live draw lists had before grouping
+    TileQuadList scratch;       // draw list of live (uncooked) bakes
+    TileQuadList mapOrder;      // quads in traversal order, before grouping
+    u32         *quadKeys;      // sort key of every mapOrder quad
+    u32         *keyCounts;
+    TileNeighbourPlanes neighbours;
+    RenderTexture2D overview;   // chunks appear in it as they bake and stay after they are trimmed
+    u32         overviewShift;  // TILEMAP_OVERVIEW_SHIFT, or more for maps past the max size
+} TileStream;
 
 typedef struct {
     Rectangle       src;
     Vector2         pos;
     TileType        type;
     const Tileset  *tileset;
+    bool            foreground;
+    u8              frames;         // > 1 for animated tiles
+    u8              frameTime;      // 10 ms steps
 } TileDrawInfo;
 
 
-u32         TM_BuildTileTable(const Tilemap *tilemap);
-void        TM_FindMaxGid(Tilemap *tilemap);
-int         TM_FindTilesetIndexByGid(const Tilemap *tilemap, u32 gid);
+void        TM_BuildTileTables(Tilemap *tilemap);
+u32         TM_FindTileId(const Tilemap *tilemap, u32 gid);
+u32         TM_AddTile(Tilemap *tilemap, u32 gid);
+void        TM_BuildDrawInfo(Tilemap *tilemap);
+void        TM_BuildAutotileTable(Tilemap *tilemap);
+void        TM_BuildNeighbourPlanes(const Tilemap *tilemap, TileRect rect, TileNeighbourPlanes *planes);
+bool        TM_TilesetsReady(const Tilemap *tilemap);
+int         TM_FindTilesetIndexById(const Tilemap *tilemap, u32 id);
+u32         TM_GetTileId(const Tilemap *tilemap, u32 layerIndex, u32 x, u32 y);
 TileType    TM_GetTileType(const Tilemap *tilemap, u32 layerIndex, u32 x, u32 y);
 
-TileDrawInfo GetTileDrawInfo(const Tilemap *tilemap, const Layer *layer, u32 x, u32 y);
-
-void        TM_LoadHeader(FILE *file, Tilemap *tilemap);
-void        TM_LoadTilesets(FILE *file, Tilemap *tilemap);
-void        TM_LoadLayers(FILE *file, Tilemap *tilemap);
-
-void        DrawBorderTiles(const Tilemap *tilemap);
-void        DrawNonBorderTiles(const Tilemap *tilemap);
-void        DrawTileById(const Tilemap *tilemap, const TileDrawInfo *info, u32 x, u32 y);
-void        TM_ReloadCanva(Tilemap *tilemap);
-void        TM_DrawOnCanva(const Tilemap *tilemap);
-
-void        TM_DrawTileWall  (const Tilemap *tilemap, const Tileset *tileset, Rectangle src, Vector2 pos, u32 x, u32 y);
-void        TM_DrawTileTable (const Tilemap *tilemap, const Tileset *tileset, Rectangle src, Vector2 pos, u32 x, u32 y);
-void        TM_DrawTileBorder(const Tilemap *tilemap, const Tileset *tileset, Rectangle src, Vector2 pos, u32 x, u32 y);
-void        TM_DrawTileCarpet(const Tilemap *tilemap, const Tileset *tileset, Rectangle src, Vector2 pos, u32 x, u32 y);
-
+TileDrawInfo GetTileDrawInfo(const Tilemap *tilemap, u32 layerIndex, u32 x, u32 y);
+
+void        TM_LoadHeader(ByteReader *reader, Tilemap *tilemap);
+void        TM_LoadTilesets(ByteReader *reader, Tilemap *tilemap);
+void        TM_LoadLayers(ByteReader *reader, Tilemap *tilemap);
+void        TM_LoadSections(Tilemap *tilemap);
+// The path table is the texture registry's, so this stays on the main thread
+void        TM_InternTilesetPaths(Tilemap *tilemap);
+
+void        TM_LoadChunk(const Tilemap *tilemap, TileChunk *chunk);
+void        TM_TrimChunks(Tilemap *tilemap);
+u32        *TM_GetWritableChunk(const Tilemap *tilemap, TileChunk *chunk);
+void        TM_BakeChunk(const Tilemap *tilemap, TileChunk *chunk);
+void        TM_UnloadChunkCanvas(const Tilemap *tilemap, TileChunk *chunk);
+void        TM_CollectAnimatedCells(const Tilemap *tilemap, TileChunk *chunk);
+void        TM_DrawAnimatedCells(const Tilemap *tilemap, const TileChunk *chunk, bool foreground, bool overCanvas);
+void        TM_MarkDirty(const Tilemap *tilemap, TileRect cells);
+void        TM_RebakeDirty(const Tilemap *tilemap, TileChunk *chunk);
+TileRect    TM_GetChunkRect(const Tilemap *tilemap, const TileChunk *chunk);
+TileRect    TM_GetChunkApron(const Tilemap *tilemap, const TileChunk *chunk);
+
+void        TM_PushQuad(TileQuadList *list, u32 tileset, Rectangle src, Vector2 dst);
+void        EmitTileById(const Tilemap *tilemap, const TileDrawInfo *info, u32 neighbours, TileQuadList *out);
+u32         TM_CollectQuads(const Tilemap *tilemap, TileRect rect, u32 animLayer, TileQuadList *out, u32 *outOver);
+void        TM_DrawQuads(const Tilemap *tilemap, const TilemapQuad *quads, u32 count);
+u32         TM_CountBatches(const TilemapQuad *quads, u32 count);
+
+// Autotile rules: append the quads of one tile whose neighbours match mask, at origin
+void        TM_AutotileWall  (float tileSize, u32 mask, TileQuadList *out);
+void        TM_AutotileTable (float tileSize, u32 mask, TileQuadList *out);
+void        TM_AutotileBorder(float tileSize, u32 mask, TileQuadList *out);
+void        TM_AutotileCarpet(float tileSize, u32 mask, TileQuadList *out);
+
+static inline RenderTexture2D *TM_GetChunkCanvas(TileChunk *chunk, const ChunkCanvas which)
+{
+    return which == CHUNK_CANVAS_ABOVE ? &chunk->canvaAbove :
+           which == CHUNK_CANVAS_OVER  ? &chunk->canvaOver  : &chunk->canva;
+}
 
 #endif
\ No newline at end of file
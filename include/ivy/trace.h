@@ -0,0 +1,62 @@
+#ifndef IVY_TRACE_H
+#define IVY_TRACE_H
+
+#include "ivy/types.h"
+
+#include <stdbool.h>
+
+// Scoped trace zones recorded into per-thread ring buffers and dumped as Chrome
+// trace JSON (chrome://tracing, ui.perfetto.dev). Built only with IVY_ENABLE_TRACE;
+// otherwise every macro below expands to nothing.
+//
+//     void Foo(void)
+//     {
+//         TRACE_ZONE("Foo");      // ends when the enclosing scope exits
+//         ...
+//     }
+//
+// Zone names must be string literals, only the pointer is stored. A thread started with
+// StartThread hands its buffer back when it returns; the next new thread records into it
+// after the events already there, so short-lived threads share a few lanes of the dump.
+
+#define TRACE_DUMP_PATH         "trace.json"
+#define TRACE_MAX_THREADS       16
+#define TRACE_EVENTS_PER_THREAD 16384   // power of two, the oldest events are overwritten
+
+#if defined(IVY_ENABLE_TRACE)
+
+void    TraceBegin(const char *name);
+void    TraceEnd(void);
+void    TraceSetThreadName(const char *name);
+void    TraceThreadExit(void);
+bool    DumpTrace(const char *path);
+
+static inline void TraceZoneEnd(const char **zone)
+{
+    (void)zone;
+    TraceEnd();
+}
+
+#define TRACE_CONCAT_(a, b)     a##b
+#define TRACE_CONCAT(a, b)      TRACE_CONCAT_(a, b)
+
+#define TRACE_ZONE(name) \
+    const char *TRACE_CONCAT(traceZone_, __LINE__) __attribute__((cleanup(TraceZoneEnd))) = (TraceBegin(name), (name))
+#define TRACE_BEGIN(name)       TraceBegin(name)
+#define TRACE_END()             TraceEnd()
+#define TRACE_THREAD(name)      TraceSetThreadName(name)
+#define TRACE_THREAD_EXIT()     TraceThreadExit()
+#define TRACE_DUMP(path)        DumpTrace(path)
+
+#else
+
+#define TRACE_ZONE(name)        ((void)0)
+#define TRACE_BEGIN(name)       ((void)0)
+#define TRACE_END()             ((void)0)
+#define TRACE_THREAD(name)      ((void)0)
+#define TRACE_THREAD_EXIT()     ((void)0)
+#define TRACE_DUMP(path)        ((void)0)
+
+#endif
+
+#endif
\ No newline at end of file
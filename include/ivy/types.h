@@ -30,6 +30,7 @@ typedef enum {
     DIRECTION_BACK
 } Direction;
 
+typedef unsigned long long u64;
 typedef unsigned int    u32;
 typedef unsigned short  u16;
 typedef unsigned char   u8;
@@ -3,13 +3,34 @@
 
 #include "ivy/types.h"
 #include "ivy/virtual.h"
+#include "ivy/platform.h"
 #include "raylib/raylib.h"
 
 #include <stdio.h>
 
+typedef struct {
+    const u8   *data;
+    u32         size;
+    bool        owned;
+    MappedFile  mapping;    // set when a loose file was mapped instead of read
+} AssetData;
 
-void    ReadExact(FILE *file, void *dest, size_t n);
-u8     *ReadString(FILE *file);
+typedef struct {
+    const u8   *data;
+    u32         size;
+    u32         offset;
+} ByteReader;
+
+AssetData LoadAssetData(const char *path);
+AssetData MapAssetData(const char *path);
+void      UnloadAssetData(AssetData *asset);
+
+void        ReadExact(ByteReader *reader, void *dest, size_t n);
+const void *ReadView(ByteReader *reader, size_t n);
+u8         *ReadString(ByteReader *reader);
+
+Image   DecodeImageBin(const AssetData *asset, bool *outOwned);
+Image   DecodePngBin(const AssetData *asset);
 
 Texture2D LoadTextureFromBin(const char *path);
 Texture2D LoadTextureFromImageBin(const char *path);
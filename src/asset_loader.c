@@ -0,0 +1,307 @@
+#include "ivy/asset_loader.h"
+#include "ivy/platform.h"
+#include "ivy/utils.h"
+#include "ivy/trace.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define QUEUE_MASK (ASSET_LOADER_CAPACITY - 1)
+
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_QUEUED,
+    SLOT_DECODED,
+    SLOT_FAILED
+} LoadSlotState;
+
+typedef struct {
+    char            path[MAX_PATH_LEN];
+    TextureFileType type;
+    Texture2D      *target;
+    AssetData       asset;
+    Image           image;
+    bool            ownsImage;
+    u32             generation;
+    u32             state;
+} LoadSlot;
+
+// Bounded lock-free MPMC ring of slot indices (Vyukov).
+typedef struct {
+    u32 sequence;
+    u32 value;
+} QueueCell;
+
+typedef struct {
+    QueueCell   cells[ASSET_LOADER_CAPACITY];
+    u32         head;
+    u32         tail;
+} SlotQueue;
+
+typedef struct {
+    LoadSlot    slots[ASSET_LOADER_CAPACITY];
+    u32         freeList[ASSET_LOADER_CAPACITY];
+    u32         freeCount;
+
+    SlotQueue   jobs;
+    SlotQueue   ready;
+    Semaphore   jobSignal;
+
+    Thread      workers[ASSET_LOADER_WORKERS];
+    u32         workerCount;
+    u32         shutdown;
+    bool        running;
+} AssetLoader;
+
+static AssetLoader loader;
+
+static void InitQueue(SlotQueue *q)
+{
+    for (u32 i = 0; i < ASSET_LOADER_CAPACITY; i++)
+        q->cells[i].sequence = i;
+    q->head = 0;
+    q->tail = 0;
+}
+
+static bool PushQueue(SlotQueue *q, const u32 value)
+{
+    u32 pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+    QueueCell *cell;
+
+    for (;;)
+    {
+        cell = &q->cells[pos & QUEUE_MASK];
+        const u32 seq  = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        const int diff = (int)(seq - pos);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&q->tail, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (diff < 0) return false;
+        else pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+    }
+
+    cell->value = value;
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool PopQueue(SlotQueue *q, u32 *outValue)
+{
+    u32 pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    QueueCell *cell;
+
+    for (;;)
+    {
+        cell = &q->cells[pos & QUEUE_MASK];
+        const u32 seq  = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        const int diff = (int)(seq - (pos + 1));
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&q->head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (diff < 0) return false;
+        else pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    }
+
+    *outValue = cell->value;
+    __atomic_store_n(&cell->sequence, pos + QUEUE_MASK + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void DecodeSlot(LoadSlot *slot)
+{
+    TRACE_ZONE("DecodeTexture");
+
+    slot->asset = LoadAssetData(slot->path);
+    if (!slot->asset.data) {
+        __atomic_store_n(&slot->state, SLOT_FAILED, __ATOMIC_RELEASE);
+        return;
+    }
+
+    if (slot->type == TEXTURE_FILE_PNG_BIN) {
+        slot->image     = DecodePngBin(&slot->asset);
+        slot->ownsImage = true;
+        UnloadAssetData(&slot->asset);
+    } else {
+        slot->image = DecodeImageBin(&slot->asset, &slot->ownsImage);
+        if (slot->ownsImage) UnloadAssetData(&slot->asset);
+    }
+
+    __atomic_store_n(&slot->state, slot->image.data ? SLOT_DECODED : SLOT_FAILED, __ATOMIC_RELEASE);
+}
+
+static void WorkerMain(void *arg)
+{
+    (void)arg;
+    TRACE_THREAD("Asset worker");
+
+    for (;;)
+    {
+        WaitSemaphore(&loader.jobSignal);
+        if (__atomic_load_n(&loader.shutdown, __ATOMIC_ACQUIRE)) return;
+
+        u32 index;
+        if (!PopQueue(&loader.jobs, &index)) continue;
+
+        DecodeSlot(&loader.slots[index]);
+
+        const bool pushed = PushQueue(&loader.ready, index);
+        assert(pushed && "[ERROR] Asset ready queue overflow");
+        (void)pushed;
+    }
+}
+
+static void ReleaseSlot(const u32 index)
+{
+    LoadSlot *slot = &loader.slots[index];
+
+    if (slot->ownsImage) UnloadImage(slot->image);
+    UnloadAssetData(&slot->asset);
+
+    slot->image     = (Image){0};
+    slot->ownsImage = false;
+    slot->target    = NULL;
+    slot->generation++;
+    __atomic_store_n(&slot->state, SLOT_FREE, __ATOMIC_RELEASE);
+
+    loader.freeList[loader.freeCount++] = index;
+}
+
+void InitAssetLoader(u32 workerCount)
+{
+    if (loader.running) return;
+
+    memset(&loader, 0, sizeof(loader));
+    InitQueue(&loader.jobs);
+    InitQueue(&loader.ready);
+    InitSemaphore(&loader.jobSignal, 0);
+
+    for (u32 i = 0; i < ASSET_LOADER_CAPACITY; i++)
+        loader.freeList[i] = ASSET_LOADER_CAPACITY - 1 - i;
+    loader.freeCount = ASSET_LOADER_CAPACITY;
+
+    if (workerCount > ASSET_LOADER_WORKERS) workerCount = ASSET_LOADER_WORKERS;
+
+    for (u32 i = 0; i < workerCount; i++) {
+        if (!StartThread(&loader.workers[i], WorkerMain, NULL)) break;
+        loader.workerCount++;
+    }
+
+    loader.running = loader.workerCount > 0;
+    if (!loader.running) DestroySemaphore(&loader.jobSignal);
+}
+
+void ShutdownAssetLoader(void)
+{
+    if (!loader.running) return;
+
+    __atomic_store_n(&loader.shutdown, 1, __ATOMIC_RELEASE);
+    SignalSemaphore(&loader.jobSignal, loader.workerCount);
+
+    for (u32 i = 0; i < loader.workerCount; i++)
+        JoinThread(&loader.workers[i]);
+
+    for (u32 i = 0; i < ASSET_LOADER_CAPACITY; i++) {
+        if (loader.slots[i].state != SLOT_FREE) ReleaseSlot(i);
+    }
+
+    DestroySemaphore(&loader.jobSignal);
+    loader.running = false;
+}
+
+TextureHandle LoadTextureAsync(const char *path, const TextureFileType type, Texture2D *target)
+{
+    assert(path && target);
+
+    if (!loader.running || loader.freeCount == 0) {
+        *target = type == TEXTURE_FILE_PNG_BIN ? LoadTextureFromBin(path)
+                                               : LoadTextureFromImageBin(path);
+        return 0;
+    }
+
+    const u32 index = loader.freeList[--loader.freeCount];
+    LoadSlot *slot  = &loader.slots[index];
+
+    snprintf(slot->path, MAX_PATH_LEN, "%s", path);
+    slot->type   = type;
+    slot->target = target;
+    *target      = (Texture2D){0};
+    __atomic_store_n(&slot->state, SLOT_QUEUED, __ATOMIC_RELEASE);
+
+    const bool pushed = PushQueue(&loader.jobs, index);
+    assert(pushed && "[ERROR] Asset job queue overflow");
+    (void)pushed;
+
+    SignalSemaphore(&loader.jobSignal, 1);
+
+    return ((slot->generation & 0xFFFF) << 16) | (index + 1);
+}
+
+void CancelTextureLoads(const void *owner, const size_t ownerSize)
+{
+    const u8 *begin = owner;
+    const u8 *end   = begin + ownerSize;
+
+    for (u32 i = 0; i < ASSET_LOADER_CAPACITY; i++) {
+        const u8 *target = (const u8 *)loader.slots[i].target;
+        if (target && target >= begin && target < end)
+            loader.slots[i].target = NULL;
+    }
+}
+
+bool IsTextureLoaded(const TextureHandle handle)
+{
+    if (handle == 0) return true;
+
+    const u32 index = (handle & 0xFFFF) - 1;
+    if (index >= ASSET_LOADER_CAPACITY) return true;
+
+    return (loader.slots[index].generation & 0xFFFF) != (handle >> 16) ||
+           loader.slots[index].state == SLOT_FREE;
+}
+
+bool IsTextureLoadPending(const Texture2D *target)
+{
+    for (u32 i = 0; i < ASSET_LOADER_CAPACITY; i++) {
+        if (loader.slots[i].target == target && loader.slots[i].state != SLOT_FREE) return true;
+    }
+    return false;
+}
+
+bool IsAssetLoaderIdle(void)
+{
+    return !loader.running || loader.freeCount == ASSET_LOADER_CAPACITY;
+}
+
+u32 UploadLoadedTextures(const u32 maxUploads)
+{
+    if (!loader.running) return 0;
+
+    u32 uploaded = 0;
+    u32 index;
+
+    while (uploaded < maxUploads && PopQueue(&loader.ready, &index))
+    {
+        LoadSlot *slot = &loader.slots[index];
+        const u32 state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+
+        if (state == SLOT_FAILED) {
+            TraceLog(LOG_WARNING, "ASSETS: Failed to load '%s'", slot->path);
+        }
+        else if (slot->target) {
+            TRACE_ZONE("UploadTexture");
+            *slot->target = LoadTextureFromImage(slot->image);
+            uploaded++;
+        }
+
+        ReleaseSlot(index);
+    }
+
+    return uploaded;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "ivy/atlas.h"
+#include "ivy/pack.h"
+#include "ivy/utils.h"
+
+#include <string.h>
+
+static struct {
+    AssetData           asset;
+    const AtlasPage    *pages;
+    const AtlasRegion  *regions;
+    u32                 pageCount;
+    u32                 regionCount;
+} atlas;
+
+bool LoadAtlasIndex(const char *path)
+{
+    UnloadAtlasIndex();
+
+    // Atlases are generated at build time and only ship inside the pack
+    if (!PackFind(path, NULL)) return false;
+
+    AssetData asset = LoadAssetData(path);
+    if (!asset.data) return false;
+
+    AtlasHeader header;
+    if (asset.size < sizeof(header)) {
+        UnloadAssetData(&asset);
+        return false;
+    }
+    memcpy(&header, asset.data, sizeof(header));
+
+    const u64 expected = sizeof(AtlasHeader) + (u64)header.pageCount * sizeof(AtlasPage)
+                                             + (u64)header.regionCount * sizeof(AtlasRegion);
+
+    if (header.magic != ATLAS_MAGIC || header.version != ATLAS_VERSION || expected != asset.size) {
+        TraceLog(LOG_WARNING, "ATLAS: Invalid index '%s'", path);
+        UnloadAssetData(&asset);
+        return false;
+    }
+
+    atlas.asset       = asset;
+    atlas.pages       = (const AtlasPage *)(asset.data + sizeof(AtlasHeader));
+    atlas.regions     = (const AtlasRegion *)(atlas.pages + header.pageCount);
+    atlas.pageCount   = header.pageCount;
+    atlas.regionCount = header.regionCount;
+
+    for (u32 i = 0; i < atlas.regionCount; i++) {
+        if (atlas.regions[i].page >= atlas.pageCount) {
+            TraceLog(LOG_WARNING, "ATLAS: Region '%.*s' points at a missing page",
+                     ATLAS_PATH_LEN, atlas.regions[i].path);
+            UnloadAtlasIndex();
+            return false;
+        }
+    }
+
+    TraceLog(LOG_INFO, "ATLAS: %u regions on %u pages", atlas.regionCount, atlas.pageCount);
+    return true;
+}
+
+void UnloadAtlasIndex(void)
+{
+    UnloadAssetData(&atlas.asset);
+    memset(&atlas, 0, sizeof(atlas));
+}
+
+const AtlasRegion *FindAtlasRegion(const char *path)
+{
+    const u32 hash = PackHashPath(path);
+    u32 lo = 0;
+    u32 hi = atlas.regionCount;
+
+    while (lo < hi)
+    {
+        const u32 mid = lo + (hi - lo) / 2;
+        const AtlasRegion *r = &atlas.regions[mid];
+
+        int cmp = (r->hash > hash) - (r->hash < hash);
+        if (cmp == 0) cmp = strncmp(r->path, path, ATLAS_PATH_LEN);
+
+        if (cmp == 0) return r;
+        if (cmp < 0) lo = mid + 1;
+        else         hi = mid;
+    }
+
+    return NULL;
+}
+
+const AtlasPage *GetAtlasPage(const u32 page)
+{
+    return page < atlas.pageCount ? &atlas.pages[page] : NULL;
+}
\ No newline at end of file
@@ -68,4 +68,16 @@ void UpdateGameCamera(GameCamera *camera, const Player *player,
         camera->camera2D.target.y = mapH * 0.5f;
     else
         camera->camera2D.target.y = Clamp(camera->camera2D.target.y, halfViewH, mapH - halfViewH);
+}
+
+Rectangle GetGameCameraView(const GameCamera *camera)
+{
+    const Camera2D *c = &camera->camera2D;
+
+    return (Rectangle){
+        .x      = c->target.x - c->offset.x / c->zoom,
+        .y      = c->target.y - c->offset.y / c->zoom,
+        .width  = 2.0f * c->offset.x / c->zoom,
+        .height = 2.0f * c->offset.y / c->zoom
+    };
 }
\ No newline at end of file
@@ -1,153 +1,536 @@
 #include "ivy/collision.h"
 #include "ivy/tilemap/tilemap_internal.h"
+#include "ivy/trace.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
-static bool
-IsSolidTile(const Tilemap *tilemap, const int layerIndex, const int x, const int y)
+
+typedef struct {
+    RectInfo   *rects;
+    u32         count;
+    u32         capacity;
+} RectList;
+
+typedef struct {
+    u64        *solid;          // layer planes of free solid tiles, cleared as rects claim them
+    RectList   *lists;          // one per layer
+    size_t      planeWords;
+    u32         height;
+    u32         wordsPerRow;
+    u32         firstLayer;
+    u32         layerStep;
+    u32         layerCount;
+} MergeJob;
+
+static inline u32 CountTrailingZeros(const u64 bits)
 {
-    const Layer *layer = &tilemap->layers[layerIndex];
-    if (x < 0 || x >= (int)layer->width || y < 0 || y >= (int)layer->height) return false;
-    if (layer->data[y * layer->width + x] == 0) return false;
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (u32)index;
+#else
+    return (u32)__builtin_ctzll(bits);
+#endif
+}
 
-    const TileType type = TM_GetTileType(tilemap, (u32)layerIndex, (u32)x, (u32)y);
+// Bits of word k that fall in [x, x + w)
+static inline u64 SpanMask(const u32 k, const u32 x, const u32 w)
+{
+    const u32 base = k << 6;
+    const u32 lo   = x > base ? x - base : 0;
+    const u32 hi   = x + w < base + 64 ? x + w - base : 64;
 
+    const u64 below = hi == 64 ? ~0ull : (1ull << hi) - 1;
+    return below & ~((1ull << lo) - 1);
+}
+
+static inline bool
+IsSolidType(const TileType type)
+{
     return type == TILE_BORDER    ||
            type == TILE_WALL      ||
            type == TILE_COLLISION ||
            type == TILE_TABLE;
 }
 
-static void
-ComputeCollisionRects(const Tilemap *tilemap, const int layerIndex,
-                      RectInfo **outRects, int *outCount, int *outCapacity)
+// Set bits from x on, stopping at the first clear one
+static u32 RunLength(const u64 *row, const u32 x, const u32 wordsPerRow)
+{
+    u32 k     = x >> 6;
+    u32 shift = x & 63;
+    u32 run   = 0;
+
+    for (;;) {
+        const u64 clear = ~(row[k] >> shift);   // the bits shifted in count as clear
+        const u32 n     = clear == 0 ? 64 : CountTrailingZeros(clear);
+        run += n;
+        if (n < 64 - shift || ++k == wordsPerRow) return run;
+        shift = 0;
+    }
+}
+
+static bool CoversSpan(const u64 *row, const u32 x, const u32 w)
 {
-    const Layer *layer  = &tilemap->layers[layerIndex];
-    bool *visited       = calloc(layer->width * layer->height, sizeof(bool));
-    assert(visited);
+    for (u32 k = x >> 6; k <= (x + w - 1) >> 6; k++) {
+        const u64 mask = SpanMask(k, x, w);
+        if ((row[k] & mask) != mask) return false;
+    }
+    return true;
+}
 
-    int rectCount    = 0;
-    int rectCapacity = 0;
-    RectInfo *rects  = NULL;
+static void ClearSpan(u64 *row, const u32 x, const u32 w)
+{
+    for (u32 k = x >> 6; k <= (x + w - 1) >> 6; k++) row[k] &= ~SpanMask(k, x, w);
+}
 
-    for (int y = 0; y < (int)layer->height; y++)
-    {
-        for (int x = 0; x < (int)layer->width; x++)
+static void PushRect(RectList *list, const RectInfo rect)
+{
+    if (list->count >= list->capacity) {
+        list->capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+        RectInfo *tmp  = realloc(list->rects, list->capacity * sizeof(RectInfo));
+        assert(tmp && "[ERROR] Failed to realloc collision rects");
+        list->rects = tmp;
+    }
+    list->rects[list->count++] = rect;
+}
+
+// One read of every cell, straight from the chunk planes
+static u64 *GatherSolidRows(const Tilemap *tilemap, const u32 wordsPerRow)
+{
+    const TilemapHeader *h  = &tilemap->header;
+    const size_t planeWords = (size_t)wordsPerRow * h->height;
+
+    u64 *solid = calloc(planeWords * h->layerCount + 1, sizeof(u64));
+    assert(solid && "[ERROR] Failed to alloc collision rows");
+
+    TileStream *s = tilemap->stream;
+    for (u32 cy = 0; cy < s->chunksY; cy++) {
+        for (u32 cx = 0; cx < s->chunksX; cx++)
         {
-            if (!IsSolidTile(tilemap, layerIndex, x, y) || visited[y * layer->width + x])
-                continue;
+            TileChunk *chunk = &s->chunks[cy * s->chunksX + cx];
+            if (!chunk->data) TM_LoadChunk(tilemap, chunk);
+            chunk->lastUsed = s->tick;
 
-            // Expand horizontal
-            int w = 1;
-            while (x + w < (int)layer->width &&
-                   IsSolidTile(tilemap, layerIndex, x + w, y) &&
-                   !visited[y * layer->width + (x + w)])
-                w++;
+            const u32 x0 = cx << TILEMAP_CHUNK_SHIFT;
+            const u32 y0 = cy << TILEMAP_CHUNK_SHIFT;
+            const u32 x1 = x0 + TILEMAP_CHUNK_TILES < h->width  ? x0 + TILEMAP_CHUNK_TILES : h->width;
+            const u32 y1 = y0 + TILEMAP_CHUNK_TILES < h->height ? y0 + TILEMAP_CHUNK_TILES : h->height;
 
-            // Expand vertical
-            int h = 1;
-            while (y + h < (int)layer->height)
-            {
-                bool canExpand = true;
-                for (int i = 0; i < w; i++) {
-                    if (!IsSolidTile(tilemap, layerIndex, x + i, y + h) ||
-                        visited[(y + h) * layer->width + (x + i)]) {
-                        canExpand = false;
-                        break;
+            for (u32 l = 0; l < h->layerCount; l++) {
+                const u32 *plane = chunk->data + (l << (2 * TILEMAP_CHUNK_SHIFT));
+                u64 *rows        = solid + l * planeWords;
+
+                for (u32 y = y0; y < y1; y++) {
+                    for (u32 x = x0; x < x1; x++) {
+                        const u32 id = plane[((y & TILEMAP_CHUNK_MASK) << TILEMAP_CHUNK_SHIFT) + (x & TILEMAP_CHUNK_MASK)];
+                        if (id == 0 || id > tilemap->tileCount) continue;
+                        if (IsSolidType((TileType)tilemap->tileTypeTable[id]))
+                            rows[y * wordsPerRow + (x >> 6)] |= 1ull << (x & 63);
                     }
                 }
-                if (!canExpand) break;
-                h++;
             }
+        }
+    }
+
+    return solid;
+}
 
-            // Mark visited
-            for (int row = 0; row < h; row++)
-                for (int col = 0; col < w; col++)
-                    visited[(y + row) * layer->width + (x + col)] = true;
+// Greedy merge in scan order: the first free solid tile starts a rect, which takes the
+// whole run to its right and then every row below that is free under the run
+static void MergeLayer(u64 *rows, const u32 height, const u32 wordsPerRow, RectList *out)
+{
+    for (u32 y = 0; y < height; y++)
+    {
+        u64 *row = rows + (size_t)y * wordsPerRow;
 
-            if (rectCount >= rectCapacity) {
-                rectCapacity = rectCapacity == 0 ? 16 : rectCapacity * 2;
-                RectInfo *tmp = realloc(rects, rectCapacity * sizeof(RectInfo));
-                assert(tmp && "[ERROR] Failed to realloc collision rects");
-                rects = tmp;
+        for (u32 k = 0; k < wordsPerRow; )
+        {
+            if (row[k] == 0) {
+                k++;
+                continue;
             }
 
-            rects[rectCount++] = (RectInfo){ x, y, w, h };
+            const u32 x = (k << 6) + CountTrailingZeros(row[k]);
+            const u32 w = RunLength(row, x, wordsPerRow);
+
+            u32 h = 1;
+            while (y + h < height && CoversSpan(row + (size_t)h * wordsPerRow, x, w)) h++;
+
+            for (u32 r = 0; r < h; r++) ClearSpan(row + (size_t)r * wordsPerRow, x, w);
+
+            PushRect(out, (RectInfo){ (int)x, (int)y, (int)w, (int)h });
         }
     }
+}
 
-    free(visited);
-    *outRects    = rects;
-    *outCount    = rectCount;
-    *outCapacity = rectCapacity;
+static void MergeJobMain(void *arg)
+{
+    TRACE_ZONE("MergeCollisionLayers");
+    const MergeJob *job = arg;
+
+    for (u32 l = job->firstLayer; l < job->layerCount; l += job->layerStep)
+        MergeLayer(job->solid + l * job->planeWords, job->height, job->wordsPerRow, &job->lists[l]);
 }
 
-Collision *InitCollisionAllLayers(const Tilemap *tilemap)
+u32 CollectCollisionRects(const Tilemap *tilemap, RectInfo **outRects)
 {
-    assert(tilemap && "[ERROR] Tilemap is NULL");
+    TRACE_ZONE("CollectCollisionRects");
 
-    Collision *collision  = malloc(sizeof(Collision));
-    assert(collision);
-    collision->rect      = NULL;
-    collision->rectCount = 0;
+    const TilemapHeader *h = &tilemap->header;
+    const u32 wordsPerRow  = (h->width + 63) >> 6;
+    const u32 layerCount   = h->layerCount;
 
-    RectInfo *allRects  = NULL;
-    int allCount        = 0;
-    int allCapacity     = 0;
+    u64 *solid      = GatherSolidRows(tilemap, wordsPerRow);
+    RectList *lists = calloc(layerCount ? layerCount : 1, sizeof(RectList));
+    assert(lists && "[ERROR] Failed to alloc collision rect lists");
 
-    for (int l = 0; l < (int)tilemap->header.layerCount; l++)
-    {
-        RectInfo *layerRects = NULL;
-        int layerCount       = 0;
-        int layerCapacity    = 0;
+    // Layers merge independently; small maps are not worth a thread
+    u32 jobCount = (u64)h->width * h->height < COLLISION_PARALLEL_TILES ? 1 : GetCpuCount();
+    if (jobCount > layerCount)              jobCount = layerCount;
+    if (jobCount > COLLISION_MERGE_THREADS) jobCount = COLLISION_MERGE_THREADS;
+    if (jobCount == 0)                      jobCount = 1;
+
+    MergeJob jobs[COLLISION_MERGE_THREADS];
+    Thread threads[COLLISION_MERGE_THREADS] = {0};
+
+    for (u32 i = 0; i < jobCount; i++) {
+        jobs[i] = (MergeJob){
+            .solid       = solid,
+            .lists       = lists,
+            .planeWords  = (size_t)wordsPerRow * h->height,
+            .height      = h->height,
+            .wordsPerRow = wordsPerRow,
+            .firstLayer  = i,
+            .layerStep   = jobCount,
+            .layerCount  = layerCount
+        };
+    }
+
+    for (u32 i = 1; i < jobCount; i++) {
+        if (!StartThread(&threads[i], MergeJobMain, &jobs[i])) MergeJobMain(&jobs[i]);
+    }
+    MergeJobMain(&jobs[0]);
+    for (u32 i = 1; i < jobCount; i++) JoinThread(&threads[i]);
+
+    // Layer order, as a single-threaded pass would emit them
+    u32 total = 0;
+    for (u32 l = 0; l < layerCount; l++) total += lists[l].count;
 
-        ComputeCollisionRects(tilemap, l, &layerRects, &layerCount, &layerCapacity);
+    RectInfo *allRects = total > 0 ? malloc(total * sizeof(RectInfo)) : NULL;
+    assert((total == 0 || allRects) && "[ERROR] Failed to alloc allRects");
 
-        for (int i = 0; i < layerCount; i++)
+    u32 offset = 0;
+    for (u32 l = 0; l < layerCount; l++) {
+        if (lists[l].count > 0) memcpy(allRects + offset, lists[l].rects, lists[l].count * sizeof(RectInfo));
+        offset += lists[l].count;
+        free(lists[l].rects);
+    }
+
+    free(lists);
+    free(solid);
+
+    *outRects = allRects;
+    return total;
+}
+
+// Blocks touched by a tile range, clamped to the map
+static TileRect GetBucketRange(const Collision *collision, const TileRect tiles)
+{
+    TileRect r = {
+        .x0 = tiles.x0 >> COLLISION_BUCKET_SHIFT,
+        .y0 = tiles.y0 >> COLLISION_BUCKET_SHIFT,
+        .x1 = ((tiles.x1 - 1) >> COLLISION_BUCKET_SHIFT) + 1,
+        .y1 = ((tiles.y1 - 1) >> COLLISION_BUCKET_SHIFT) + 1
+    };
+    if (r.x1 > collision->bucketsX) r.x1 = collision->bucketsX;
+    if (r.y1 > collision->bucketsY) r.y1 = collision->bucketsY;
+    return r;
+}
+
+static void AddToBuckets(Collision *collision, const u32 index, const TileRect tiles)
+{
+    const TileRect r = GetBucketRange(collision, tiles);
+    for (u32 by = r.y0; by < r.y1; by++) {
+        for (u32 bx = r.x0; bx < r.x1; bx++)
         {
-            if (allCount >= allCapacity) {
-                allCapacity = allCapacity == 0 ? 16 : allCapacity * 2;
-                RectInfo *tmp = realloc(allRects, allCapacity * sizeof(RectInfo));
-                assert(tmp && "[ERROR] Failed to realloc allRects");
-                allRects = tmp;
+            CollisionBucket *b = &collision->buckets[by * collision->bucketsX + bx];
+            if (b->count >= b->capacity) {
+                b->capacity = b->capacity == 0 ? 4 : b->capacity * 2;
+                u32 *tmp    = realloc(b->rects, b->capacity * sizeof(u32));
+                assert(tmp && "[ERROR] Failed to realloc collision bucket");
+                b->rects = tmp;
             }
-            allRects[allCount++] = layerRects[i];
+            b->rects[b->count++] = index;
         }
+    }
+}
 
-        free(layerRects);
+// Replaces index with newIndex in every block of tiles, or drops it when newIndex is UINT32_MAX
+static void RenameInBuckets(Collision *collision, const u32 index, const u32 newIndex, const TileRect tiles)
+{
+    const TileRect r = GetBucketRange(collision, tiles);
+    for (u32 by = r.y0; by < r.y1; by++) {
+        for (u32 bx = r.x0; bx < r.x1; bx++)
+        {
+            CollisionBucket *b = &collision->buckets[by * collision->bucketsX + bx];
+            for (u32 i = 0; i < b->count; i++) {
+                if (b->rects[i] != index) continue;
+                if (newIndex == UINT32_MAX) b->rects[i] = b->rects[--b->count];
+                else                     b->rects[i] = newIndex;
+                break;
+            }
+        }
     }
+}
+
+// The rects and the bitmap describe the same tiles; rects serve drawing and overlap
+// tests, the bitmap answers per-tile queries
+Collision *CreateCollision(const RectInfo *rects, const u32 rectCount, const u32 width, const u32 height,
+                           const float tileWidth, const float tileHeight)
+{
+    Collision *collision = calloc(1, sizeof(Collision));
+    assert(collision && "[ERROR] Failed to alloc collision");
+
+    collision->width       = width;
+    collision->height      = height;
+    collision->wordsPerRow = (width + 63) >> 6;
+    collision->tileWidth   = tileWidth;
+    collision->tileHeight  = tileHeight;
+    collision->solid       = calloc((size_t)collision->wordsPerRow * height + 1, sizeof(u64));
+    assert(collision->solid && "[ERROR] Failed to alloc collision bitmap");
+
+    collision->bucketsX = (width  + (1u << COLLISION_BUCKET_SHIFT) - 1) >> COLLISION_BUCKET_SHIFT;
+    collision->bucketsY = (height + (1u << COLLISION_BUCKET_SHIFT) - 1) >> COLLISION_BUCKET_SHIFT;
+    collision->buckets  = calloc((size_t)collision->bucketsX * collision->bucketsY + 1, sizeof(CollisionBucket));
+    assert(collision->buckets && "[ERROR] Failed to alloc collision buckets");
 
-    if (allCount == 0) {
-        free(allRects);
-        return collision;
+    for (u32 i = 0; i < rectCount; i++) {
+        const RectInfo *r = &rects[i];
+        for (int y = r->y; y < r->y + r->h; y++) {
+            for (int x = r->x; x < r->x + r->w; x++) {
+                if ((u32)x >= width || (u32)y >= height) continue;
+                collision->solid[(u32)y * collision->wordsPerRow + ((u32)x >> 6)] |= 1ull << ((u32)x & 63);
+            }
+        }
     }
 
-    const float tw = (float)tilemap->header.tileWidth;
-    const float th = (float)tilemap->header.tileHeight;
+    if (rectCount == 0) return collision;
 
-    collision->rect = malloc(allCount * sizeof(Rectangle));
+    collision->rect = malloc(rectCount * sizeof(Rectangle));
     assert(collision->rect && "[ERROR] Failed to alloc collision rects");
 
-    for (int i = 0; i < allCount; i++) {
+    for (u32 i = 0; i < rectCount; i++) {
         collision->rect[i] = (Rectangle){
-            .x      = (float)allRects[i].x * tw,
-            .y      = (float)allRects[i].y * th,
-            .width  = (float)allRects[i].w * tw,
-            .height = (float)allRects[i].h * th
+            .x      = (float)rects[i].x * tileWidth,
+            .y      = (float)rects[i].y * tileHeight,
+            .width  = (float)rects[i].w * tileWidth,
+            .height = (float)rects[i].h * tileHeight
         };
+        AddToBuckets(collision, i, (TileRect){ (u32)rects[i].x, (u32)rects[i].y,
+                                               (u32)(rects[i].x + rects[i].w), (u32)(rects[i].y + rects[i].h) });
     }
 
-    collision->rectCount = (u32)allCount;
+    collision->rectCount    = rectCount;
+    collision->rectCapacity = rectCount;
+    return collision;
+}
+
+Collision *InitCollisionAllLayers(const Tilemap *tilemap)
+{
+    TRACE_ZONE("InitCollisionAllLayers");
+    assert(tilemap && "[ERROR] Tilemap is NULL");
+
+    RectInfo *allRects = NULL;
+    u32 allCount       = 0;
 
+    // Cooked maps carry the merged rects; only uncooked ones pay for the merge here
+    if (tilemap->cookedRects) {
+        allCount = tilemap->cookedRectCount;
+        allRects = malloc((allCount > 0 ? allCount : 1) * sizeof(RectInfo));
+        assert(allRects && "[ERROR] Failed to alloc collision rects");
+
+        for (u32 i = 0; i < allCount; i++) {
+            const TilemapRect *r = &tilemap->cookedRects[i];
+            allRects[i] = (RectInfo){ (int)r->x, (int)r->y, (int)r->w, (int)r->h };
+        }
+    }
+    else allCount = CollectCollisionRects(tilemap, &allRects);
+
+    Collision *collision = CreateCollision(allRects, allCount, tilemap->header.width, tilemap->header.height,
+                                           (float)tilemap->header.tileWidth, (float)tilemap->header.tileHeight);
     free(allRects);
     return collision;
 }
 
+static int CompareIndices(const void *a, const void *b)
+{
+    const u32 x = *(const u32 *)a;
+    const u32 y = *(const u32 *)b;
+    return (x > y) - (x < y);
+}
+
+// Tiles solid on any layer
+static bool IsCellSolid(const Tilemap *tilemap, const u32 x, const u32 y)
+{
+    for (u32 l = 0; l < tilemap->header.layerCount; l++) {
+        if (IsSolidType(TM_GetTileType(tilemap, l, x, y))) return true;
+    }
+    return false;
+}
+
+static TileRect GetRectTiles(const Rectangle *rect, const float tileWidth, const float tileHeight)
+{
+    return (TileRect){
+        .x0 = (u32)(rect->x / tileWidth  + 0.5f),
+        .y0 = (u32)(rect->y / tileHeight + 0.5f),
+        .x1 = (u32)((rect->x + rect->width)  / tileWidth  + 0.5f),
+        .y1 = (u32)((rect->y + rect->height) / tileHeight + 0.5f)
+    };
+}
+
+// Solid tiles of cells, in a plane whose origin is the box corner
+static void MarkSolidTiles(const Collision *collision, const TileRect cells, const TileRect box, u64 *rows, const u32 wordsPerRow)
+{
+    for (u32 y = cells.y0; y < cells.y1; y++) {
+        for (u32 x = cells.x0; x < cells.x1; x++) {
+            if (!IsCollisionTileSolid(collision, (int)x, (int)y)) continue;
+            const u32 lx = x - box.x0;
+            rows[(y - box.y0) * wordsPerRow + (lx >> 6)] |= 1ull << (lx & 63);
+        }
+    }
+}
+
+void UpdateCollisionRegion(Collision *collision, const Tilemap *tilemap, TileRect region)
+{
+    TRACE_ZONE("UpdateCollisionRegion");
+    assert(collision && tilemap && "[ERROR] Collision or tilemap is NULL");
+
+    if (region.x1 > collision->width)  region.x1 = collision->width;
+    if (region.y1 > collision->height) region.y1 = collision->height;
+    if (region.x0 >= region.x1 || region.y0 >= region.y1) return;
+
+    for (u32 y = region.y0; y < region.y1; y++) {
+        for (u32 x = region.x0; x < region.x1; x++) {
+            u64 *word      = &collision->solid[y * collision->wordsPerRow + (x >> 6)];
+            const u64 bit  = 1ull << (x & 63);
+            *word          = IsCellSolid(tilemap, x, y) ? (*word | bit) : (*word & ~bit);
+        }
+    }
+
+    const float tw = collision->tileWidth;
+    const float th = collision->tileHeight;
+
+    // Rects touching the region give their tiles back; together with the region they are
+    // merged again, which leaves every other rect as it was
+    u32 *freed     = NULL;
+    u32 freedCount = 0;
+    TileRect box   = region;
+
+    const TileRect blocks = GetBucketRange(collision, region);
+    for (u32 by = blocks.y0; by < blocks.y1; by++) {
+        for (u32 bx = blocks.x0; bx < blocks.x1; bx++)
+        {
+            const CollisionBucket *b = &collision->buckets[by * collision->bucketsX + bx];
+            for (u32 j = 0; j < b->count; j++)
+            {
+                const TileRect r = GetRectTiles(&collision->rect[b->rects[j]], tw, th);
+                if (r.x1 <= region.x0 || r.x0 >= region.x1 || r.y1 <= region.y0 || r.y0 >= region.y1) continue;
+
+                // A rect spanning several blocks is taken from the first one the region shares with it
+                const u32 firstX = r.x0 >> COLLISION_BUCKET_SHIFT;
+                const u32 firstY = r.y0 >> COLLISION_BUCKET_SHIFT;
+                if (bx != (firstX > blocks.x0 ? firstX : blocks.x0) || by != (firstY > blocks.y0 ? firstY : blocks.y0)) continue;
+
+                if ((freedCount & (freedCount - 1)) == 0) {
+                    u32 *tmp = realloc(freed, (freedCount ? freedCount * 2 : 1) * sizeof(u32));
+                    assert(tmp && "[ERROR] Failed to realloc freed collision rects");
+                    freed = tmp;
+                }
+                freed[freedCount++] = b->rects[j];
+
+                if (r.x0 < box.x0) box.x0 = r.x0;
+                if (r.y0 < box.y0) box.y0 = r.y0;
+                if (r.x1 > box.x1) box.x1 = r.x1;
+                if (r.y1 > box.y1) box.y1 = r.y1;
+            }
+        }
+    }
+
+    // Slots are handed out in index order, as a scan of every rect would find them
+    if (freedCount > 1) qsort(freed, freedCount, sizeof(u32), CompareIndices);
+
+    const u32 wordsPerRow = (box.x1 - box.x0 + 63) >> 6;
+    u64 *rows = calloc((size_t)wordsPerRow * (box.y1 - box.y0) + 1, sizeof(u64));
+    assert(rows && "[ERROR] Failed to alloc collision update rows");
+
+    MarkSolidTiles(collision, region, box, rows, wordsPerRow);
+    for (u32 i = 0; i < freedCount; i++) {
+        const TileRect r = GetRectTiles(&collision->rect[freed[i]], tw, th);
+        MarkSolidTiles(collision, r, box, rows, wordsPerRow);
+        RenameInBuckets(collision, freed[i], UINT32_MAX, r);
+    }
+
+    RectList merged = {0};
+    MergeLayer(rows, box.y1 - box.y0, wordsPerRow, &merged);
+    free(rows);
+
+    const u32 needed = collision->rectCount - freedCount + merged.count;
+    if (needed > collision->rectCapacity) {
+        u32 capacity = collision->rectCapacity ? collision->rectCapacity : 16;
+        while (capacity < needed) capacity *= 2;
+
+        Rectangle *tmp = realloc(collision->rect, capacity * sizeof(Rectangle));
+        assert(tmp && "[ERROR] Failed to realloc collision rects");
+        collision->rect         = tmp;
+        collision->rectCapacity = capacity;
+    }
+
+    // New rects take the freed slots first, then go at the end; slots left over are
+    // filled from the end, highest first, so only those tail rects change index
+    for (u32 i = 0; i < merged.count; i++)
+    {
+        const RectInfo *r    = &merged.rects[i];
+        const TileRect tiles = { r->x + box.x0, r->y + box.y0, r->x + box.x0 + r->w, r->y + box.y0 + r->h };
+        const u32 slot       = i < freedCount ? freed[i] : collision->rectCount++;
+
+        collision->rect[slot] = (Rectangle){
+            .x      = (float)tiles.x0 * tw,
+            .y      = (float)tiles.y0 * th,
+            .width  = (float)r->w * tw,
+            .height = (float)r->h * th
+        };
+        AddToBuckets(collision, slot, tiles);
+    }
+
+    for (u32 i = freedCount; i > merged.count; i--)
+    {
+        const u32 slot = freed[i - 1];
+        const u32 last = --collision->rectCount;
+        if (slot == last) continue;
+
+        collision->rect[slot] = collision->rect[last];
+        RenameInBuckets(collision, last, slot, GetRectTiles(&collision->rect[slot], tw, th));
+    }
+
+    free(merged.rects);
+    free(freed);
+}
+
 void DestroyCollision(Collision *collision)
 {
     if (!collision) return;
     free(collision->rect);
+    free(collision->solid);
+    if (collision->buckets) {
+        for (u32 i = 0; i < collision->bucketsX * collision->bucketsY; i++) free(collision->buckets[i].rects);
+        free(collision->buckets);
+    }
     free(collision);
 }
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "ivy/entity.h"
+#include "ivy/trace.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static const int stepX[8] = { 0, 0, 1, -1,  0, 0, 0, 0 };     // by intent & ENTITY_INTENT_DIR_MASK
+static const int stepY[8] = { 0, 1, 0,  0, -1, 0, 0, 0 };
+
+static void *GrowArray(void *array, const u32 capacity, const size_t size)
+{
+    void *tmp = realloc(array, capacity * size);
+    assert(tmp && "[ERROR] Failed to realloc entity components");
+    return tmp;
+}
+
+static void GrowComponents(EntityStore *store, const u32 capacity)
+{
+    store->tileX          = GrowArray(store->tileX,          capacity, sizeof(int));
+    store->tileY          = GrowArray(store->tileY,          capacity, sizeof(int));
+    store->targetX        = GrowArray(store->targetX,        capacity, sizeof(int));
+    store->targetY        = GrowArray(store->targetY,        capacity, sizeof(int));
+    store->moveTimer      = GrowArray(store->moveTimer,      capacity, sizeof(float));
+    store->moveDuration   = GrowArray(store->moveDuration,   capacity, sizeof(float));
+    store->position       = GrowArray(store->position,       capacity, sizeof(Vector2));
+    store->direction      = GrowArray(store->direction,      capacity, sizeof(u8));
+    store->action         = GrowArray(store->action,         capacity, sizeof(u8));
+    store->moving         = GrowArray(store->moving,         capacity, sizeof(u8));
+    store->intent         = GrowArray(store->intent,         capacity, sizeof(u8));
+    store->frame          = GrowArray(store->frame,          capacity, sizeof(u8));
+    store->frameDirection = GrowArray(store->frameDirection, capacity, sizeof(u8));
+    store->frameTimer     = GrowArray(store->frameTimer,     capacity, sizeof(float));
+    store->appearance     = GrowArray(store->appearance,     capacity, sizeof(u16));
+    store->id             = GrowArray(store->id,             capacity, sizeof(EntityId));
+    store->stepping       = GrowArray(store->stepping,       capacity, sizeof(u32));
+    store->capacity       = capacity;
+}
+
+EntityStore *CreateEntityStore(const u32 capacity)
+{
+    EntityStore *store = calloc(1, sizeof(EntityStore));
+    assert(store && "[ERROR] Failed to allocate memory for EntityStore!");
+
+    GrowComponents(store, capacity ? capacity : ENTITY_DEFAULT_CAPACITY);
+    return store;
+}
+
+void DestroyEntityStore(EntityStore *store)
+{
+    if (!store) return;
+
+    for (u32 a = 0; a < store->appearanceCount; a++) {
+        EntityAppearance *ap = &store->appearances[a];
+        for (u32 l = 0; l < ap->layerCount; l++) ReleaseTextureRegion(&ap->layers[l]);
+    }
+
+    free(store->tileX);
+    free(store->tileY);
+    free(store->targetX);
+    free(store->targetY);
+    free(store->moveTimer);
+    free(store->moveDuration);
+    free(store->position);
+    free(store->direction);
+    free(store->action);
+    free(store->moving);
+    free(store->intent);
+    free(store->frame);
+    free(store->frameDirection);
+    free(store->frameTimer);
+    free(store->appearance);
+    free(store->id);
+    free(store->stepping);
+    free(store->indexOf);
+    free(store->generation);
+    free(store->freeSlots);
+    free(store);
+}
+
+u16 AddEntityAppearance(EntityStore *store, const char *const *sheetPaths, const u32 layerCount)
+{
+    assert(store->appearanceCount < ENTITY_MAX_APPEARANCES && "[ERROR] Too many entity appearances");
+    assert(layerCount <= ENTITY_APPEARANCE_LAYERS && "[ERROR] Too many layers in an entity appearance");
+
+    EntityAppearance *ap = &store->appearances[store->appearanceCount];
+    for (u32 l = 0; l < layerCount; l++) AcquireTextureRegion(sheetPaths[l], &ap->layers[l]);
+    ap->layerCount = layerCount;
+
+    return (u16)store->appearanceCount++;
+}
+
+EntityId SpawnEntity(EntityStore *store, const int tileX, const int tileY, const Direction facing,
+                     const u16 appearance, const u32 tileSize)
+{
+    if (store->count == store->capacity) GrowComponents(store, store->capacity * 2);
+
+    u32 slot;
+    if (store->freeCount > 0) {
+        slot = store->freeSlots[--store->freeCount];
+    } else {
+        slot = ++store->slotCount;
+        assert(slot <= ENTITY_SLOT_MASK && "[ERROR] Too many entities");
+        if (slot >= store->slotCapacity) {
+            store->slotCapacity = store->slotCapacity ? store->slotCapacity * 2 : ENTITY_DEFAULT_CAPACITY;
+            store->indexOf      = GrowArray(store->indexOf,    store->slotCapacity, sizeof(u32));
+            store->generation   = GrowArray(store->generation, store->slotCapacity, sizeof(u32));
+            store->freeSlots    = GrowArray(store->freeSlots,  store->slotCapacity, sizeof(u32));
+        }
+        store->generation[slot] = 0;
+    }
+
+    const EntityId id = (store->generation[slot] << ENTITY_SLOT_SHIFT) | slot;
+
+    const float ts   = (float)tileSize;
+    const float half = ts * 0.5f;
+    const u32 i      = store->count++;
+
+    store->tileX[i]          = tileX;
+    store->tileY[i]          = tileY;
+    store->targetX[i]        = tileX;
+    store->targetY[i]        = tileY;
+    store->moveTimer[i]      = 0.0f;
+    store->moveDuration[i]   = BASE_MOVE_DURATION;
+    store->position[i]       = (Vector2){ (float)tileX * ts + half, (float)tileY * ts + half };
+    store->direction[i]      = (u8)facing;
+    store->action[i]         = ACTION_IDLE;
+    store->moving[i]         = 0;
+    store->intent[i]         = ENTITY_INTENT_NONE;
+    store->frame[i]          = 0;
+    store->frameDirection[i] = 1;
+    store->frameTimer[i]     = 0.0f;
+    store->appearance[i]     = appearance;
+    store->id[i]             = id;
+    store->indexOf[slot]     = i;
+
+    return id;
+}
+
+u32 GetEntityIndex(const EntityStore *store, const EntityId id)
+{
+    const u32 slot = id & ENTITY_SLOT_MASK;
+    if (slot == 0 || slot > store->slotCount)               return UINT32_MAX;
+    if (id >> ENTITY_SLOT_SHIFT != store->generation[slot]) return UINT32_MAX;
+    return store->indexOf[slot];
+}
+
+void DespawnEntity(EntityStore *store, const EntityId id)
+{
+    const u32 i = GetEntityIndex(store, id);
+    if (i == UINT32_MAX) return;
+
+    // The last entity fills the hole so the arrays stay packed
+    const u32 last = --store->count;
+    if (i != last) {
+        store->tileX[i]          = store->tileX[last];
+        store->tileY[i]          = store->tileY[last];
+        store->targetX[i]        = store->targetX[last];
+        store->targetY[i]        = store->targetY[last];
+        store->moveTimer[i]      = store->moveTimer[last];
+        store->moveDuration[i]   = store->moveDuration[last];
+        store->position[i]       = store->position[last];
+        store->direction[i]      = store->direction[last];
+        store->action[i]         = store->action[last];
+        store->moving[i]         = store->moving[last];
+        store->intent[i]         = store->intent[last];
+        store->frame[i]          = store->frame[last];
+        store->frameDirection[i] = store->frameDirection[last];
+        store->frameTimer[i]     = store->frameTimer[last];
+        store->appearance[i]     = store->appearance[last];
+        store->id[i]             = store->id[last];
+        store->indexOf[store->id[i] & ENTITY_SLOT_MASK] = i;
+    }
+
+    // The generation wraps within the id's high bits, after that many reuses of one slot
+    const u32 slot = id & ENTITY_SLOT_MASK;
+    store->indexOf[slot]    = UINT32_MAX;
+    store->generation[slot] = (store->generation[slot] + 1) & (UINT32_MAX >> ENTITY_SLOT_SHIFT);
+    store->freeSlots[store->freeCount++] = slot;
+}
+
+void SetEntityIntent(EntityStore *store, const EntityId id, const u8 intent)
+{
+    const u32 i = GetEntityIndex(store, id);
+    if (i != UINT32_MAX) store->intent[i] = intent;
+}
+
+// StartMoving, or the end of a step in UpdatePlayerMovement: the few entities each frame
+// that touch the collision map
+static void StepEntity(EntityStore *store, const u32 i, const float frameTime, const Collision *collision)
+{
+    const u8 intent = store->intent[i];
+    const u32 step  = intent & ENTITY_INTENT_DIR_MASK;
+    const u8 dir    = (u8)(step - 1);
+    const PlayerAction stepAction = (intent & ENTITY_INTENT_RUN) ? ACTION_RUN : ACTION_WALK;
+
+    if (!store->moving[i])
+    {
+        const int tx = store->tileX[i] + stepX[step];
+        const int ty = store->tileY[i] + stepY[step];
+        store->direction[i] = dir;
+
+        if (IsCollisionTileSolid(collision, tx, ty)) {
+            store->action[i] = ACTION_IDLE;
+            return;
+        }
+
+        store->action[i]       = (u8)stepAction;
+        store->moveDuration[i] = GetMoveDuration(stepAction);
+        store->targetX[i]      = tx;
+        store->targetY[i]      = ty;
+        store->moving[i]       = 1;
+        store->moveTimer[i]    = frameTime;
+
+        if (store->moveTimer[i] / store->moveDuration[i] < 1.0f) return;
+    }
+
+    store->tileX[i] = store->targetX[i];
+    store->tileY[i] = store->targetY[i];
+
+    if (step != 0)
+    {
+        const int tx = store->tileX[i] + stepX[step];
+        const int ty = store->tileY[i] + stepY[step];
+
+        if (!IsCollisionTileSolid(collision, tx, ty))
+        {
+            store->targetX[i]       = tx;
+            store->targetY[i]       = ty;
+            store->moveTimer[i]    -= store->moveDuration[i];
+            store->moveDuration[i]  = GetMoveDuration(stepAction);
+            store->action[i]        = (u8)stepAction;
+            store->direction[i]     = dir;
+        }
+        else
+        {
+            store->moving[i] = 0;
+            store->action[i] = ACTION_IDLE;
+        }
+    }
+    else
+    {
+        store->moving[i]    = 0;
+        store->moveTimer[i] = 0.0f;
+        store->action[i]    = ACTION_IDLE;
+    }
+}
+
+// UpdatePlayerMovement without the turn-in-place delay, which is there for the keyboard.
+// Timers advance and positions slide in straight passes over every entity; only those
+// starting or finishing a step this frame take the branchy path.
+void UpdateEntityMovement(EntityStore *store, const float frameTime, const Collision *collision, const u32 tileSize)
+{
+    TRACE_ZONE("UpdateEntityMovement");
+
+    // Locals, so the byte-sized stores below can't make the compiler reload the array pointers
+    const u32 count       = store->count;
+    const u8 *moving      = store->moving;
+    const u8 *intent      = store->intent;
+    const float *duration = store->moveDuration;
+    float *moveTimer      = store->moveTimer;
+    u32 *stepping         = store->stepping;
+    u32 steps             = 0;
+
+    // Whether an entity moves is close to random across the arrays, so this pass selects
+    // with arithmetic rather than branching on it
+    for (u32 i = 0; i < count; i++)
+    {
+        const u32 isMoving = moving[i];
+        const float timer  = moveTimer[i] + frameTime * (float)isMoving;
+        moveTimer[i]       = timer;
+
+        const u32 arrived = timer / duration[i] >= 1.0f;
+        const u32 wants   = (intent[i] & ENTITY_INTENT_DIR_MASK) != 0;
+
+        stepping[steps] = i;
+        steps += (isMoving & arrived) | ((isMoving ^ 1u) & wants);
+    }
+
+    for (u32 s = 0; s < steps; s++) StepEntity(store, stepping[s], frameTime, collision);
+
+    // A standing entity has its target on its own tile, so this leaves it on the tile center
+    const float ts     = (float)tileSize;
+    const float halfTs = ts * 0.5f;
+    const int *tileX   = store->tileX;
+    const int *tileY   = store->tileY;
+    const int *targetX = store->targetX;
+    const int *targetY = store->targetY;
+    Vector2 *position  = store->position;
+
+    for (u32 i = 0; i < count; i++)
+    {
+        float t = moveTimer[i] / duration[i];
+        if (t > 1.0f) t = 1.0f;
+
+        const float sx = (float)tileX[i]   * ts + halfTs;
+        const float sy = (float)tileY[i]   * ts + halfTs;
+        const float ex = (float)targetX[i] * ts + halfTs;
+        const float ey = (float)targetY[i] * ts + halfTs;
+
+        position[i].x = sx + (ex - sx) * t;
+        position[i].y = sy + (ey - sy) * t;
+    }
+}
+
+// Same ping-pong over frames 0..2 as UpdateAnimation, looked up by frame * 2 + frameDirection
+static const u8 nextFrame[6]          = { 0, 1, 0, 2, 1, 2 };
+static const u8 nextFrameDirection[6] = { 1, 1, 1, 0, 0, 0 };
+
+void UpdateEntityAnimation(EntityStore *store, const float frameTime)
+{
+    TRACE_ZONE("UpdateEntityAnimation");
+
+    const u32 count       = store->count;
+    const u8 *action      = store->action;
+    const float *duration = store->moveDuration;
+    float *frameTimer     = store->frameTimer;
+    u8 *frame             = store->frame;
+    u8 *frameDirection    = store->frameDirection;
+
+    for (u32 i = 0; i < count; i++)
+    {
+        const u32 active  = action[i] != ACTION_IDLE;
+        const float timer = frameTimer[i] + frameTime;
+        const u32 advance = active & (timer >= duration[i] / 3.0f);
+        const u32 k       = frame[i] * 2u + frameDirection[i];
+        const u32 keep    = active & (advance ^ 1u);
+
+        frameTimer[i]     = timer * (float)keep;
+        frame[i]          = (u8)(keep * frame[i] + advance * nextFrame[k] + (active ^ 1u));
+        frameDirection[i] = (u8)((advance ^ 1u) * frameDirection[i] + advance * nextFrameDirection[k]);
+    }
+}
+
+void UpdateEntities(EntityStore *store, const float frameTime, const Collision *collision, const u32 tileSize)
+{
+    UpdateEntityMovement(store, frameTime, collision, tileSize);
+    UpdateEntityAnimation(store, frameTime);
+}
+
+void DrawEntities(const EntityStore *store, const Rectangle view)
+{
+    TRACE_ZONE("DrawEntities");
+
+    const Vector2 origin = { ENTITY_FRAME_SIZE * 0.5f, ENTITY_FRAME_SIZE * 0.75f };
+
+    for (u32 i = 0; i < store->count; i++)
+    {
+        const Rectangle dst = {
+            .x      = floorf(store->position[i].x),
+            .y      = floorf(store->position[i].y),
+            .width  = ENTITY_FRAME_SIZE,
+            .height = ENTITY_FRAME_SIZE
+        };
+
+        const Rectangle bounds = { dst.x - origin.x, dst.y - origin.y, dst.width, dst.height };
+        if (!CheckCollisionRecs(bounds, view)) continue;
+
+        const Rectangle src = {
+            .x      = (float)store->frame[i] * ENTITY_FRAME_SIZE,
+            .y      = (float)GetActionSpriteRow(store->action[i], store->direction[i]) * ENTITY_FRAME_SIZE,
+            .width  = ENTITY_FRAME_SIZE,
+            .height = ENTITY_FRAME_SIZE
+        };
+
+        const EntityAppearance *ap = &store->appearances[store->appearance[i]];
+        for (u32 l = 0; l < ap->layerCount; l++) {
+            DrawTexturePro(ap->layers[l].texture, GetRegionSubRect(&ap->layers[l], src), dst, origin, 0.0f, WHITE);
+        }
+    }
+}
\ No newline at end of file
@@ -1,24 +1,37 @@
 #include "ivy/game.h"
 #include "ivy/utils.h"
 #include "ivy/scenes.h"
+#include "ivy/pack.h"
+#include "ivy/atlas.h"
+#include "ivy/texture_registry.h"
+#include "ivy/trace.h"
 
 #include <stddef.h>
 
 Game GameInit(const u32 sw, const u32 sh)
 {
+    TRACE_THREAD("Main");
+    TRACE_ZONE("GameInit");
+
     Game game = {0};
 
     game.screen.screenWidth  = sw;
     game.screen.screenHeight = sh;
 
+    if (MountPack(PACK_FILE_PATH))
+        TraceLog(LOG_INFO, "PACK: Mounted '%s'", PACK_FILE_PATH);
+
+    LoadAtlasIndex(ATLAS_INDEX_PATH);
+
+    InitAssetLoader(ASSET_LOADER_WORKERS);
+
     game.viewport = InitVirtualScreen(sw, sh);
     SetTextureFilter(game.viewport.target.texture, TEXTURE_FILTER_POINT);
 
     game.fonts[IVY_FONT_PRIMARY]   = LoadFontBin(PRIMARY_FONT_PATH, LOAD_FONT_SIZE);
-    game.fonts[IVY_FONT_SECONDARY] = LoadFontBin(SECONDARY_FONT_PATH, LOAD_FONT_SIZE);
+    SetTextureFilter(game.fonts[IVY_FONT_PRIMARY].texture, TEXTURE_FILTER_BILINEAR);
 
-    SetTextureFilter(game.fonts[IVY_FONT_PRIMARY].texture,   TEXTURE_FILTER_BILINEAR);
-    SetTextureFilter(game.fonts[IVY_FONT_SECONDARY].texture, TEXTURE_FILTER_BILINEAR);
+    game.glyphCache = CreateGlyphCache(SECONDARY_FONT_PATH, LOAD_FONT_SIZE, game.fonts[IVY_FONT_PRIMARY]);
 
     game.cursors[IVY_CURSOR_PRIMARY]   = LoadTextureFromImageBin(PRIMARY_CURSOR_PATH);
     game.cursors[IVY_CURSOR_SECONDARY] = LoadTextureFromImageBin(SECONDARY_CURSOR_PATH);
@@ -43,13 +56,19 @@ Game GameInit(const u32 sw, const u32 sh)
         .isRunning    = true
     };
 
+    TRACE_BEGIN("Scene.Init");
     sm->activeScene.Init(&sm->activeScene);
+    TRACE_END();
 
     return game;
 }
 
 void GameUpdate(Game *game)
 {
+    TRACE_ZONE("GameUpdate");
+
+    if (IsKeyPressed(KEY_F9)) TRACE_DUMP(TRACE_DUMP_PATH);
+
     if (IsWindowResized()) {
         game->screen.screenWidth  = GetScreenWidth();
         game->screen.screenHeight = GetScreenHeight();
@@ -58,7 +77,9 @@ void GameUpdate(Game *game)
         SetTextureFilter(game->viewport.target.texture, TEXTURE_FILTER_POINT);
     }
 
+    TRACE_BEGIN("Scene.Update");
     game->sceneManager.activeScene.Update(game);
+    TRACE_END();
 
     if (game->sceneManager.sceneChanged)
         UpdateScene(&game->sceneManager);
@@ -66,25 +87,43 @@ void GameUpdate(Game *game)
 
 void GameDraw(Game *game)
 {
+    TRACE_ZONE("GameDraw");
+
+    UploadLoadedTextures(ASSET_UPLOADS_PER_FRAME);
+    UpdateTextureRegistry();
+    UpdateGlyphCache(game->glyphCache);
+
     BeginTextureMode(game->viewport.target);
         ClearBackground(BLACK);
+        TRACE_BEGIN("Scene.DrawWorld");
         game->sceneManager.activeScene.DrawWorld(game);
+        TRACE_END();
     EndTextureMode();
 
+    TRACE_BEGIN("Scene.RebuildTextures");
     game->sceneManager.activeScene.RebuildTextures(game);
+    TRACE_END();
 
     BeginDrawing();
         ClearBackground(BLACK);
         DrawVirtualResolution(&game->viewport);
+        TRACE_BEGIN("Scene.DrawUI");
         game->sceneManager.activeScene.DrawUI(game);
+        TRACE_END();
     EndDrawing();
 }
 
 void GameDestroy(const Game *game)
 {
     UnloadFont(game->fonts[IVY_FONT_PRIMARY]);
-    UnloadFont(game->fonts[IVY_FONT_SECONDARY]);
+    DestroyGlyphCache(game->glyphCache);
     UnloadTexture(game->cursors[IVY_CURSOR_PRIMARY]);
     UnloadTexture(game->cursors[IVY_CURSOR_SECONDARY]);
     UnloadRenderTexture(game->viewport.target);
+    ShutdownAssetLoader();
+    DestroyTextureRegistry();
+    UnloadAtlasIndex();
+    UnmountPack();
+
+    TRACE_DUMP(TRACE_DUMP_PATH);
 }
\ No newline at end of file
@@ -0,0 +1,393 @@
+#include "ivy/glyph_cache.h"
+#include "ivy/utils.h"
+#include "ivy/trace.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLYPH_TABLE_SIZE    (GLYPH_CACHE_CAPACITY * 2)     // power of two
+#define GLYPH_MAX_SHELVES   64
+#define GLYPH_BATCH         64      // codepoints rasterized per LoadFontData call
+
+typedef struct {
+    int         codepoint;
+    u32         page;
+    Rectangle   rec;            // glyph pixels inside the page, padding excluded
+    int         offsetX;
+    int         offsetY;
+    int         advanceX;
+    bool        used;
+} CachedGlyph;
+
+typedef struct {
+    u32 y;
+    u32 height;
+    u32 x;
+} GlyphShelf;
+
+typedef struct {
+    Texture2D   texture;
+    GlyphShelf  shelves[GLYPH_MAX_SHELVES];
+    u32         shelfCount;
+    u32         nextY;
+    u32         lastUsed;
+} GlyphPage;
+
+struct GlyphCache {
+    AssetData       font;           // kept for the cache's lifetime, LoadFontData reads it per batch
+    int             baseSize;
+    Font            fallback;
+
+    GlyphPage       pages[GLYPH_CACHE_PAGES];
+    u32             pageCount;
+
+    CachedGlyph     glyphs[GLYPH_CACHE_CAPACITY];
+    int             table[GLYPH_TABLE_SIZE];    // glyph index or -1
+    u32             freeList[GLYPH_CACHE_CAPACITY];
+    u32             freeCount;
+
+    u32             tick;
+    GlyphCacheStats stats;
+};
+
+static u32 HashCodepoint(const int codepoint)
+{
+    return ((u32)codepoint * 2654435761u) & (GLYPH_TABLE_SIZE - 1);
+}
+
+static CachedGlyph *FindGlyph(GlyphCache *cache, const int codepoint)
+{
+    for (u32 slot = HashCodepoint(codepoint);; slot = (slot + 1) & (GLYPH_TABLE_SIZE - 1))
+    {
+        const int index = cache->table[slot];
+        if (index < 0) return NULL;
+        if (cache->glyphs[index].codepoint == codepoint) return &cache->glyphs[index];
+    }
+}
+
+static void InsertIntoTable(GlyphCache *cache, const u32 index)
+{
+    u32 slot = HashCodepoint(cache->glyphs[index].codepoint);
+    while (cache->table[slot] >= 0) slot = (slot + 1) & (GLYPH_TABLE_SIZE - 1);
+    cache->table[slot] = (int)index;
+}
+
+static void RebuildTable(GlyphCache *cache)
+{
+    for (u32 i = 0; i < GLYPH_TABLE_SIZE; i++) cache->table[i] = -1;
+    for (u32 i = 0; i < GLYPH_CACHE_CAPACITY; i++) {
+        if (cache->glyphs[i].used) InsertIntoTable(cache, i);
+    }
+}
+
+static bool AddPage(GlyphCache *cache)
+{
+    if (cache->pageCount >= GLYPH_CACHE_PAGES) return false;
+
+    const Image blank = {
+        .data    = calloc((size_t)GLYPH_PAGE_SIZE * GLYPH_PAGE_SIZE, 2),
+        .width   = GLYPH_PAGE_SIZE,
+        .height  = GLYPH_PAGE_SIZE,
+        .mipmaps = 1,
+        .format  = PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA
+    };
+    assert(blank.data && "[ERROR] Out of memory!");
+
+    GlyphPage *page = &cache->pages[cache->pageCount++];
+    *page = (GlyphPage){ .texture = LoadTextureFromImage(blank), .lastUsed = cache->tick };
+    SetTextureFilter(page->texture, TEXTURE_FILTER_BILINEAR);
+
+    free(blank.data);
+    cache->stats.pages = cache->pageCount;
+    return true;
+}
+
+// Recycles the least recently drawn page that nothing in the current frame refers to
+static bool EvictPage(GlyphCache *cache)
+{
+    int victim = -1;
+    for (u32 p = 0; p < cache->pageCount; p++) {
+        const GlyphPage *page = &cache->pages[p];
+        if (page->lastUsed == cache->tick) continue;
+        if (victim < 0 || page->lastUsed < cache->pages[victim].lastUsed) victim = (int)p;
+    }
+    if (victim < 0) return false;
+
+    for (u32 i = 0; i < GLYPH_CACHE_CAPACITY; i++) {
+        CachedGlyph *g = &cache->glyphs[i];
+        if (!g->used || g->page != (u32)victim) continue;
+
+        g->used = false;
+        cache->freeList[cache->freeCount++] = i;
+        cache->stats.glyphs--;
+    }
+
+    GlyphPage *page  = &cache->pages[victim];
+    page->shelfCount = 0;
+    page->nextY      = 0;
+    page->lastUsed   = cache->tick;
+
+    RebuildTable(cache);
+    cache->stats.evictions++;
+    return true;
+}
+
+static bool PlaceInPage(GlyphPage *page, const u32 w, const u32 h, u32 *outX, u32 *outY)
+{
+    // Reuse a shelf of similar height so short glyphs do not waste tall rows
+    for (u32 s = 0; s < page->shelfCount; s++) {
+        GlyphShelf *shelf = &page->shelves[s];
+        if (h > shelf->height || h * 4 < shelf->height * 3) continue;
+        if (shelf->x + w > GLYPH_PAGE_SIZE) continue;
+
+        *outX = shelf->x;
+        *outY = shelf->y;
+        shelf->x += w;
+        return true;
+    }
+
+    if (page->shelfCount >= GLYPH_MAX_SHELVES || page->nextY + h > GLYPH_PAGE_SIZE) return false;
+
+    page->shelves[page->shelfCount++] = (GlyphShelf){ .y = page->nextY, .height = h, .x = w };
+    *outX = 0;
+    *outY = page->nextY;
+    page->nextY += h;
+    return true;
+}
+
+static bool Allocate(GlyphCache *cache, const u32 w, const u32 h, u32 *outPage, u32 *outX, u32 *outY)
+{
+    for (;;)
+    {
+        for (u32 p = 0; p < cache->pageCount; p++) {
+            if (PlaceInPage(&cache->pages[p], w, h, outX, outY)) {
+                *outPage = p;
+                return true;
+            }
+        }
+
+        if (!AddPage(cache) && !EvictPage(cache)) return false;
+    }
+}
+
+static void InsertGlyph(GlyphCache *cache, const GlyphInfo *info)
+{
+    if (cache->freeCount == 0 && !EvictPage(cache)) return;
+
+    Image image = info->image;
+    const u32 w = (u32)image.width;
+    const u32 h = (u32)image.height;
+    const u32 slotW = w + 2 * GLYPH_PADDING;
+    const u32 slotH = h + 2 * GLYPH_PADDING;
+
+    u32 page, x, y;
+    if (slotW > GLYPH_PAGE_SIZE || slotH > GLYPH_PAGE_SIZE || !Allocate(cache, slotW, slotH, &page, &x, &y)) {
+        TraceLog(LOG_WARNING, "GLYPHS: No room for codepoint U+%04X", (unsigned)info->value);
+        return;
+    }
+
+    // Padding is uploaded as transparent so bilinear sampling never picks up an older glyph
+    u8 *pixels = calloc((size_t)slotW * slotH, 2);
+    assert(pixels && "[ERROR] Out of memory!");
+
+    const u8 *gray = image.data;
+    for (u32 row = 0; gray && row < h; row++) {
+        for (u32 col = 0; col < w; col++) {
+            u8 *dst = pixels + (((row + GLYPH_PADDING) * slotW) + col + GLYPH_PADDING) * 2;
+            dst[0] = 255;
+            dst[1] = gray[row * w + col];
+        }
+    }
+
+    UpdateTextureRec(cache->pages[page].texture, (Rectangle){ (float)x, (float)y, (float)slotW, (float)slotH }, pixels);
+    free(pixels);
+
+    const u32 index = cache->freeList[--cache->freeCount];
+    cache->glyphs[index] = (CachedGlyph){
+        .codepoint = info->value,
+        .page      = page,
+        .rec       = { (float)(x + GLYPH_PADDING), (float)(y + GLYPH_PADDING), (float)w, (float)h },
+        .offsetX   = info->offsetX,
+        .offsetY   = info->offsetY,
+        .advanceX  = info->advanceX,
+        .used      = true
+    };
+    InsertIntoTable(cache, index);
+
+    cache->pages[page].lastUsed = cache->tick;
+    cache->stats.glyphs++;
+}
+
+static void RasterizeBatch(GlyphCache *cache, int *codepoints, const int count)
+{
+    TRACE_ZONE("RasterizeGlyphs");
+
+    GlyphInfo *infos = LoadFontData(cache->font.data, (int)cache->font.size, cache->baseSize, codepoints, count, FONT_DEFAULT);
+    if (!infos) return;
+
+    for (int i = 0; i < count; i++) {
+        if (infos[i].image.format != PIXELFORMAT_UNCOMPRESSED_GRAYSCALE)
+            ImageFormat(&infos[i].image, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+        InsertGlyph(cache, &infos[i]);
+        cache->stats.rasterized++;
+    }
+    UnloadFontData(infos, count);
+}
+
+// Marks every glyph of text as in use this frame and rasterizes the missing ones in batches
+static void PrepareText(GlyphCache *cache, const char *text)
+{
+    int missing[GLYPH_BATCH];
+    int missingCount = 0;
+
+    for (const char *c = text; *c;)
+    {
+        int size = 0;
+        const int codepoint = GetCodepointNext(c, &size);
+        c += size;
+        if (codepoint == '\n') continue;
+
+        const CachedGlyph *g = FindGlyph(cache, codepoint);
+        if (g) {
+            cache->pages[g->page].lastUsed = cache->tick;
+            continue;
+        }
+
+        bool queued = false;
+        for (int i = 0; i < missingCount && !queued; i++) queued = missing[i] == codepoint;
+        if (queued) continue;
+
+        missing[missingCount++] = codepoint;
+        if (missingCount == GLYPH_BATCH) {
+            RasterizeBatch(cache, missing, missingCount);
+            missingCount = 0;
+        }
+    }
+
+    if (missingCount > 0) RasterizeBatch(cache, missing, missingCount);
+}
+
+GlyphCache *CreateGlyphCache(const char *path, const int baseSize, const Font fallback)
+{
+    GlyphCache *cache = calloc(1, sizeof(GlyphCache));
+    assert(cache && "[ERROR] Failed to allocate memory for glyph cache!");
+
+    cache->font     = LoadAssetData(path);
+    cache->baseSize = baseSize;
+    cache->fallback = fallback;
+    cache->tick     = 1;
+
+    for (u32 i = 0; i < GLYPH_CACHE_CAPACITY; i++)
+        cache->freeList[i] = GLYPH_CACHE_CAPACITY - 1 - i;
+    cache->freeCount = GLYPH_CACHE_CAPACITY;
+    RebuildTable(cache);
+
+    if (!cache->font.data)
+        TraceLog(LOG_WARNING, "GLYPHS: '%s' missing, text falls back to the primary font", path);
+
+    return cache;
+}
+
+void DestroyGlyphCache(GlyphCache *cache)
+{
+    if (!cache) return;
+
+    TraceLog(LOG_INFO, "GLYPHS: %u rasterized, %u cached on %u pages, %u page evictions",
+             cache->stats.rasterized, cache->stats.glyphs, cache->stats.pages, cache->stats.evictions);
+
+    for (u32 p = 0; p < cache->pageCount; p++) UnloadTexture(cache->pages[p].texture);
+    UnloadAssetData(&cache->font);
+    free(cache);
+}
+
+void UpdateGlyphCache(GlyphCache *cache)
+{
+    if (cache) cache->tick++;
+}
+
+void DrawTextCached(GlyphCache *cache, const char *text, const Vector2 position, const float fontSize, const float spacing, const Color tint)
+{
+    if (!text) return;
+    if (!cache->font.data) {
+        DrawTextEx(cache->fallback, text, position, fontSize, spacing, tint);
+        return;
+    }
+
+    PrepareText(cache, text);
+
+    const float scale = fontSize / (float)cache->baseSize;
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+
+    for (const char *c = text; *c;)
+    {
+        int size = 0;
+        const int codepoint = GetCodepointNext(c, &size);
+        c += size;
+
+        if (codepoint == '\n') {
+            offsetY += fontSize + GLYPH_LINE_SPACING;
+            offsetX  = 0.0f;
+            continue;
+        }
+
+        const CachedGlyph *g = FindGlyph(cache, codepoint);
+        if (!g) continue;
+
+        if (codepoint != ' ' && codepoint != '\t')
+        {
+            const float pad = (float)GLYPH_PADDING;
+            const Rectangle src = { g->rec.x - pad, g->rec.y - pad, g->rec.width + 2.0f * pad, g->rec.height + 2.0f * pad };
+            const Rectangle dst = {
+                position.x + offsetX + ((float)g->offsetX - pad) * scale,
+                position.y + offsetY + ((float)g->offsetY - pad) * scale,
+                src.width  * scale,
+                src.height * scale
+            };
+            DrawTexturePro(cache->pages[g->page].texture, src, dst, (Vector2){0}, 0.0f, tint);
+        }
+
+        offsetX += (g->advanceX == 0 ? g->rec.width : (float)g->advanceX) * scale + spacing;
+    }
+}
+
+Vector2 MeasureTextCached(GlyphCache *cache, const char *text, const float fontSize, const float spacing)
+{
+    if (!text || !text[0]) return (Vector2){0};
+    if (!cache->font.data) return MeasureTextEx(cache->fallback, text, fontSize, spacing);
+
+    PrepareText(cache, text);
+
+    float width = 0.0f, widest = 0.0f, height = fontSize;
+    int count = 0, widestCount = 0;
+
+    for (const char *c = text; *c;)
+    {
+        int size = 0;
+        const int codepoint = GetCodepointNext(c, &size);
+        c += size;
+        count++;
+
+        if (codepoint == '\n') {
+            if (widest < width) widest = width;
+            width   = 0.0f;
+            count   = 0;
+            height += fontSize + GLYPH_LINE_SPACING;
+        }
+        else {
+            const CachedGlyph *g = FindGlyph(cache, codepoint);
+            if (g) width += g->advanceX > 0 ? (float)g->advanceX : g->rec.width + (float)g->offsetX;
+        }
+
+        if (widestCount < count) widestCount = count;
+    }
+
+    if (widest < width) widest = width;
+    return (Vector2){ widest * fontSize / (float)cache->baseSize + (float)(widestCount - 1) * spacing, height };
+}
+
+GlyphCacheStats GetGlyphCacheStats(const GlyphCache *cache)
+{
+    return cache ? cache->stats : (GlyphCacheStats){0};
+}
\ No newline at end of file
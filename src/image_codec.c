@@ -0,0 +1,202 @@
+#include "ivy/image_codec.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define OP_INDEX    0x00    // 00xxxxxx
+#define OP_DIFF     0x40    // 01rrggbb
+#define OP_LUMA     0x80    // 10gggggg rrrrbbbb
+#define OP_RUN      0xC0    // 11xxxxxx
+#define OP_RGB      0xFE
+#define OP_RGBA     0xFF
+#define OP_MASK     0xC0
+
+#define MAX_RUN     62
+
+typedef union {
+    struct { u8 r, g, b, a; } c;
+    u32 v;
+} Pixel;
+
+static inline u32 HashPixel(const Pixel p)
+{
+    return (p.c.r * 3u + p.c.g * 5u + p.c.b * 7u + p.c.a * 11u) & 63u;
+}
+
+bool ReadEncodedImageHeader(const u8 *data, const u32 size, ImageCodecHeader *outHeader)
+{
+    if (!data || size < sizeof(ImageCodecHeader)) return false;
+
+    ImageCodecHeader h;
+    memcpy(&h, data, sizeof(h));
+
+    if (h.magic != IMAGE_CODEC_MAGIC) return false;
+    if (h.version == 0 || h.version > IMAGE_CODEC_VERSION) return false;
+    if (h.format != IMAGE_CODEC_FORMAT || h.width == 0 || h.height == 0) return false;
+    if (h.encodedSize > size - sizeof(ImageCodecHeader)) return false;
+
+    if (outHeader) *outHeader = h;
+    return true;
+}
+
+u8 *EncodeImagePixels(const u8 *rgba, const u32 width, const u32 height, u32 *outSize)
+{
+    const u64 pixelCount = (u64)width * height;
+
+    // Worst case is one OP_RGBA (5 bytes) per pixel
+    const u64 capacity = sizeof(ImageCodecHeader) + pixelCount * 5;
+    u8 *out = malloc((size_t)capacity);
+    if (!out) return NULL;
+
+    Pixel index[64];
+    memset(index, 0, sizeof(index));
+
+    Pixel prev = { .c = { 0, 0, 0, 255 } };
+    u8 *op   = out + sizeof(ImageCodecHeader);
+    u32 run  = 0;
+
+    for (u64 i = 0; i < pixelCount; i++)
+    {
+        Pixel px;
+        memcpy(&px, rgba + i * 4, 4);
+
+        if (px.v == prev.v) {
+            if (++run == MAX_RUN) {
+                *op++ = OP_RUN | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run > 0) {
+            *op++ = OP_RUN | (run - 1);
+            run = 0;
+        }
+
+        const u32 slot = HashPixel(px);
+
+        if (index[slot].v == px.v) {
+            *op++ = OP_INDEX | slot;
+        }
+        else {
+            index[slot] = px;
+
+            if (px.c.a == prev.c.a) {
+                const signed char dr = (signed char)(px.c.r - prev.c.r);
+                const signed char dg = (signed char)(px.c.g - prev.c.g);
+                const signed char db = (signed char)(px.c.b - prev.c.b);
+                const signed char rg = (signed char)(dr - dg);
+                const signed char bg = (signed char)(db - dg);
+
+                if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+                    *op++ = OP_DIFF | (u8)((dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                }
+                else if (rg > -9 && rg < 8 && dg > -33 && dg < 32 && bg > -9 && bg < 8) {
+                    *op++ = OP_LUMA | (u8)(dg + 32);
+                    *op++ = (u8)((rg + 8) << 4 | (bg + 8));
+                }
+                else {
+                    *op++ = OP_RGB;
+                    *op++ = px.c.r;
+                    *op++ = px.c.g;
+                    *op++ = px.c.b;
+                }
+            }
+            else {
+                *op++ = OP_RGBA;
+                memcpy(op, &px, 4);
+                op += 4;
+            }
+        }
+
+        prev = px;
+    }
+
+    if (run > 0) *op++ = OP_RUN | (run - 1);
+
+    const ImageCodecHeader header = {
+        .magic       = IMAGE_CODEC_MAGIC,
+        .version     = IMAGE_CODEC_VERSION,
+        .width       = width,
+        .height      = height,
+        .format      = IMAGE_CODEC_FORMAT,
+        .encodedSize = (u32)(op - out - sizeof(ImageCodecHeader))
+    };
+    memcpy(out, &header, sizeof(header));
+
+    *outSize = (u32)(op - out);
+    return out;
+}
+
+bool DecodeImagePixels(const u8 *data, const u32 size, u8 *outRgba)
+{
+    ImageCodecHeader h;
+    if (!ReadEncodedImageHeader(data, size, &h)) return false;
+
+    const u8 *op    = data + sizeof(ImageCodecHeader);
+    const u8 *opEnd = op + h.encodedSize;
+    u8 *dst         = outRgba;
+    u8 *dstEnd      = outRgba + (u64)h.width * h.height * 4;
+
+    Pixel index[64];
+    memset(index, 0, sizeof(index));
+    Pixel px = { .c = { 0, 0, 0, 255 } };
+
+    while (dst < dstEnd)
+    {
+        if (op >= opEnd) return false;
+        const u8 b = *op++;
+
+        if (b == OP_RGB) {
+            if (opEnd - op < 3) return false;
+            px.c.r = op[0];
+            px.c.g = op[1];
+            px.c.b = op[2];
+            op += 3;
+        }
+        else if (b == OP_RGBA) {
+            if (opEnd - op < 4) return false;
+            memcpy(&px, op, 4);
+            op += 4;
+        }
+        else switch (b & OP_MASK)
+        {
+            case OP_INDEX:
+                px = index[b];
+                memcpy(dst, &px, 4);
+                dst += 4;
+                continue;
+
+            case OP_DIFF:
+                px.c.r += ((b >> 4) & 3) - 2;
+                px.c.g += ((b >> 2) & 3) - 2;
+                px.c.b += ( b       & 3) - 2;
+                break;
+
+            case OP_LUMA: {
+                if (op >= opEnd) return false;
+                const u8  b2 = *op++;
+                const int dg = (b & 0x3F) - 32;
+                px.c.r += dg - 8 + (b2 >> 4);
+                px.c.g += dg;
+                px.c.b += dg - 8 + (b2 & 0x0F);
+            } break;
+
+            default: {
+                // Runs are written as whole words; the common case in pixel art
+                u32 run = (b & 0x3F) + 1u;
+                if ((u64)(dstEnd - dst) < (u64)run * 4) return false;
+                while (run--) {
+                    memcpy(dst, &px, 4);
+                    dst += 4;
+                }
+            } continue;
+        }
+
+        index[HashPixel(px)] = px;
+        memcpy(dst, &px, 4);
+        dst += 4;
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "ivy/inventory_ui.h"
+#include "ivy/glyph_cache.h"
 #include "ivy/player/player.h"
 #include "ivy/utils.h"
 
@@ -124,42 +125,68 @@ bool InventoryUIUpdate(InventoryUI *ui, Player *player)
     return false;
 }
 
-static void DrawItemSlot(const Rectangle slotRect, const Item *item,
-                         bool selected, bool equipped, const Font *font)
+typedef struct {
+    Rectangle   rect;
+    const Item *item;
+    bool        selected;
+    bool        equipped;
+} SlotView;
+
+static void DrawSlotFrames(const SlotView *slots, const u32 count)
 {
-    const Color bgColor  = selected ? COLOR_SLOT_SEL : COLOR_SLOT_BG;
-    const Color rimColor = selected ? COLOR_SELECTED : COLOR_BORDER;
+    for (u32 i = 0; i < count; i++) {
+        const SlotView *v = &slots[i];
+        DrawRectangleRec(v->rect, v->selected ? COLOR_SLOT_SEL : COLOR_SLOT_BG);
+        DrawRectangleLinesEx(v->rect, v->selected ? 1.5f : 1.0f,
+                             v->selected ? COLOR_SELECTED : COLOR_BORDER);
+    }
+}
 
-    DrawRectangleRec(slotRect, bgColor);
-    DrawRectangleLinesEx(slotRect, selected ? 1.5f : 1.0f, rimColor);
+static void DrawSlotIcons(const SlotView *slots, const u32 count)
+{
+    const float pad = 2.0f;
 
-    if (!item) return;
+    for (u32 i = 0; i < count; i++) {
+        const SlotView *v = &slots[i];
+        if (!v->item || v->item->type != ITEM_EQUIPMENT) continue;
 
-    const Texture2D *tex = (item->type == ITEM_EQUIPMENT)
-        ? &item->data.equipment.iconTexture : NULL;
+        const TextureRegion *icon = &v->item->data.equipment.icon;
+        if (icon->texture.id == 0) continue;
 
-    if (tex && tex->id != 0) {
-        const float pad  = 2.0f;
         const Rectangle dst = {
-            slotRect.x + pad, slotRect.y + pad,
-            slotRect.width - pad * 2.0f, slotRect.height - pad * 2.0f
+            v->rect.x + pad, v->rect.y + pad,
+            v->rect.width - pad * 2.0f, v->rect.height - pad * 2.0f
         };
-        const Rectangle src = { 0, 0, (float)tex->width, (float)tex->height };
-        DrawTexturePro(*tex, src, dst, (Vector2){0}, 0.0f, WHITE);
+        DrawTexturePro(icon->texture, GetRegionSource(icon), dst, (Vector2){0}, 0.0f, WHITE);
     }
+}
+
+static void DrawSlotBadges(const SlotView *slots, const u32 count, const Font *font)
+{
+    for (u32 i = 0; i < count; i++) {
+        const SlotView *v = &slots[i];
+        if (!v->equipped) continue;
 
-    if (equipped) {
-        DrawRectangle((int)(slotRect.x + slotRect.width - 8),
-                      (int)slotRect.y, 8, 8, COLOR_EQUIPPED);
+        DrawRectangle((int)(v->rect.x + v->rect.width - 8),
+                      (int)v->rect.y, 8, 8, COLOR_EQUIPPED);
         if (font && font->baseSize > 0)
             DrawTextEx(*font, "E",
-                (Vector2){ slotRect.x + slotRect.width - 7.5f, slotRect.y + 0.5f },
+                (Vector2){ v->rect.x + v->rect.width - 7.5f, v->rect.y + 0.5f },
                 6.0f, 0, BLACK);
     }
 }
 
+// Frames, icons and badges go out in separate passes so every icon on the
+// same atlas page lands in one batch instead of one draw call per cell.
+static void DrawSlotGrid(const SlotView *slots, const u32 count, const Font *font)
+{
+    DrawSlotFrames(slots, count);
+    DrawSlotIcons(slots, count);
+    DrawSlotBadges(slots, count, font);
+}
+
 static void DrawItemPreview(const Item *item, const Rectangle panel,
-                            const Font *font, float scale)
+                            const Font *font, GlyphCache *names, float scale)
 {
     DrawRectangleRec(panel, COLOR_PANEL);
     DrawRectangleLinesEx(panel, 1.0f, COLOR_BORDER);
@@ -190,8 +217,8 @@ static void DrawItemPreview(const Item *item, const Rectangle panel,
 
     float textY = imgDst.y + imgDst.height + 6.0f * scale;
 
-    if (item->name && font && font->baseSize > 0) {
-        DrawTextEx(*font, item->name,
+    if (item->name && names) {
+        DrawTextCached(names, item->name,
             (Vector2){ panel.x + 6.0f * scale, textY },
             TEXT_SIZE * scale, 0, COLOR_TEXT);
         textY += TEXT_SIZE * scale + 3.0f * scale;
@@ -208,7 +235,7 @@ static void DrawItemPreview(const Item *item, const Rectangle panel,
 }
 
 void InventoryUIDraw(const InventoryUI *ui, const Player *player,
-                     const VirtualResolution *vr, const Font *font)
+                     const VirtualResolution *vr, const Font *font, GlyphCache *names)
 {
     if (!ui->isOpen) return;
 
@@ -294,7 +321,9 @@ void InventoryUIDraw(const InventoryUI *ui, const Player *player,
         if (inv->count > 0 && ui->selectedIndex < inv->count)
             selectedItem = inv->items[ui->selectedIndex];
 
-        DrawItemPreview(selectedItem, previewPanel, font, scale);
+        DrawItemPreview(selectedItem, previewPanel, font, names, scale);
+
+        SlotView views[INVENTORY_CAPACITY];
 
         for (u32 i = 0; i < inv->count; i++) {
             const u32   col  = i % COLS;
@@ -302,9 +331,7 @@ void InventoryUIDraw(const InventoryUI *ui, const Player *player,
             const float sx   = gridStartX + (float)col * (slotSz + slotPad);
             const float sy   = gridStartY + (float)row * (slotSz + slotPad);
 
-            const Rectangle slotRect = { sx, sy, slotSz, slotSz };
-            const Item *item         = inv->items[i];
-            const bool  sel          = (i == ui->selectedIndex);
+            const Item *item = inv->items[i];
 
             bool isEquipped = false;
             if (item && item->type == ITEM_EQUIPMENT) {
@@ -313,9 +340,16 @@ void InventoryUIDraw(const InventoryUI *ui, const Player *player,
                              (player->equipment.slots[s] == item);
             }
 
-            DrawItemSlot(slotRect, item, sel, isEquipped, font);
+            views[i] = (SlotView){
+                .rect     = { sx, sy, slotSz, slotSz },
+                .item     = item,
+                .selected = (i == ui->selectedIndex),
+                .equipped = isEquipped
+            };
         }
 
+        DrawSlotGrid(views, inv->count, font);
+
         if (inv->count == 0 && font && font->baseSize > 0)
             DrawTextEx(*font, "Bag is empty",
                 (Vector2){ gridStartX, gridStartY },
@@ -337,7 +371,9 @@ void InventoryUIDraw(const InventoryUI *ui, const Player *player,
                          ? player->equipment.slots[slot] : NULL;
         }
 
-        DrawItemPreview(selectedItem, previewPanel, font, scale);
+        DrawItemPreview(selectedItem, previewPanel, font, names, scale);
+
+        SlotView views[SLOT_MAX_SIZE];
 
         for (u32 s = 0; s < SLOT_MAX_SIZE; s++) {
             const u32   col  = s % COLS;
@@ -345,18 +381,24 @@ void InventoryUIDraw(const InventoryUI *ui, const Player *player,
             const float sx   = gridStartX + (float)col * (slotSz + slotPad);
             const float sy   = gridStartY + (float)row * (slotSz + slotPad);
 
-            const Rectangle slotRect = { sx, sy, slotSz, slotSz };
-            const bool      filled   = (player->equipment.slotMask & (1u << s)) != 0;
-            const Item     *item     = filled ? player->equipment.slots[s] : NULL;
-            const bool      isSel    = (s == sel);
+            const bool filled = (player->equipment.slotMask & (1u << s)) != 0;
+
+            views[s] = (SlotView){
+                .rect     = { sx, sy, slotSz, slotSz },
+                .item     = filled ? player->equipment.slots[s] : NULL,
+                .selected = (s == sel),
+                .equipped = false
+            };
+        }
 
-            DrawItemSlot(slotRect, item, isSel, false, font);
+        DrawSlotGrid(views, SLOT_MAX_SIZE, font);
 
-            if (font && font->baseSize > 0)
+        if (font && font->baseSize > 0) {
+            for (u32 s = 0; s < SLOT_MAX_SIZE; s++)
                 DrawTextEx(*font, EquipmentSlotName((EquipmentSlot)s),
-                    (Vector2){ sx, sy + slotSz + 1.0f * scale },
+                    (Vector2){ views[s].rect.x, views[s].rect.y + slotSz + 1.0f * scale },
                     ITEM_NAME_SIZE * scale, 0,
-                    isSel ? COLOR_SELECTED : COLOR_SUBTEXT);
+                    views[s].selected ? COLOR_SELECTED : COLOR_SUBTEXT);
         }
 
         const Vector2 hintPos = GetScreenPos(vr, (Vector2){
@@ -17,11 +17,11 @@ void DestroyItemManager(ItemManager *manager)
     if (!manager) return;
 
     for (u32 i = 0; i < manager->count; i++) {
-        const Item *item = &manager->items[i];
+        Item *item = &manager->items[i];
         if (item->type == ITEM_EQUIPMENT) {
-            UnloadTexture(item->data.equipment.iconTexture);
-            UnloadTexture(item->data.equipment.charTexture);
-            UnloadTexture(item->data.equipment.portraitTex);
+            ReleaseTextureRegion(&item->data.equipment.icon);
+            ReleaseTextureRegion(&item->data.equipment.sprite);
+            ReleaseTexture(&item->data.equipment.portraitTex);
         }
     }
 
@@ -41,24 +41,26 @@ void LoadItemsFromFile(ItemManager *manager, const char *filename)
 {
     if (manager->count >= ITEM_MANAGER_CAPACITY) return;
 
-    FILE *f = fopen(filename, "rb");
-    if (!f) {
+    AssetData asset = LoadAssetData(filename);
+    if (!asset.data) {
         TraceLog(LOG_WARNING, "LoadItemsFromFile: cannot open '%s'", filename);
         return;
     }
 
+    ByteReader reader = { .data = asset.data, .size = asset.size, .offset = 0 };
+
     unsigned int fileCount;
-    fread(&fileCount, sizeof(unsigned int), 1, f);
+    ReadExact(&reader, &fileCount, sizeof(unsigned int));
     if (fileCount == 0) {
-        fclose(f);
+        UnloadAssetData(&asset);
         return;
     }
 
     Item *it = &manager->items[manager->count];
-    fread(&it->id,   sizeof(unsigned int), 1, f);
-    fread(&it->type, sizeof(int),          1, f);
-    fread(it->name,  1, 32, f);
-    fread(it->desc,  1, 64, f);
+    ReadExact(&reader, &it->id,   sizeof(unsigned int));
+    ReadExact(&reader, &it->type, sizeof(int));
+    ReadExact(&reader, it->name,  32);
+    ReadExact(&reader, it->desc,  64);
     it->name[31] = '\0';
     it->desc[63] = '\0';
 
@@ -66,20 +68,20 @@ void LoadItemsFromFile(ItemManager *manager, const char *filename)
         EquipmentData *eq = &it->data.equipment;
         char path[64];
 
-        fread(path, 1, 64, f);  path[63] = '\0';
-        eq->iconTexture = LoadTextureFromImageBin(path);
+        ReadExact(&reader, path, 64);  path[63] = '\0';
+        AcquireTextureRegion(path, &eq->icon);
 
-        fread(path, 1, 64, f);  path[63] = '\0';
-        eq->charTexture = LoadTextureFromImageBin(path);
+        ReadExact(&reader, path, 64);  path[63] = '\0';
+        AcquireTextureRegion(path, &eq->sprite);
 
-        fread(path, 1, 64, f);  path[63] = '\0';
-        eq->portraitTex = LoadTextureFromImageBin(path);
+        ReadExact(&reader, path, 64);  path[63] = '\0';
+        AcquireTexture(path, TEXTURE_FILE_IMAGE_BIN, &eq->portraitTex);
 
-        fread(&eq->position.x, sizeof(float), 1, f);
-        fread(&eq->position.y, sizeof(float), 1, f);
-        fread(&eq->slot,       sizeof(int),   1, f);
+        ReadExact(&reader, &eq->position.x, sizeof(float));
+        ReadExact(&reader, &eq->position.y, sizeof(float));
+        ReadExact(&reader, &eq->slot,       sizeof(int));
     }
 
     manager->count++;
-    fclose(f);
+    UnloadAssetData(&asset);
 }
\ No newline at end of file
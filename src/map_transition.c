@@ -0,0 +1,167 @@
+#include "ivy/map_transition.h"
+#include "ivy/trace.h"
+
+#include <stdlib.h>
+
+// Everything but the textures, so it can run off the main thread. The path clusters are
+// left for the searches that reach them.
+static LoadedMap ReadMapById(const u32 id)
+{
+    TRACE_ZONE("ReadMapById");
+
+    Tilemap *tilemap     = ReadTilemapById(id);
+    Collision *collision = InitCollisionAllLayers(tilemap);
+    return (LoadedMap){
+        .tilemap   = tilemap,
+        .collision = collision,
+        .paths     = CreatePathService(collision),
+        .entities  = CreateEntityStore(ENTITY_DEFAULT_CAPACITY),
+        .id        = id
+    };
+}
+
+LoadedMap LoadMapById(const u32 id)
+{
+    TRACE_ZONE("LoadMapById");
+
+    // The tilesets decode on the asset loader's workers, so the map is drawn a few frames later
+    LoadedMap map = ReadMapById(id);
+    AcquireTilemapTextures(map.tilemap);
+    return map;
+}
+
+void UnloadLoadedMap(LoadedMap *map)
+{
+    if (map->id == 0) return;
+
+    DestroyEntityStore(map->entities);
+    DestroyPathService(map->paths);
+    DestroyCollision(map->collision);
+    UnloadTilemap(map->tilemap);
+    *map = (LoadedMap){0};
+}
+
+static void MapLoadMain(void *arg)
+{
+    TRACE_THREAD("Map loader");
+
+    MapLoadJob *job = arg;
+    job->map        = ReadMapById(job->id);
+    __atomic_store_n(&job->done, 1, __ATOMIC_RELEASE);
+}
+
+static void StartMapLoad(MapTransition *mt, const u32 id)
+{
+    MapLoadJob *job = &mt->load;
+    job->id         = id;
+    job->done       = 0;
+
+    // Without a thread the load still happens, just here
+    if (!StartThread(&job->thread, MapLoadMain, job)) MapLoadMain(job);
+}
+
+// Hands a finished load over to next; with wait, blocks until the thread is done
+static void FinishMapLoad(MapTransition *mt, const bool wait)
+{
+    MapLoadJob *job = &mt->load;
+    if (job->id == 0) return;
+    if (!wait && !__atomic_load_n(&job->done, __ATOMIC_ACQUIRE)) return;
+
+    TRACE_ZONE("FinishMapLoad");
+    JoinThread(&job->thread);
+    AcquireTilemapTextures(job->map.tilemap);
+
+    UnloadLoadedMap(&mt->next);
+    mt->next = job->map;
+    *job     = (MapLoadJob){0};
+}
+
+static void RequestNext(MapTransition *mt, const u32 id)
+{
+    if (mt->next.id == id || mt->load.id == id) return;
+
+    // A load can't be called off; one for another map lands first and is let go below
+    FinishMapLoad(mt, true);
+    UnloadLoadedMap(&mt->next);
+
+    if (mt->previous.id == id) {
+        mt->next     = mt->previous;
+        mt->previous = (LoadedMap){0};
+        return;
+    }
+
+    TraceLog(LOG_INFO, "MAP: Preloading map %u", id);
+    StartMapLoad(mt, id);
+}
+
+// A destination the player walked away from is kept in place of an empty previous slot.
+// One still loading is released once it lands in next.
+static void ReleaseNext(MapTransition *mt)
+{
+    if (mt->next.id == 0) return;
+
+    if (mt->previous.id == 0) mt->previous = mt->next;
+    else                      UnloadLoadedMap(&mt->next);
+    mt->next = (LoadedMap){0};
+}
+
+bool UpdateMapTransition(MapTransition *mt, LoadedMap *current, const u32 tileX, const u32 tileY)
+{
+    FinishMapLoad(mt, false);
+
+    const TilemapHeader *h = &current->tilemap->header;
+    const u32 target       = h->eventGotoMapId;
+    if (target == 0 || target == current->id) return false;
+
+    const u32 dx   = tileX > h->eventGotoTileX ? tileX - h->eventGotoTileX : h->eventGotoTileX - tileX;
+    const u32 dy   = tileY > h->eventGotoTileY ? tileY - h->eventGotoTileY : h->eventGotoTileY - tileY;
+    const u32 dist = dx > dy ? dx : dy;
+
+    if (dist > 0) mt->armed = true;
+
+    if (dist <= MAP_PRELOAD_TILES)     RequestNext(mt, target);
+    else if (dist > MAP_RELEASE_TILES) ReleaseNext(mt);
+
+    if (dist > 0 || !mt->armed) return false;
+
+    // Swap: the destination becomes current, the map left behind the previous one
+    TRACE_ZONE("MapTransition");
+    RequestNext(mt, target);
+    FinishMapLoad(mt, true);
+    UnloadLoadedMap(&mt->previous);
+
+    mt->previous = *current;
+    *current     = mt->next;
+    mt->next     = (LoadedMap){0};
+    mt->armed    = false;
+
+    TraceLog(LOG_INFO, "MAP: Entered map %u from map %u", current->id, mt->previous.id);
+    return true;
+}
+
+void StreamMapTransition(MapTransition *mt, const Vector2 viewSize)
+{
+    if (mt->next.id == 0) return;
+
+    const TilemapHeader *h = &mt->next.tilemap->header;
+    const Vector2 spawn = {
+        ((float)h->spawnPointX + 0.5f) * (float)h->tileWidth,
+        ((float)h->spawnPointY + 0.5f) * (float)h->tileHeight
+    };
+
+    UpdateTilemapStreaming(mt->next.tilemap, (Rectangle){
+        spawn.x - viewSize.x * 0.5f, spawn.y - viewSize.y * 0.5f, viewSize.x, viewSize.y
+    });
+}
+
+void DestroyMapTransition(MapTransition *mt)
+{
+    // A load still under way is waited for and dropped without its textures
+    JoinThread(&mt->load.thread);
+    UnloadLoadedMap(&mt->load.map);
+    mt->load = (MapLoadJob){0};
+
+    UnloadLoadedMap(&mt->next);
+    UnloadLoadedMap(&mt->previous);
+    mt->armed = false;
+}
\ No newline at end of file
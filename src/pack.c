@@ -0,0 +1,94 @@
+#include "ivy/pack.h"
+#include "ivy/platform.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static MappedFile       packFile;
+static const PackEntry *packEntries;
+static const char      *packStrings;
+static u32              packEntryCount;
+
+bool MountPack(const char *path)
+{
+    UnmountPack();
+
+    if (!MapFile(path, &packFile)) return false;
+
+    const PackHeader *header = (const PackHeader *)packFile.data;
+    const u64 tocEnd = packFile.size < sizeof(PackHeader) ? 0
+                     : sizeof(PackHeader) + (u64)header->entryCount * sizeof(PackEntry);
+
+    bool valid = tocEnd != 0                     &&
+                 header->magic   == PACK_MAGIC   &&
+                 header->version == PACK_VERSION &&
+                 tocEnd + header->stringTableSize <= packFile.size;
+
+    const PackEntry *entries = (const PackEntry *)(packFile.data + sizeof(PackHeader));
+    for (u32 i = 0; valid && i < header->entryCount; i++) {
+        valid = entries[i].offset + entries[i].size <= packFile.size &&
+                entries[i].pathOffset + entries[i].pathLength <= header->stringTableSize;
+    }
+
+    if (!valid) {
+        fprintf(stderr, "[WARNING] '%s' is not a valid asset pack\n", path);
+        UnmapFile(&packFile);
+        return false;
+    }
+
+    packEntries    = entries;
+    packStrings    = (const char *)(packFile.data + tocEnd);
+    packEntryCount = header->entryCount;
+    return true;
+}
+
+void UnmountPack(void)
+{
+    UnmapFile(&packFile);
+    packEntries    = NULL;
+    packStrings    = NULL;
+    packEntryCount = 0;
+}
+
+bool IsPackMounted(void)
+{
+    return packEntries != NULL;
+}
+
+static int ComparePath(const PackEntry *entry, const char *path, const size_t len)
+{
+    const size_t min = len < entry->pathLength ? len : entry->pathLength;
+    const int cmp = memcmp(path, packStrings + entry->pathOffset, min);
+    if (cmp != 0) return cmp;
+    return (len > entry->pathLength) - (len < entry->pathLength);
+}
+
+const u8 *PackFind(const char *path, u32 *outSize)
+{
+    if (!packEntries || !path) return NULL;
+
+    const u32 hash   = PackHashPath(path);
+    const size_t len = strlen(path);
+
+    u32 lo = 0;
+    u32 hi = packEntryCount;
+
+    while (lo < hi)
+    {
+        const u32 mid = lo + (hi - lo) / 2;
+        const PackEntry *e = &packEntries[mid];
+
+        int cmp = (hash > e->hash) - (hash < e->hash);
+        if (cmp == 0) cmp = ComparePath(e, path, len);
+
+        if (cmp == 0) {
+            if (outSize) *outSize = e->size;
+            return packFile.data + e->offset;
+        }
+
+        if (cmp < 0) hi = mid;
+        else         lo = mid + 1;
+    }
+
+    return NULL;
+}
\ No newline at end of file
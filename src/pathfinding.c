@@ -0,0 +1,980 @@
+#include "ivy/pathfinding.h"
+#include "ivy/platform.h"
+#include "ivy/trace.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PATH_LONG_ENTRANCE  6                           // open border runs this long get an entrance at each end
+#define PATH_DIRECT_TILES   (2 * PATH_CLUSTER_TILES)    // closer goals try the grid before the cluster graph
+#define PATH_NO_DIST        UINT16_MAX
+#define PATH_SLICE_POPS     16                          // heap pops between budget checks
+#define PATH_BUILD_POPS     32                          // a cluster rebuild costs about this many pops
+
+typedef struct {
+    u16 x, y;
+} PathNode;
+
+typedef struct {
+    PathNode    nodes[PATH_CLUSTER_NODES];  // entrance tiles on the cluster's side of a border
+    u16         *dist;                      // nodeCount^2 steps inside the cluster, PATH_NO_DIST when apart
+    u8          nodeCount;
+    bool        dirty;
+} PathCluster;
+
+typedef struct {
+    u32 key;            // g + h
+    u32 h;              // breaks ties toward the goal
+    u32 node;
+} HeapItem;
+
+typedef struct {
+    HeapItem   *items;
+    u32         count;
+    u32         capacity;
+} PathHeap;
+
+// g and parent hold for an entry only while its stamp matches search
+typedef struct {
+    u32        *g;
+    u32        *parent;
+    u32        *stamp;
+    u32         capacity;
+    u32         search;
+} SearchState;
+
+typedef struct {
+    const Collision *collision;
+    TileRect        bounds;
+    PathTile        goal;
+} JumpGrid;
+
+typedef enum {
+    SEARCH_RUNNING = 0,
+    SEARCH_FOUND,
+    SEARCH_FAILED
+} SearchResult;
+
+typedef enum {
+    PHASE_START = 0,
+    PHASE_DIRECT,               // jump point search in the box around both ends
+    PHASE_GRAPH,                // A* over the cluster entrances
+    PHASE_REFINE                // the graph route back to tiles, one leg at a time
+} SearchPhase;
+
+// Everything a search needs to stop after any heap pop and pick up from there later
+typedef struct {
+    PathTile    start;
+    PathTile    goal;
+    SearchPhase phase;
+    u32         revision;       // the service's when the search began
+    SearchState grid;           // tiles of the searched box
+    SearchState graph;          // cluster nodes, then start and goal
+    PathHeap    heap;
+    JumpGrid    jump;           // box and goal of the grid search under way
+    PathTile    legStart;
+    bool        legActive;
+    u32         startIndex;     // clusters of start and goal
+    u32         goalIndex;
+    u16         startSteps[PATH_CLUSTER_NODES + 1];
+    u16         goalSteps[PATH_CLUSTER_NODES];
+    u32         *chain;         // nodes of the graph route, goal first
+    u32         chainCapacity;
+    u32         chainNext;      // the next leg to refine runs from chain[chainNext] to chain[chainNext - 1]
+} PathSearch;
+
+typedef struct {
+    PathTile    start;
+    PathTile    goal;
+    Path        path;
+    PathStatus  status;
+    PathRequest id;
+} PathSlot;
+
+struct PathService {
+    const Collision *collision;
+    u32             width;
+    u32             height;
+    u32             clustersX;
+    u32             clustersY;
+    PathCluster     *clusters;
+    u32             revision;       // bumped by every invalidation
+    PathSearch      direct;         // FindPath's
+    PathSearch      queued;         // the request at the head of the queue
+    bool            queuedActive;
+    PathSlot        slots[PATH_MAX_REQUESTS];
+    u16             queue[PATH_MAX_REQUESTS];
+    u32             queueHead;
+    u32             queueCount;
+    u32             nextSlot;
+    PathServiceStats stats;
+};
+
+static inline int Sign(const int v)
+{
+    return (v > 0) - (v < 0);
+}
+
+static inline u32 Manhattan(const int ax, const int ay, const int bx, const int by)
+{
+    return (u32)abs(ax - bx) + (u32)abs(ay - by);
+}
+
+static inline bool IsOpenTile(const PathService *s, const int x, const int y)
+{
+    return (u32)x < s->width && (u32)y < s->height && !IsCollisionTileSolid(s->collision, x, y);
+}
+
+static inline bool IsWalkable(const JumpGrid *g, const int x, const int y)
+{
+    if ((u32)x - g->bounds.x0 >= g->bounds.x1 - g->bounds.x0) return false;
+    if ((u32)y - g->bounds.y0 >= g->bounds.y1 - g->bounds.y0) return false;
+    return !IsCollisionTileSolid(g->collision, x, y);
+}
+
+static inline u32 LocalIndex(const TileRect bounds, const int x, const int y)
+{
+    return ((u32)y - bounds.y0) * (bounds.x1 - bounds.x0) + ((u32)x - bounds.x0);
+}
+
+static inline void Spend(u32 *pops, const u32 count)
+{
+    *pops = *pops > count ? *pops - count : 0;
+}
+
+static inline bool HeapBefore(const HeapItem *a, const HeapItem *b)
+{
+    return a->key < b->key || (a->key == b->key && a->h < b->h);
+}
+
+static void HeapPush(PathHeap *heap, const HeapItem item)
+{
+    if (heap->count >= heap->capacity) {
+        heap->capacity = heap->capacity == 0 ? 256 : heap->capacity * 2;
+        HeapItem *tmp  = realloc(heap->items, heap->capacity * sizeof(HeapItem));
+        assert(tmp && "[ERROR] Failed to realloc path heap");
+        heap->items = tmp;
+    }
+
+    u32 i = heap->count++;
+    while (i > 0) {
+        const u32 up = (i - 1) >> 1;
+        if (!HeapBefore(&item, &heap->items[up])) break;
+        heap->items[i] = heap->items[up];
+        i = up;
+    }
+    heap->items[i] = item;
+}
+
+static HeapItem HeapPop(PathHeap *heap)
+{
+    const HeapItem top  = heap->items[0];
+    const HeapItem last = heap->items[--heap->count];
+
+    u32 i = 0;
+    for (;;) {
+        u32 child = 2 * i + 1;
+        if (child >= heap->count) break;
+        if (child + 1 < heap->count && HeapBefore(&heap->items[child + 1], &heap->items[child])) child++;
+        if (!HeapBefore(&heap->items[child], &last)) break;
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    if (heap->count > 0) heap->items[i] = last;
+    return top;
+}
+
+static void BeginSearch(SearchState *st, const u32 count)
+{
+    if (count > st->capacity) {
+        free(st->g);
+        free(st->parent);
+        free(st->stamp);
+        st->capacity = count;
+        st->g        = malloc(count * sizeof(u32));
+        st->parent   = malloc(count * sizeof(u32));
+        st->stamp    = calloc(count, sizeof(u32));
+        st->search   = 0;
+        assert(st->g && st->parent && st->stamp && "[ERROR] Failed to alloc path search state");
+    }
+
+    if (++st->search == 0) {
+        memset(st->stamp, 0, st->capacity * sizeof(u32));
+        st->search = 1;
+    }
+}
+
+// Queues node when this is the cheapest way to it seen so far
+static inline void Relax(SearchState *st, PathHeap *heap, const u32 node, const u32 from, const u32 g, const u32 h)
+{
+    if (st->stamp[node] == st->search && st->g[node] <= g) return;
+    st->stamp[node]  = st->search;
+    st->g[node]      = g;
+    st->parent[node] = from;
+    HeapPush(heap, (HeapItem){ g + h, h, node });
+}
+
+static void ReservePath(Path *path, const u32 count)
+{
+    if (count <= path->capacity) return;
+
+    u32 capacity = path->capacity ? path->capacity : 64;
+    while (capacity < count) capacity *= 2;
+
+    PathTile *tmp = realloc(path->tiles, capacity * sizeof(PathTile));
+    assert(tmp && "[ERROR] Failed to realloc path");
+    path->tiles    = tmp;
+    path->capacity = capacity;
+}
+
+// Jump point search on a 4-connected grid. Vertical jumps probe both horizontal
+// directions at every step, and horizontal jumps stop only where a vertical move around
+// a corner opens up. So a route can turn from vertical to horizontal anywhere but from
+// horizontal to vertical only at those corners, and every shortest route has such a form.
+
+static bool JumpHorizontal(const JumpGrid *g, int x, const int y, const int dx, int *outX)
+{
+    for (;;) {
+        x += dx;
+        if (!IsWalkable(g, x, y)) return false;
+        if (x == g->goal.x && y == g->goal.y) break;
+
+        if ((IsWalkable(g, x, y + 1) && !IsWalkable(g, x - dx, y + 1)) ||
+            (IsWalkable(g, x, y - 1) && !IsWalkable(g, x - dx, y - 1)))
+            break;
+    }
+    *outX = x;
+    return true;
+}
+
+static bool JumpVertical(const JumpGrid *g, const int x, int y, const int dy, int *outY)
+{
+    int probe;
+    for (;;) {
+        y += dy;
+        if (!IsWalkable(g, x, y)) return false;
+        if (x == g->goal.x && y == g->goal.y) break;
+        if (JumpHorizontal(g, x, y, 1, &probe) || JumpHorizontal(g, x, y, -1, &probe)) break;
+    }
+    *outY = y;
+    return true;
+}
+
+static bool BeginGridSearch(PathSearch *q, const Collision *collision, const TileRect bounds,
+                            const PathTile start, const PathTile goal)
+{
+    q->jump     = (JumpGrid){ collision, bounds, goal };
+    q->legStart = start;
+    if (!IsWalkable(&q->jump, start.x, start.y) || !IsWalkable(&q->jump, goal.x, goal.y)) return false;
+
+    BeginSearch(&q->grid, (bounds.x1 - bounds.x0) * (bounds.y1 - bounds.y0));
+    q->heap.count = 0;
+
+    const u32 first = LocalIndex(bounds, start.x, start.y);
+    Relax(&q->grid, &q->heap, first, first, 0, Manhattan(start.x, start.y, goal.x, goal.y));
+    return true;
+}
+
+static SearchResult StepGridSearch(PathSearch *q, u32 *pops)
+{
+    const JumpGrid *grid  = &q->jump;
+    const TileRect bounds = grid->bounds;
+    const PathTile goal   = grid->goal;
+    const u32 bw          = bounds.x1 - bounds.x0;
+    const u32 target      = LocalIndex(bounds, goal.x, goal.y);
+    SearchState *st       = &q->grid;
+    PathHeap *heap        = &q->heap;
+
+    while (heap->count > 0)
+    {
+        if (*pops == 0) return SEARCH_RUNNING;
+        (*pops)--;
+
+        const HeapItem top = HeapPop(heap);
+        const u32 node     = top.node;
+        const int x        = (int)(bounds.x0 + node % bw);
+        const int y        = (int)(bounds.y0 + node / bw);
+        const u32 g        = st->g[node];
+
+        if (top.key != g + Manhattan(x, y, goal.x, goal.y)) continue;
+        if (node == target) return SEARCH_FOUND;
+
+        const u32 parent = st->parent[node];
+        const int dx     = Sign(x - (int)(bounds.x0 + parent % bw));
+        const int dy     = Sign(y - (int)(bounds.y0 + parent / bw));
+        int j;
+
+        #define JUMP_H(dir) if (JumpHorizontal(grid, x, y, (dir), &j)) \
+            Relax(st, heap, LocalIndex(bounds, j, y), node, g + (u32)abs(j - x), Manhattan(j, y, goal.x, goal.y))
+        #define JUMP_V(dir) if (JumpVertical(grid, x, y, (dir), &j)) \
+            Relax(st, heap, LocalIndex(bounds, x, j), node, g + (u32)abs(j - y), Manhattan(x, j, goal.x, goal.y))
+
+        if (dx != 0) {
+            JUMP_H(dx);
+            if (IsWalkable(grid, x, y + 1) && !IsWalkable(grid, x - dx, y + 1)) JUMP_V(1);
+            if (IsWalkable(grid, x, y - 1) && !IsWalkable(grid, x - dx, y - 1)) JUMP_V(-1);
+        }
+        else {
+            if (dy >= 0) JUMP_V(1);
+            if (dy <= 0) JUMP_V(-1);
+            JUMP_H(1);
+            JUMP_H(-1);
+        }
+
+        #undef JUMP_H
+        #undef JUMP_V
+    }
+
+    return SEARCH_FAILED;
+}
+
+// Appends the route of a finished grid search to out, sharing its first tile with a route already there
+static void AppendGridRoute(const PathSearch *q, Path *out)
+{
+    const TileRect bounds = q->jump.bounds;
+    const PathTile start  = q->legStart;
+    const PathTile goal   = q->jump.goal;
+    const SearchState *st = &q->grid;
+    const u32 bw          = bounds.x1 - bounds.x0;
+    const u32 first       = LocalIndex(bounds, start.x, start.y);
+    const u32 target      = LocalIndex(bounds, goal.x, goal.y);
+
+    // Jump points are joined by straight runs, filled in walking back from the goal
+    const bool joined = out->count > 0 && out->tiles[out->count - 1].x == start.x && out->tiles[out->count - 1].y == start.y;
+    const u32 base    = joined ? out->count - 1 : out->count;
+    const u32 length  = st->g[target];
+    ReservePath(out, base + length + 1);
+
+    u32 i    = base + length;
+    int cx   = goal.x;
+    int cy   = goal.y;
+    u32 node = target;
+    out->tiles[i] = goal;
+
+    while (node != first) {
+        const u32 parent = st->parent[node];
+        const int px     = (int)(bounds.x0 + parent % bw);
+        const int py     = (int)(bounds.y0 + parent / bw);
+        while (cx != px || cy != py) {
+            cx += Sign(px - cx);
+            cy += Sign(py - cy);
+            out->tiles[--i] = (PathTile){ cx, cy };
+        }
+        node = parent;
+    }
+
+    assert(i == base && "[ERROR] Path length does not match its cost");
+    out->count = base + length + 1;
+}
+
+static TileRect GetClusterRect(const PathService *s, const u32 index)
+{
+    const u32 x0 = (index % s->clustersX) << PATH_CLUSTER_SHIFT;
+    const u32 y0 = (index / s->clustersX) << PATH_CLUSTER_SHIFT;
+    return (TileRect){
+        .x0 = x0,
+        .y0 = y0,
+        .x1 = x0 + PATH_CLUSTER_TILES < s->width  ? x0 + PATH_CLUSTER_TILES : s->width,
+        .y1 = y0 + PATH_CLUSTER_TILES < s->height ? y0 + PATH_CLUSTER_TILES : s->height
+    };
+}
+
+static inline u32 GetClusterIndex(const PathService *s, const int x, const int y)
+{
+    return ((u32)y >> PATH_CLUSTER_SHIFT) * s->clustersX + ((u32)x >> PATH_CLUSTER_SHIFT);
+}
+
+// Open tiles of a cluster, one row per word with bit x for the tile at x0 + x
+static void GetClusterRows(const PathService *s, const TileRect rect, u32 *rows)
+{
+    const Collision *c = s->collision;
+    const u32 mask     = (1u << (rect.x1 - rect.x0)) - 1;
+    for (u32 y = rect.y0; y < rect.y1; y++) {
+        const u64 solid  = c->solid[y * c->wordsPerRow + (rect.x0 >> 6)] >> (rect.x0 & 63);
+        rows[y - rect.y0] = ~(u32)solid & mask;
+    }
+}
+
+// Steps from a tile to each target without leaving the cluster, PATH_NO_DIST when apart.
+// The search grows over whole rows at a time and stops once every target is reached.
+static void FindClusterSteps(const u32 *rows, const TileRect rect, const int fromX, const int fromY,
+                             const PathNode *targets, const u32 targetCount, u16 *outSteps)
+{
+    const u32 h = rect.y1 - rect.y0;
+    u32 seen[PATH_CLUSTER_TILES]     = {0};
+    u32 frontier[PATH_CLUSTER_TILES] = {0};
+
+    seen[fromY - (int)rect.y0] = frontier[fromY - (int)rect.y0] = 1u << (fromX - (int)rect.x0);
+
+    u32 remaining = 0;
+    for (u32 i = 0; i < targetCount; i++) {
+        const bool here = targets[i].x == fromX && targets[i].y == fromY;
+        outSteps[i]     = here ? 0 : PATH_NO_DIST;
+        remaining      += !here;
+    }
+
+    for (u16 step = 1; remaining > 0; step++)
+    {
+        u32 next[PATH_CLUSTER_TILES];
+        u32 grown = 0;
+
+        for (u32 y = 0; y < h; y++) {
+            const u32 reach = frontier[y] << 1 | frontier[y] >> 1 |
+                              (y > 0 ? frontier[y - 1] : 0) | (y + 1 < h ? frontier[y + 1] : 0);
+            next[y] = reach & rows[y] & ~seen[y];
+            grown  |= next[y];
+        }
+        if (grown == 0) break;
+
+        for (u32 y = 0; y < h; y++) {
+            seen[y]    |= next[y];
+            frontier[y] = next[y];
+        }
+
+        for (u32 i = 0; i < targetCount; i++) {
+            if (outSteps[i] != PATH_NO_DIST) continue;
+            if (!((next[targets[i].y - rect.y0] >> (targets[i].x - rect.x0)) & 1)) continue;
+            outSteps[i] = step;
+            remaining--;
+        }
+    }
+}
+
+static void AddNode(PathCluster *c, const int x, const int y)
+{
+    for (u32 i = 0; i < c->nodeCount; i++) {
+        if (c->nodes[i].x == x && c->nodes[i].y == y) return;
+    }
+    assert(c->nodeCount < PATH_CLUSTER_NODES && "[ERROR] Too many entrances in a path cluster");
+    c->nodes[c->nodeCount++] = (PathNode){ (u16)x, (u16)y };
+}
+
+// Walks one side of the cluster from (x, y) along (stepX, stepY); (outX, outY) points
+// across the border. Both clusters of a border walk it the same way and agree on its entrances.
+static void AddSideEntrances(const PathService *s, PathCluster *c, const int x, const int y,
+                             const int stepX, const int stepY, const u32 length, const int outX, const int outY)
+{
+    u32 runStart = 0;
+    bool inRun   = false;
+
+    for (u32 i = 0; i <= length; i++)
+    {
+        const int tx    = x + stepX * (int)i;
+        const int ty    = y + stepY * (int)i;
+        const bool open = i < length && IsOpenTile(s, tx, ty) && IsOpenTile(s, tx + outX, ty + outY);
+
+        if (open && !inRun) {
+            runStart = i;
+            inRun    = true;
+        }
+        if (open || !inRun) continue;
+
+        const u32 run = i - runStart;
+        if (run < PATH_LONG_ENTRANCE) {
+            AddNode(c, x + stepX * (int)(runStart + run / 2), y + stepY * (int)(runStart + run / 2));
+        }
+        else {
+            AddNode(c, x + stepX * (int)runStart, y + stepY * (int)runStart);
+            AddNode(c, x + stepX * (int)(i - 1),  y + stepY * (int)(i - 1));
+        }
+        inRun = false;
+    }
+}
+
+static void BuildCluster(PathService *s, const u32 index)
+{
+    PathCluster *c   = &s->clusters[index];
+    const TileRect r = GetClusterRect(s, index);
+    const u32 w      = r.x1 - r.x0;
+    const u32 h      = r.y1 - r.y0;
+
+    c->nodeCount = 0;
+    c->dirty     = false;
+
+    if (r.y0 > 0)         AddSideEntrances(s, c, (int)r.x0, (int)r.y0,     1, 0, w, 0, -1);
+    if (r.y1 < s->height) AddSideEntrances(s, c, (int)r.x0, (int)r.y1 - 1, 1, 0, w, 0,  1);
+    if (r.x0 > 0)         AddSideEntrances(s, c, (int)r.x0,     (int)r.y0, 0, 1, h, -1, 0);
+    if (r.x1 < s->width)  AddSideEntrances(s, c, (int)r.x1 - 1, (int)r.y0, 0, 1, h,  1, 0);
+
+    s->stats.clusterRebuilds++;
+    free(c->dist);
+    c->dist = NULL;
+    if (c->nodeCount == 0) return;
+
+    const u32 n = c->nodeCount;
+    c->dist     = malloc(n * n * sizeof(u16));
+    assert(c->dist && "[ERROR] Failed to alloc path cluster distances");
+
+    u32 rows[PATH_CLUSTER_TILES];
+    GetClusterRows(s, r, rows);
+    for (u32 i = 0; i < n; i++) FindClusterSteps(rows, r, c->nodes[i].x, c->nodes[i].y, c->nodes, n, &c->dist[i * n]);
+}
+
+// Clusters are built the first time a search reaches them, and again after an edit
+static const PathCluster *GetCluster(PathService *s, const u32 index, u32 *pops)
+{
+    PathCluster *c = &s->clusters[index];
+    if (c->dirty) {
+        BuildCluster(s, index);
+        Spend(pops, PATH_BUILD_POPS);
+    }
+    return c;
+}
+
+static inline PathTile GetNodeTile(const PathService *s, const u32 node, const PathTile start, const PathTile goal)
+{
+    const u32 startNode = s->clustersX * s->clustersY * PATH_CLUSTER_NODES;
+    if (node == startNode)     return start;
+    if (node == startNode + 1) return goal;
+
+    const PathNode *n = &s->clusters[node / PATH_CLUSTER_NODES].nodes[node % PATH_CLUSTER_NODES];
+    return (PathTile){ n->x, n->y };
+}
+
+// A* over the entrance graph with start and goal joined to the nodes of their clusters
+static void BeginGraphSearch(PathService *s, PathSearch *q, u32 *pops)
+{
+    const PathTile start   = q->start;
+    const PathTile goal    = q->goal;
+    const u32 startNode    = s->clustersX * s->clustersY * PATH_CLUSTER_NODES;
+    q->startIndex          = GetClusterIndex(s, start.x, start.y);
+    q->goalIndex           = GetClusterIndex(s, goal.x, goal.y);
+    const TileRect startRect = GetClusterRect(s, q->startIndex);
+    const TileRect goalRect  = GetClusterRect(s, q->goalIndex);
+
+    // Steps from start to the nodes of its cluster and the goal, and from the goal to its cluster's nodes
+    const PathCluster *sc = GetCluster(s, q->startIndex, pops);
+    const PathCluster *gc = GetCluster(s, q->goalIndex, pops);
+    PathNode targets[PATH_CLUSTER_NODES + 1];
+    u32 rows[PATH_CLUSTER_TILES];
+
+    memcpy(targets, sc->nodes, sc->nodeCount * sizeof(PathNode));
+    targets[sc->nodeCount] = (PathNode){ (u16)goal.x, (u16)goal.y };
+    GetClusterRows(s, startRect, rows);
+    FindClusterSteps(rows, startRect, start.x, start.y, targets, sc->nodeCount + (q->startIndex == q->goalIndex), q->startSteps);
+
+    GetClusterRows(s, goalRect, rows);
+    FindClusterSteps(rows, goalRect, goal.x, goal.y, gc->nodes, gc->nodeCount, q->goalSteps);
+
+    BeginSearch(&q->graph, startNode + 2);
+    q->heap.count = 0;
+    Relax(&q->graph, &q->heap, startNode, startNode, 0, Manhattan(start.x, start.y, goal.x, goal.y));
+}
+
+static SearchResult StepGraphSearch(PathService *s, PathSearch *q, u32 *pops)
+{
+    const PathTile start  = q->start;
+    const PathTile goal   = q->goal;
+    const u32 startNode   = s->clustersX * s->clustersY * PATH_CLUSTER_NODES;
+    const u32 goalNode    = startNode + 1;
+    const u32 startIndex  = q->startIndex;
+    const u32 goalIndex   = q->goalIndex;
+    const PathCluster *sc = &s->clusters[startIndex];
+    SearchState *st       = &q->graph;
+    PathHeap *heap        = &q->heap;
+
+    #define HEURISTIC(t)     Manhattan((t).x, (t).y, goal.x, goal.y)
+
+    while (heap->count > 0)
+    {
+        if (*pops == 0) return SEARCH_RUNNING;
+        (*pops)--;
+
+        const HeapItem top  = HeapPop(heap);
+        const u32 node      = top.node;
+        const u32 g         = st->g[node];
+        const PathTile tile = GetNodeTile(s, node, start, goal);
+
+        if (top.key != g + HEURISTIC(tile)) continue;
+        if (node == goalNode) return SEARCH_FOUND;
+
+        if (node == startNode) {
+            for (u32 i = 0; i < sc->nodeCount; i++) {
+                if (q->startSteps[i] == PATH_NO_DIST) continue;
+                const PathTile t = { sc->nodes[i].x, sc->nodes[i].y };
+                Relax(st, heap, startIndex * PATH_CLUSTER_NODES + i, node, q->startSteps[i], HEURISTIC(t));
+            }
+            if (startIndex == goalIndex && q->startSteps[sc->nodeCount] != PATH_NO_DIST)
+                Relax(st, heap, goalNode, node, q->startSteps[sc->nodeCount], 0);
+            continue;
+        }
+
+        const u32 index      = node / PATH_CLUSTER_NODES;
+        const u32 local      = node % PATH_CLUSTER_NODES;
+        const PathCluster *c = &s->clusters[index];
+
+        for (u32 j = 0; j < c->nodeCount; j++) {
+            const u16 d = c->dist[local * c->nodeCount + j];
+            if (j == local || d == PATH_NO_DIST) continue;
+            const PathTile t = { c->nodes[j].x, c->nodes[j].y };
+            Relax(st, heap, index * PATH_CLUSTER_NODES + j, node, g + d, HEURISTIC(t));
+        }
+
+        // The entrance's partner across each border it sits on
+        const int dirs[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+        for (u32 k = 0; k < 4; k++)
+        {
+            const int nx = tile.x + dirs[k][0];
+            const int ny = tile.y + dirs[k][1];
+            if ((u32)nx >= s->width || (u32)ny >= s->height) continue;
+
+            const u32 other = GetClusterIndex(s, nx, ny);
+            if (other == index) continue;
+
+            const PathCluster *oc = GetCluster(s, other, pops);
+            for (u32 j = 0; j < oc->nodeCount; j++) {
+                if (oc->nodes[j].x != nx || oc->nodes[j].y != ny) continue;
+                Relax(st, heap, other * PATH_CLUSTER_NODES + j, node, g + 1, HEURISTIC(((PathTile){ nx, ny })));
+                break;
+            }
+        }
+
+        if (index == goalIndex && q->goalSteps[local] != PATH_NO_DIST) Relax(st, heap, goalNode, node, g + q->goalSteps[local], 0);
+    }
+
+    #undef HEURISTIC
+
+    return SEARCH_FAILED;
+}
+
+static void BuildChain(const PathService *s, PathSearch *q)
+{
+    const u32 startNode = s->clustersX * s->clustersY * PATH_CLUSTER_NODES;
+
+    u32 chainCount = 0;
+    for (u32 node = startNode + 1; ; node = q->graph.parent[node])
+    {
+        if (chainCount >= q->chainCapacity) {
+            q->chainCapacity = q->chainCapacity == 0 ? 64 : q->chainCapacity * 2;
+            u32 *tmp         = realloc(q->chain, q->chainCapacity * sizeof(u32));
+            assert(tmp && "[ERROR] Failed to realloc path chain");
+            q->chain = tmp;
+        }
+        q->chain[chainCount++] = node;
+        if (node == startNode) break;
+    }
+
+    q->chainNext = chainCount - 1;
+    q->legActive = false;
+}
+
+// Each leg of the graph route refined on the grid inside its cluster
+static SearchResult StepRefine(PathService *s, PathSearch *q, Path *out, u32 *pops)
+{
+    while (q->chainNext > 0)
+    {
+        if (!q->legActive)
+        {
+            const PathTile a = GetNodeTile(s, q->chain[q->chainNext], q->start, q->goal);
+            const PathTile b = GetNodeTile(s, q->chain[q->chainNext - 1], q->start, q->goal);
+            const u32 ca     = GetClusterIndex(s, a.x, a.y);
+            const u32 cb     = GetClusterIndex(s, b.x, b.y);
+
+            if (ca != cb) {
+                // A step across a border
+                if (out->count == 0) {
+                    ReservePath(out, 1);
+                    out->tiles[out->count++] = a;
+                }
+                ReservePath(out, out->count + 1);
+                out->tiles[out->count++] = b;
+                q->chainNext--;
+                continue;
+            }
+
+            const bool open = BeginGridSearch(q, s->collision, GetClusterRect(s, ca), a, b);
+            assert(open && "[ERROR] Cluster graph and grid disagree");
+            (void)open;
+            q->legActive = true;
+        }
+
+        const SearchResult result = StepGridSearch(q, pops);
+        if (result == SEARCH_RUNNING) return result;
+        assert(result == SEARCH_FOUND && "[ERROR] Cluster graph and grid disagree");
+
+        AppendGridRoute(q, out);
+        q->legActive = false;
+        q->chainNext--;
+    }
+
+    return SEARCH_FOUND;
+}
+
+static void StartGraphPhase(PathService *s, PathSearch *q, u32 *pops)
+{
+    s->stats.clusterSearches++;
+    BeginGraphSearch(s, q, pops);
+    q->phase = PHASE_GRAPH;
+}
+
+static void BeginPathSearch(PathSearch *q, const PathTile start, const PathTile goal)
+{
+    q->start = start;
+    q->goal  = goal;
+    q->phase = PHASE_START;
+}
+
+// Runs q for about *pops heap pops; out holds the route once it returns SEARCH_FOUND
+static SearchResult RunSearch(PathService *s, PathSearch *q, Path *out, u32 *pops)
+{
+    const PathTile start = q->start;
+    const PathTile goal  = q->goal;
+
+    for (;;)
+    {
+        switch (q->phase)
+        {
+            case PHASE_START: {
+                out->count  = 0;
+                q->revision = s->revision;
+                if (!IsOpenTile(s, start.x, start.y) || !IsOpenTile(s, goal.x, goal.y)) return SEARCH_FAILED;
+
+                // Close goals are usually reached without leaving the box around them
+                if (Manhattan(start.x, start.y, goal.x, goal.y) <= PATH_DIRECT_TILES)
+                {
+                    const int margin   = (int)PATH_CLUSTER_TILES;
+                    const int x0       = (start.x < goal.x ? start.x : goal.x) - margin;
+                    const int y0       = (start.y < goal.y ? start.y : goal.y) - margin;
+                    const int x1       = (start.x > goal.x ? start.x : goal.x) + margin + 1;
+                    const int y1       = (start.y > goal.y ? start.y : goal.y) + margin + 1;
+                    const TileRect box = {
+                        .x0 = x0 < 0 ? 0 : (u32)x0,
+                        .y0 = y0 < 0 ? 0 : (u32)y0,
+                        .x1 = (u32)x1 > s->width  ? s->width  : (u32)x1,
+                        .y1 = (u32)y1 > s->height ? s->height : (u32)y1
+                    };
+
+                    s->stats.directSearches++;
+                    if (BeginGridSearch(q, s->collision, box, start, goal)) {
+                        q->phase = PHASE_DIRECT;
+                        break;
+                    }
+                }
+
+                StartGraphPhase(s, q, pops);
+                break;
+            }
+
+            case PHASE_DIRECT: {
+                const SearchResult result = StepGridSearch(q, pops);
+                if (result == SEARCH_RUNNING) return result;
+                if (result == SEARCH_FOUND) {
+                    AppendGridRoute(q, out);
+                    return result;
+                }
+                StartGraphPhase(s, q, pops);
+                break;
+            }
+
+            case PHASE_GRAPH: {
+                const SearchResult result = StepGraphSearch(s, q, pops);
+                if (result != SEARCH_FOUND) return result;
+                BuildChain(s, q);
+                q->phase = PHASE_REFINE;
+                break;
+            }
+
+            case PHASE_REFINE: return StepRefine(s, q, out, pops);
+        }
+    }
+}
+
+static void FreePathSearch(PathSearch *q)
+{
+    SearchState *states[2] = { &q->grid, &q->graph };
+    for (u32 i = 0; i < 2; i++) {
+        free(states[i]->g);
+        free(states[i]->parent);
+        free(states[i]->stamp);
+    }
+
+    free(q->heap.items);
+    free(q->chain);
+}
+
+PathService *CreatePathService(const Collision *collision)
+{
+    TRACE_ZONE("CreatePathService");
+    assert(collision && "[ERROR] Collision is NULL");
+
+    PathService *s = calloc(1, sizeof(PathService));
+    assert(s && "[ERROR] Failed to alloc path service");
+
+    s->collision  = collision;
+    s->width      = collision->width;
+    s->height     = collision->height;
+    s->clustersX  = (s->width  + PATH_CLUSTER_TILES - 1) >> PATH_CLUSTER_SHIFT;
+    s->clustersY  = (s->height + PATH_CLUSTER_TILES - 1) >> PATH_CLUSTER_SHIFT;
+    s->clusters   = calloc((size_t)s->clustersX * s->clustersY + 1, sizeof(PathCluster));
+    assert(s->clusters && "[ERROR] Failed to alloc path clusters");
+
+    // Clusters are built by the searches that reach them, so creating the service is cheap
+    InvalidatePathRegion(s, (TileRect){ 0, 0, s->width, s->height });
+    return s;
+}
+
+void DestroyPathService(PathService *service)
+{
+    if (!service) return;
+
+    for (u32 i = 0; i < service->clustersX * service->clustersY; i++) free(service->clusters[i].dist);
+    for (u32 i = 0; i < PATH_MAX_REQUESTS; i++) FreePath(&service->slots[i].path);
+
+    FreePathSearch(&service->direct);
+    FreePathSearch(&service->queued);
+    free(service->clusters);
+    free(service);
+}
+
+void InvalidatePathRegion(PathService *service, TileRect region)
+{
+    assert(service && "[ERROR] Path service is NULL");
+
+    // Entrances depend on the tiles on both sides of a border
+    region.x0 = region.x0 > 0 ? region.x0 - 1 : 0;
+    region.y0 = region.y0 > 0 ? region.y0 - 1 : 0;
+    region.x1 = region.x1 + 1 < service->width  ? region.x1 + 1 : service->width;
+    region.y1 = region.y1 + 1 < service->height ? region.y1 + 1 : service->height;
+    if (region.x0 >= region.x1 || region.y0 >= region.y1) return;
+    service->revision++;
+
+    for (u32 cy = region.y0 >> PATH_CLUSTER_SHIFT; cy <= (region.y1 - 1) >> PATH_CLUSTER_SHIFT; cy++) {
+        for (u32 cx = region.x0 >> PATH_CLUSTER_SHIFT; cx <= (region.x1 - 1) >> PATH_CLUSTER_SHIFT; cx++)
+        {
+            service->clusters[cy * service->clustersX + cx].dirty = true;
+        }
+    }
+}
+
+bool FindPath(PathService *service, const PathTile start, const PathTile goal, Path *out)
+{
+    TRACE_ZONE("FindPath");
+    assert(service && out && "[ERROR] Path service or path is NULL");
+
+    u32 pops = UINT32_MAX;
+    BeginPathSearch(&service->direct, start, goal);
+    if (RunSearch(service, &service->direct, out, &pops) == SEARCH_FOUND) return true;
+
+    out->count = 0;
+    return false;
+}
+
+void FreePath(Path *path)
+{
+    free(path->tiles);
+    *path = (Path){0};
+}
+
+PathRequest RequestPath(PathService *service, const PathTile start, const PathTile goal)
+{
+    assert(service && "[ERROR] Path service is NULL");
+    if (service->queueCount >= PATH_MAX_REQUESTS) return 0;
+
+    for (u32 n = 0; n < PATH_MAX_REQUESTS; n++)
+    {
+        const u32 index = (service->nextSlot + n) & (PATH_MAX_REQUESTS - 1);
+        PathSlot *slot  = &service->slots[index];
+        if (slot->status != PATH_NONE) continue;
+
+        // The high bits count the slot's uses, so an old handle never matches a new request
+        const u32 uses = (slot->id >> PATH_REQUEST_SHIFT) + 1;
+        slot->id       = (uses << PATH_REQUEST_SHIFT) | index;
+        slot->start    = start;
+        slot->goal     = goal;
+        slot->status   = PATH_PENDING;
+
+        service->queue[(service->queueHead + service->queueCount++) & (PATH_MAX_REQUESTS - 1)] = (u16)index;
+        service->nextSlot = index + 1;
+        return slot->id;
+    }
+
+    return 0;
+}
+
+void UpdatePathService(PathService *service, const u64 budgetMicros)
+{
+    if (!service || service->queueCount == 0) return;
+    TRACE_ZONE("UpdatePathService");
+
+    PathSearch *q   = &service->queued;
+    const u64 start = GetMonotonicMicros();
+    while (service->queueCount > 0)
+    {
+        PathSlot *slot = &service->slots[service->queue[service->queueHead]];
+
+        // An edit since the search began may have moved the walls or entrances it went by
+        if (!service->queuedActive || q->revision != service->revision) {
+            BeginPathSearch(q, slot->start, slot->goal);
+            service->queuedActive = true;
+        }
+
+        u32 pops = PATH_SLICE_POPS;
+        const SearchResult result = RunSearch(service, q, &slot->path, &pops);
+        if (result != SEARCH_RUNNING) {
+            slot->status = result == SEARCH_FOUND ? PATH_FOUND : PATH_UNREACHABLE;
+            if (result != SEARCH_FOUND) slot->path.count = 0;
+
+            service->queueHead    = (service->queueHead + 1) & (PATH_MAX_REQUESTS - 1);
+            service->queueCount--;
+            service->queuedActive = false;
+        }
+
+        if (GetMonotonicMicros() - start >= budgetMicros) break;
+    }
+}
+
+static PathSlot *GetSlot(PathService *service, const PathRequest request)
+{
+    PathSlot *slot = &service->slots[request & (PATH_MAX_REQUESTS - 1)];
+    return request != 0 && slot->id == request ? slot : NULL;
+}
+
+PathStatus CollectPath(PathService *service, const PathRequest request, Path *out)
+{
+    PathSlot *slot = GetSlot(service, request);
+    if (!slot) return PATH_NONE;
+
+    const PathStatus status = slot->status;
+    if (status != PATH_FOUND && status != PATH_UNREACHABLE) return status;
+
+    // Swapping keeps both allocations alive for reuse
+    const Path mine = slot->path;
+    slot->path      = *out;
+    slot->path.count = 0;
+    *out            = mine;
+    slot->status    = PATH_NONE;
+    return status;
+}
+
+void CancelPath(PathService *service, const PathRequest request)
+{
+    PathSlot *slot = GetSlot(service, request);
+    if (!slot) return;
+
+    // A pending request gives its place in the queue back too
+    if (slot->status == PATH_PENDING) {
+        const u32 mask  = PATH_MAX_REQUESTS - 1;
+        const u32 index = request & mask;
+
+        u32 i = 0;
+        while (service->queue[(service->queueHead + i) & mask] != index) i++;
+        if (i == 0) service->queuedActive = false;
+
+        for (; i + 1 < service->queueCount; i++)
+            service->queue[(service->queueHead + i) & mask] = service->queue[(service->queueHead + i + 1) & mask];
+        service->queueCount--;
+    }
+    slot->status = PATH_NONE;
+}
+
+PathServiceStats GetPathServiceStats(const PathService *service)
+{
+    PathServiceStats stats = service->stats;
+    stats.clusters = service->clustersX * service->clustersY;
+    stats.nodes    = 0;
+    for (u32 i = 0; i < stats.clusters; i++) stats.nodes += service->clusters[i].nodeCount;
+    stats.pending  = service->queueCount;
+    return stats;
+}
\ No newline at end of file
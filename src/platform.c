@@ -0,0 +1,273 @@
+#include "ivy/platform.h"
+#include "ivy/trace.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <pthread.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+bool MapFile(const char *path, MappedFile *out)
+{
+    *out = (MappedFile){0};
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return false;
+
+    const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    out->data   = view;
+    out->size   = (u64)size.QuadPart;
+    out->handle = mapping;
+    return true;
+}
+
+void UnmapFile(MappedFile *file)
+{
+    if (!file || !file->data) return;
+
+    UnmapViewOfFile(file->data);
+    CloseHandle((HANDLE)file->handle);
+    *file = (MappedFile){0};
+}
+
+typedef struct {
+    ThreadFunc  func;
+    void       *arg;
+} ThreadStart;
+
+static DWORD WINAPI ThreadEntry(LPVOID param)
+{
+    ThreadStart start = *(ThreadStart *)param;
+    free(param);
+    start.func(start.arg);
+    TRACE_THREAD_EXIT();
+    return 0;
+}
+
+bool StartThread(Thread *thread, const ThreadFunc func, void *arg)
+{
+    ThreadStart *start = malloc(sizeof(ThreadStart));
+    assert(start && "[ERROR] Failed to alloc ThreadStart");
+    *start = (ThreadStart){ func, arg };
+
+    thread->handle = CreateThread(NULL, 0, ThreadEntry, start, 0, NULL);
+    if (!thread->handle) {
+        free(start);
+        return false;
+    }
+    return true;
+}
+
+void JoinThread(Thread *thread)
+{
+    if (!thread->handle) return;
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+    thread->handle = NULL;
+}
+
+u32 GetCpuCount(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (u32)info.dwNumberOfProcessors : 1;
+}
+
+u64 GetMonotonicMicros(void)
+{
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (u64)(now.QuadPart / frequency.QuadPart) * 1000000u +
+           (u64)(now.QuadPart % frequency.QuadPart) * 1000000u / (u64)frequency.QuadPart;
+}
+
+void InitSemaphore(Semaphore *sem, const u32 initialCount)
+{
+    sem->handle = CreateSemaphoreA(NULL, (LONG)initialCount, 0x7fffffff, NULL);
+    assert(sem->handle && "[ERROR] Failed to create semaphore");
+}
+
+void DestroySemaphore(Semaphore *sem)
+{
+    if (!sem->handle) return;
+    CloseHandle((HANDLE)sem->handle);
+    sem->handle = NULL;
+}
+
+void SignalSemaphore(Semaphore *sem, const u32 count)
+{
+    ReleaseSemaphore((HANDLE)sem->handle, (LONG)count, NULL);
+}
+
+void WaitSemaphore(Semaphore *sem)
+{
+    WaitForSingleObject((HANDLE)sem->handle, INFINITE);
+}
+
+#else
+
+bool MapFile(const char *path, MappedFile *out)
+{
+    *out = (MappedFile){0};
+
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void *view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+
+    out->data = view;
+    out->size = (u64)st.st_size;
+    return true;
+}
+
+void UnmapFile(MappedFile *file)
+{
+    if (!file || !file->data) return;
+
+    munmap((void *)file->data, (size_t)file->size);
+    *file = (MappedFile){0};
+}
+
+typedef struct {
+    ThreadFunc  func;
+    void       *arg;
+} ThreadStart;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    u32             count;
+} PosixSemaphore;
+
+static void *ThreadEntry(void *param)
+{
+    ThreadStart start = *(ThreadStart *)param;
+    free(param);
+    start.func(start.arg);
+    TRACE_THREAD_EXIT();
+    return NULL;
+}
+
+bool StartThread(Thread *thread, const ThreadFunc func, void *arg)
+{
+    ThreadStart *start = malloc(sizeof(ThreadStart));
+    pthread_t   *handle = malloc(sizeof(pthread_t));
+    assert(start && handle && "[ERROR] Failed to alloc thread");
+    *start = (ThreadStart){ func, arg };
+
+    if (pthread_create(handle, NULL, ThreadEntry, start) != 0) {
+        free(start);
+        free(handle);
+        thread->handle = NULL;
+        return false;
+    }
+
+    thread->handle = handle;
+    return true;
+}
+
+void JoinThread(Thread *thread)
+{
+    if (!thread->handle) return;
+    pthread_join(*(pthread_t *)thread->handle, NULL);
+    free(thread->handle);
+    thread->handle = NULL;
+}
+
+u32 GetCpuCount(void)
+{
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (u32)count : 1;
+}
+
+u64 GetMonotonicMicros(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000u + (u64)ts.tv_nsec / 1000u;
+}
+
+void InitSemaphore(Semaphore *sem, const u32 initialCount)
+{
+    PosixSemaphore *s = malloc(sizeof(PosixSemaphore));
+    assert(s && "[ERROR] Failed to alloc semaphore");
+
+    pthread_mutex_init(&s->mutex, NULL);
+    pthread_cond_init(&s->cond, NULL);
+    s->count    = initialCount;
+    sem->handle = s;
+}
+
+void DestroySemaphore(Semaphore *sem)
+{
+    PosixSemaphore *s = sem->handle;
+    if (!s) return;
+
+    pthread_cond_destroy(&s->cond);
+    pthread_mutex_destroy(&s->mutex);
+    free(s);
+    sem->handle = NULL;
+}
+
+void SignalSemaphore(Semaphore *sem, const u32 count)
+{
+    PosixSemaphore *s = sem->handle;
+
+    pthread_mutex_lock(&s->mutex);
+    s->count += count;
+    if (count == 1) pthread_cond_signal(&s->cond);
+    else            pthread_cond_broadcast(&s->cond);
+    pthread_mutex_unlock(&s->mutex);
+}
+
+void WaitSemaphore(Semaphore *sem)
+{
+    PosixSemaphore *s = sem->handle;
+
+    pthread_mutex_lock(&s->mutex);
+    while (s->count == 0)
+        pthread_cond_wait(&s->cond, &s->mutex);
+    s->count--;
+    pthread_mutex_unlock(&s->mutex);
+}
+
+#endif
\ No newline at end of file
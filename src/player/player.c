@@ -1,5 +1,6 @@
 #include "ivy/player/player.h"
 #include "ivy/utils.h"
+#include "ivy/texture_registry.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -17,15 +18,15 @@ Player *InitPlayer(const u32 spawnX, const u32 spawnY, const u32 tileSize)
     assert(player && "[ERROR] Failed to allocate memory for Player!");
 
     PlayerGraphics *g = &player->graphics;
-    g->hairTexture    = LoadTextureFromImageBin("assets/player/character/base/base_equip_hair.bin");
-    g->headTexture    = LoadTextureFromImageBin("assets/player/character/base/base_equip_head.bin");
-    g->bodyTexture    = LoadTextureFromImageBin("assets/player/character/base/base_equip_body.bin");
+    AcquireTextureRegion("assets/player/character/base/base_equip_hair.bin", &g->hairSprite);
+    AcquireTextureRegion("assets/player/character/base/base_equip_head.bin", &g->headSprite);
+    AcquireTextureRegion("assets/player/character/base/base_equip_body.bin", &g->bodySprite);
 
-    g->headPortrait   = LoadTextureFromImageBin("assets/player/character/base/base_portrait_head.bin");
-    g->bodyPortrait   = LoadTextureFromImageBin("assets/player/character/base/base_portrait_body.bin");
-    g->hairPortrait   = LoadTextureFromImageBin("assets/player/character/base/base_portrait_hair.bin");
-    g->eyesPortrait   = LoadTextureFromImageBin("assets/player/character/base/base_portrait_eyes.bin");
-    g->mouthPortrait  = LoadTextureFromImageBin("assets/player/character/base/base_portrait_mouth.bin");
+    AcquireTexture("assets/player/character/base/base_portrait_head.bin",   TEXTURE_FILE_IMAGE_BIN, &g->headPortrait);
+    AcquireTexture("assets/player/character/base/base_portrait_body.bin",   TEXTURE_FILE_IMAGE_BIN, &g->bodyPortrait);
+    AcquireTexture("assets/player/character/base/base_portrait_hair.bin",   TEXTURE_FILE_IMAGE_BIN, &g->hairPortrait);
+    AcquireTexture("assets/player/character/base/base_portrait_eyes.bin",   TEXTURE_FILE_IMAGE_BIN, &g->eyesPortrait);
+    AcquireTexture("assets/player/character/base/base_portrait_mouth.bin",  TEXTURE_FILE_IMAGE_BIN, &g->mouthPortrait);
 
     g->action    = ACTION_IDLE;
     g->direction = DIRECTION_FRONT;
@@ -51,6 +52,23 @@ Player *InitPlayer(const u32 spawnX, const u32 spawnY, const u32 tileSize)
     return player;
 }
 
+void PlacePlayer(Player *player, const u32 tileX, const u32 tileY, const u32 tileSize)
+{
+    const float ts   = (float)tileSize;
+    const float half = ts * 0.5f;
+
+    PlayerMovement *m     = &player->movement;
+    m->tilePosition       = (Vector2){ (float)tileX, (float)tileY };
+    m->targetTilePosition = m->tilePosition;
+    m->position           = (Vector2){ (float)tileX * ts + half, (float)tileY * ts + half };
+    m->moveTimer          = 0.0f;
+    m->dirInputCount      = 0;
+    m->isMoving           = false;
+
+    player->graphics.action = ACTION_IDLE;
+    UpdatePlayerCollision(player);
+}
+
 void UpdatePlayer(Player *player, const float frameTime,
                   const Collision *collision, const u32 tileSize)
 {
@@ -85,7 +103,10 @@ void DrawPlayer(const Player *player, const VirtualResolution *vr)
 
     const Vector2 origin = { PLAYER_FRAME_SIZE * 0.5f, PLAYER_FRAME_SIZE * 0.75f };
 
-    DrawTexturePro(player->graphics.bodyTexture, src, dst, origin, 0.0f, WHITE);
+    const PlayerGraphics *g = &player->graphics;
+
+    // Sheets live on a shared atlas page, so the whole stack is one batch
+    DrawTexturePro(g->bodySprite.texture, GetRegionSubRect(&g->bodySprite, src), dst, origin, 0.0f, WHITE);
 
     const EquipmentSlot drawOrder[] = {
         SLOT_BOT, SLOT_MID, SLOT_MID_EXT,
@@ -100,18 +121,22 @@ void DrawPlayer(const Player *player, const VirtualResolution *vr)
 
         const Item *item = player->equipment.slots[slot];
         if (!item || item->type != ITEM_EQUIPMENT) continue;
-        if (item->data.equipment.charTexture.id == 0) continue;
 
-        DrawTexturePro(item->data.equipment.charTexture, src, dst, origin, 0.0f, WHITE);
+        const TextureRegion *sprite = &item->data.equipment.sprite;
+        if (sprite->texture.id == 0) continue;
+
+        DrawTexturePro(sprite->texture, GetRegionSubRect(sprite, src), dst, origin, 0.0f, WHITE);
     }
 
-    DrawTexturePro(player->graphics.headTexture, src, dst, origin, 0.0f, WHITE);
-    DrawTexturePro(player->graphics.hairTexture, src, dst, origin, 0.0f, WHITE);
+    DrawTexturePro(g->headSprite.texture, GetRegionSubRect(&g->headSprite, src), dst, origin, 0.0f, WHITE);
+    DrawTexturePro(g->hairSprite.texture, GetRegionSubRect(&g->hairSprite, src), dst, origin, 0.0f, WHITE);
 
     if (player->equipment.slotMask & (1u << SLOT_HEAD)) {
         const Item *item = player->equipment.slots[SLOT_HEAD];
-        if (item && item->type == ITEM_EQUIPMENT && item->data.equipment.charTexture.id != 0)
-            DrawTexturePro(item->data.equipment.charTexture, src, dst, origin, 0.0f, WHITE);
+        if (item && item->type == ITEM_EQUIPMENT && item->data.equipment.sprite.texture.id != 0) {
+            const TextureRegion *sprite = &item->data.equipment.sprite;
+            DrawTexturePro(sprite->texture, GetRegionSubRect(sprite, src), dst, origin, 0.0f, WHITE);
+        }
     }
 }
 
@@ -138,14 +163,14 @@ void DestroyPlayer(Player *player)
     if (!player) return;
 
     PlayerGraphics *g = &player->graphics;
-    UnloadTexture(g->hairTexture);
-    UnloadTexture(g->headTexture);
-    UnloadTexture(g->bodyTexture);
-    UnloadTexture(g->headPortrait);
-    UnloadTexture(g->bodyPortrait);
-    UnloadTexture(g->hairPortrait);
-    UnloadTexture(g->eyesPortrait);
-    UnloadTexture(g->mouthPortrait);
+    ReleaseTextureRegion(&g->hairSprite);
+    ReleaseTextureRegion(&g->headSprite);
+    ReleaseTextureRegion(&g->bodySprite);
+    ReleaseTexture(&g->headPortrait);
+    ReleaseTexture(&g->bodyPortrait);
+    ReleaseTexture(&g->hairPortrait);
+    ReleaseTexture(&g->eyesPortrait);
+    ReleaseTexture(&g->mouthPortrait);
 
     DestroyInventory(player->inventory);
     DestroyPortrait(&player->portrait);
@@ -1,17 +1,22 @@
 #include "ivy/player/player.h"
 
 u32 GetSpriteRow(const Player *player)
+{
+    return GetActionSpriteRow(player->graphics.action, player->graphics.direction);
+}
+
+u32 GetActionSpriteRow(const PlayerAction action, const Direction direction)
 {
     u32 baseRow = 0;
 
-    switch (player->graphics.action)
+    switch (action)
     {
         case ACTION_WALK: baseRow = 0; break;
         case ACTION_RUN:  baseRow = 4; break;
         case ACTION_IDLE: baseRow = 0; break;
     }
 
-    switch (player->graphics.direction)
+    switch (direction)
     {
         case DIRECTION_FRONT: return baseRow + 0;
         case DIRECTION_LEFT:  return baseRow + 1;
@@ -78,20 +83,9 @@ bool GetMovementInput(Vector2 *outDir, Direction *outFacing)
     return false;
 }
 
-bool IsTileSolid(const Vector2 tilePos, const Collision *collision, const u32 tileSize)
+bool IsTileSolid(const Vector2 tilePos, const Collision *collision)
 {
-    const float ts = (float)tileSize;
-    const Vector2 worldCenter = {
-        tilePos.x * ts + ts * 0.5f,
-        tilePos.y * ts + ts * 0.5f
-    };
-
-    for (u32 i = 0; i < collision->rectCount; i++) {
-        if (CheckCollisionPointRec(worldCenter, collision->rect[i]))
-            return true;
-    }
-
-    return false;
+    return IsCollisionTileSolid(collision, (int)tilePos.x, (int)tilePos.y);
 }
 
 float GetMoveDuration(const PlayerAction action)
@@ -105,7 +99,7 @@ float GetMoveDuration(const PlayerAction action)
 }
 
 bool StartMoving(Player *player, const Vector2 inputDir, const Direction nextDir, const bool isRunning,
-                 const Collision *collision, const u32 tileSize)
+                 const Collision *collision)
 {
     const Vector2 target = {
         player->movement.tilePosition.x + inputDir.x,
@@ -114,7 +108,7 @@ bool StartMoving(Player *player, const Vector2 inputDir, const Direction nextDir
 
     player->graphics.direction = nextDir;
 
-    if (IsTileSolid(target, collision, tileSize)) {
+    if (IsTileSolid(target, collision)) {
         player->graphics.action = ACTION_IDLE;
         return false;
     }
@@ -171,7 +165,7 @@ void UpdatePlayerMovement(Player *player, const float frameTime,
                 {
                     player->movement.dirInputCount  = 0;
                     player->movement.justTurned     = false;
-                    StartMoving(player, inputDir, nextDir, isShift, collision, tileSize);
+                    StartMoving(player, inputDir, nextDir, isShift, collision);
                 }
             }
         }
@@ -197,7 +191,7 @@ void UpdatePlayerMovement(Player *player, const float frameTime,
                     player->movement.tilePosition.y + freshDir.y
                 };
 
-                if (!IsTileSolid(nextTarget, collision, tileSize))
+                if (!IsTileSolid(nextTarget, collision))
                 {
                     const PlayerAction nextAction   = isShift ? ACTION_RUN : ACTION_WALK;
                     player->movement.targetTilePosition = nextTarget;
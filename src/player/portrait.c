@@ -1,6 +1,7 @@
 #include "ivy/player/portrait.h"
 #include "ivy/item.h"
 #include "ivy/utils.h"
+#include "ivy/trace.h"
 
 #include <math.h>
 
@@ -31,6 +32,7 @@ static void DrawLayer(const Texture2D *tex, const float srcW, const float srcH,
 void RebuildPortrait(Portrait *p, const PlayerGraphics *graphics, const PlayerEquipment *equip)
 {
     if (!p || !p->dirty) return;
+    TRACE_ZONE("RebuildPortrait");
 
     BeginTextureMode(p->canva);
     ClearBackground(BLANK);
@@ -1,6 +1,7 @@
 #include "ivy/game.h"
 #include "ivy/scenes.h"
 #include "ivy/utils.h"
+#include "ivy/texture_registry.h"
 #include "ivy/player/player.h"
 
 #include <assert.h>
@@ -13,8 +14,8 @@ void SceneGameplayInit(Scene *s)
     SceneGameplayData *gd = malloc(sizeof(SceneGameplayData));
     assert(gd && "[ERROR] Failed to allocate memory for SceneGameplayData!");
 
-    gd->tilemap     = LoadTilemapById(1);
-    gd->collision   = InitCollisionAllLayers(gd->tilemap);
+    gd->map         = LoadMapById(1);
+    gd->transition  = (MapTransition){0};
     gd->itemManager = CreateItemManager();
 
     LoadItemsFromFile(gd->itemManager, "assets/items/equipments/twin_braids.bin");
@@ -33,9 +34,9 @@ void SceneGameplayInit(Scene *s)
     LoadItemsFromFile(gd->itemManager, "assets/items/equipments/red_gothic_bando.bin");
 
     gd->player = InitPlayer(
-        gd->tilemap->header.spawnPointX,
-        gd->tilemap->header.spawnPointY,
-        gd->tilemap->header.tileWidth
+        gd->map.tilemap->header.spawnPointX,
+        gd->map.tilemap->header.spawnPointY,
+        gd->map.tilemap->header.tileWidth
     );
 
     for (u32 i = 0; i < gd->itemManager->count; i++)
@@ -44,7 +45,8 @@ void SceneGameplayInit(Scene *s)
     gd->gameCamera = InitGameCamera(VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
     gd->gameCamera.camera2D.target = gd->player->movement.position;
 
-    gd->inventoryUI = CreateInventoryUI();
+    gd->inventoryUI   = CreateInventoryUI();
+    gd->assetsPending = true;
 
     s->data.gameplay = gd;
 }
@@ -75,8 +77,18 @@ void SceneGameplayUpdate(Game *game)
     if (IsKeyPressed(KEY_F1)) showDebugCollision = !showDebugCollision;
 
     const float ft = GetFrameTime();
-    UpdatePlayer(gd->player, ft, gd->collision, gd->tilemap->header.tileWidth);
-    UpdateGameCamera(&gd->gameCamera, gd->player, gd->tilemap, ft);
+    UpdatePlayer(gd->player, ft, gd->map.collision, gd->map.tilemap->header.tileWidth);
+    UpdateEntities(gd->map.entities, ft, gd->map.collision, gd->map.tilemap->header.tileWidth);
+    UpdatePathService(gd->map.paths, PATH_FRAME_BUDGET_US);
+
+    const Vector2 tile = gd->player->movement.tilePosition;
+    if (UpdateMapTransition(&gd->transition, &gd->map, (u32)tile.x, (u32)tile.y)) {
+        const TilemapHeader *h = &gd->map.tilemap->header;
+        PlacePlayer(gd->player, h->spawnPointX, h->spawnPointY, h->tileWidth);
+        gd->gameCamera.camera2D.target = gd->player->movement.position;
+    }
+
+    UpdateGameCamera(&gd->gameCamera, gd->player, gd->map.tilemap, ft);
 }
 
 void SceneGameplayDrawWorld(Game *game)
@@ -86,13 +98,16 @@ void SceneGameplayDrawWorld(Game *game)
     if (gd->inventoryUI.isOpen) return;
 
     BeginMode2D(gd->gameCamera.camera2D);
-        DrawTilemapFromCanva(gd->tilemap);
+        const Rectangle view = GetGameCameraView(&gd->gameCamera);
+        DrawTilemap(gd->map.tilemap, view, gd->gameCamera.camera2D.zoom);
+        DrawEntities(gd->map.entities, view);
         DrawPlayer(gd->player, &game->viewport);
+        DrawTilemapForeground(gd->map.tilemap, view, gd->gameCamera.camera2D.zoom);
 
         if (showDebugCollision) {
             DrawPlayerDebug(gd->player);
-            for (u32 i = 0; i < gd->collision->rectCount; i++) {
-                DrawRectangleLinesEx(gd->collision->rect[i], 1.0f, (Color){ 255, 165, 0, 180 });
+            for (u32 i = 0; i < gd->map.collision->rectCount; i++) {
+                DrawRectangleLinesEx(gd->map.collision->rect[i], 1.0f, (Color){ 255, 165, 0, 180 });
             }
         }
     EndMode2D();
@@ -103,6 +118,16 @@ void SceneGameplayRebuildTextures(Game *game)
     SceneGameplayData *gd = game->sceneManager.activeScene.data.gameplay;
     Player *player        = gd->player;
 
+    const Rectangle view = GetGameCameraView(&gd->gameCamera);
+    UpdateTilemapStreaming(gd->map.tilemap, view);
+    StreamMapTransition(&gd->transition, (Vector2){ view.width, view.height });
+
+    // Textures stream in after init; redraw the portrait once they have all landed
+    if (gd->assetsPending && IsAssetLoaderIdle()) {
+        gd->assetsPending      = false;
+        player->portrait.dirty = true;
+    }
+
     RebuildPortrait(&player->portrait, &player->graphics, &player->equipment);
 
     if (gd->inventoryUI.pendingOpen) {
@@ -121,7 +146,8 @@ void SceneGameplayDrawUI(Game *game)
             &gd->inventoryUI,
             gd->player,
             &game->viewport,
-            &game->fonts[IVY_FONT_PRIMARY]
+            &game->fonts[IVY_FONT_PRIMARY],
+            game->glyphCache
         );
 
         return;
@@ -130,6 +156,25 @@ void SceneGameplayDrawUI(Game *game)
     if (showDebugCollision) {
         const Vector2 pos = GetScreenPos(&game->viewport, (Vector2){ 10.0f, 10.0f });
         DrawTextEx(game->fonts[IVY_FONT_PRIMARY], "DEBUG: ON (F1)", pos, 14.0f * game->viewport.scale, 1, GREEN);
+
+        const TextureRegistryStats stats = GetTextureRegistryStats();
+        const Vector2 statsPos = GetScreenPos(&game->viewport, (Vector2){ 10.0f, 26.0f });
+        DrawTextEx(game->fonts[IVY_FONT_PRIMARY],
+                   TextFormat("TEX: %u live, %u/%u hits, %.1f MB", stats.entries, stats.hits,
+                              stats.acquires, (double)stats.bytesResident / (1024.0 * 1024.0)),
+                   statsPos, 9.0f * game->viewport.scale, 1, GREEN);
+
+        const TileStream *ts = gd->map.tilemap->stream;
+        const Vector2 mapPos = GetScreenPos(&game->viewport, (Vector2){ 10.0f, 38.0f });
+        DrawTextEx(game->fonts[IVY_FONT_PRIMARY],
+                   TextFormat("MAP: %u/%u chunks resident, %u baked, %.1f MB VRAM", ts->residentCount,
+                              ts->chunksX * ts->chunksY, ts->bakedCount, (double)ts->bakedBytes / (1024.0 * 1024.0)),
+                   mapPos, 9.0f * game->viewport.scale, 1, GREEN);
+
+        const Vector2 bakePos = GetScreenPos(&game->viewport, (Vector2){ 10.0f, 48.0f });
+        DrawTextEx(game->fonts[IVY_FONT_PRIMARY],
+                   TextFormat("BAKE: %u quads in %u batches", ts->bakeQuads, ts->bakeBatches),
+                   bakePos, 9.0f * game->viewport.scale, 1, GREEN);
     }
 
     {
@@ -147,8 +192,8 @@ void SceneGameplayUnload(Scene *s)
 
     SceneGameplayData *gd = s->data.gameplay;
     DestroyInventoryUI(&gd->inventoryUI);
-    DestroyCollision(gd->collision);
-    UnloadTilemap(gd->tilemap);
+    DestroyMapTransition(&gd->transition);
+    UnloadLoadedMap(&gd->map);
     DestroyPlayer(gd->player);
     DestroyItemManager(gd->itemManager);
     free(gd);
@@ -1,6 +1,7 @@
 #include "ivy/game.h"
 #include "ivy/utils.h"
 #include "ivy/scenes.h"
+#include "ivy/texture_registry.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -29,8 +30,9 @@ void SceneTitleInit(Scene *s)
     *sd = (SceneTitleData) {
         .selectedIndex  = 0,
         .cursorY        = 0.0f,
-        .background     = LoadTextureFromImageBin("assets/background.bin")
+        .background     = {0}
     };
+    AcquireTexture("assets/background.bin", TEXTURE_FILE_IMAGE_BIN, &sd->background);
 
     s->data.title = sd;
 }
@@ -115,7 +117,7 @@ void SceneTitleDrawUI(Game *game)
 void SceneTitleUnload(Scene *s)
 {
     if (s->data.title) {
-        UnloadTexture(s->data.title->background);
+        ReleaseTexture(&s->data.title->background);
         free(s->data.title);
         s->data.title = NULL;
     }
@@ -1,4 +1,5 @@
 #include "ivy/scenes.h"
+#include "ivy/trace.h"
 #include <stddef.h>
 
 void UpdateScene(SceneManager *sm)
@@ -6,6 +7,7 @@ void UpdateScene(SceneManager *sm)
     Scene *s = &sm->activeScene;
 
     if (s->Unload) {
+        TRACE_ZONE("Scene.Unload");
         s->Unload(s);
         s->data.title = NULL;
     }
@@ -42,6 +44,9 @@ void UpdateScene(SceneManager *sm)
         default: break;
     }
 
-    if (s->Init) s->Init(s);
+    if (s->Init) {
+        TRACE_ZONE("Scene.Init");
+        s->Init(s);
+    }
     sm->sceneChanged = false;
 }
\ No newline at end of file
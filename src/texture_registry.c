@@ -0,0 +1,355 @@
+#include "ivy/texture_registry.h"
+#include "ivy/pack.h"
+#include "ivy/atlas.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INTERN_TABLE_SIZE   2048    // power of two
+#define INTERN_BLOCK_SIZE   16384
+
+typedef struct InternBlock {
+    struct InternBlock *next;
+    u32                 used;
+    char                data[INTERN_BLOCK_SIZE];
+} InternBlock;
+
+typedef struct {
+    const char *path;
+    u32         hash;
+    int         entry;      // registry slot, -1 when not resident
+} InternRecord;
+
+typedef struct {
+    InternRecord   *record;
+    Texture2D       texture;
+    TextureHandle   handle;
+    u32             refCount;
+    u32             lastUsed;
+    u32             bytes;
+    bool            loading;
+    bool            used;
+} TextureEntry;
+
+typedef struct {
+    Texture2D  *target;
+    u32         entry;
+} TextureWaiter;
+
+static struct {
+    InternRecord    interned[INTERN_TABLE_SIZE];
+    u32             internCount;
+    InternBlock    *blocks;
+
+    TextureEntry    entries[TEXTURE_REGISTRY_CAPACITY];
+    TextureWaiter   waiters[TEXTURE_REGISTRY_WAITERS];
+    u32             waiterCount;
+
+    TextureRegistryStats stats;
+    u64             cachedBytes;
+    u32             tick;
+} registry;
+
+static const char *CopyToArena(const char *path, const u32 len)
+{
+    InternBlock *block = registry.blocks;
+
+    if (!block || block->used + len + 1 > INTERN_BLOCK_SIZE) {
+        assert(len + 1 <= INTERN_BLOCK_SIZE && "[ERROR] Interned path too long");
+        block = malloc(sizeof(InternBlock));
+        assert(block && "[ERROR] Failed to alloc InternBlock");
+        block->next     = registry.blocks;
+        block->used     = 0;
+        registry.blocks = block;
+    }
+
+    char *dst = block->data + block->used;
+    memcpy(dst, path, len + 1);
+    block->used += len + 1;
+    return dst;
+}
+
+static InternRecord *InternRecordFor(const char *path)
+{
+    const u32 hash = PackHashPath(path);
+    u32 slot = hash & (INTERN_TABLE_SIZE - 1);
+
+    while (registry.interned[slot].path)
+    {
+        InternRecord *rec = &registry.interned[slot];
+        if (rec->hash == hash && strcmp(rec->path, path) == 0) return rec;
+        slot = (slot + 1) & (INTERN_TABLE_SIZE - 1);
+    }
+
+    assert(registry.internCount < INTERN_TABLE_SIZE / 2 && "[ERROR] Intern table full");
+    registry.internCount++;
+
+    InternRecord *rec = &registry.interned[slot];
+    rec->path  = CopyToArena(path, (u32)strlen(path));
+    rec->hash  = hash;
+    rec->entry = -1;
+    return rec;
+}
+
+const char *InternPath(const char *path)
+{
+    return InternRecordFor(path)->path;
+}
+
+static void AddWaiter(Texture2D *target, const u32 entry)
+{
+    assert(registry.waiterCount < TEXTURE_REGISTRY_WAITERS && "[ERROR] Too many texture waiters");
+    registry.waiters[registry.waiterCount++] = (TextureWaiter){ target, entry };
+    *target = (Texture2D){0};
+}
+
+static void EvictEntry(const u32 slot)
+{
+    TextureEntry *e = &registry.entries[slot];
+
+    UnloadTexture(e->texture);
+    registry.stats.bytesResident -= e->bytes;
+    registry.cachedBytes         -= e->bytes;
+    registry.stats.evictions++;
+
+    e->record->entry = -1;
+    *e = (TextureEntry){0};
+}
+
+static int FindLeastRecentlyUsed(void)
+{
+    int best = -1;
+    for (u32 i = 0; i < TEXTURE_REGISTRY_CAPACITY; i++) {
+        const TextureEntry *e = &registry.entries[i];
+        if (!e->used || e->loading || e->refCount > 0) continue;
+        if (best < 0 || e->lastUsed < registry.entries[best].lastUsed) best = (int)i;
+    }
+    return best;
+}
+
+static int AllocEntry(void)
+{
+    for (u32 i = 0; i < TEXTURE_REGISTRY_CAPACITY; i++) {
+        if (!registry.entries[i].used) return (int)i;
+    }
+
+    const int victim = FindLeastRecentlyUsed();
+    if (victim >= 0) EvictEntry((u32)victim);
+    return victim;
+}
+
+static void DropReference(const u32 slot)
+{
+    TextureEntry *e = &registry.entries[slot];
+    assert(e->refCount > 0);
+
+    if (--e->refCount == 0) {
+        e->lastUsed = registry.tick;
+        registry.cachedBytes += e->bytes;
+    }
+}
+
+static void FinishEntry(const u32 slot)
+{
+    TextureEntry *e = &registry.entries[slot];
+    e->loading = false;
+
+    if (e->texture.id == 0) {
+        TraceLog(LOG_ERROR, "TEXTURES: Failed to load '%s'", e->record->path);
+
+        // Waiters are dropped with their targets still empty, which GetTextureState reports as failed
+        for (u32 i = 0; i < registry.waiterCount; ) {
+            if (registry.waiters[i].entry == slot)
+                registry.waiters[i] = registry.waiters[--registry.waiterCount];
+            else i++;
+        }
+
+        e->record->entry = -1;
+        *e = (TextureEntry){0};
+        return;
+    }
+
+    e->bytes = (u32)GetPixelDataSize(e->texture.width, e->texture.height, e->texture.format);
+    registry.stats.bytesResident += e->bytes;
+    if (e->refCount == 0) registry.cachedBytes += e->bytes;
+
+    for (u32 i = 0; i < registry.waiterCount; ) {
+        if (registry.waiters[i].entry == slot) {
+            *registry.waiters[i].target = e->texture;
+            registry.waiters[i] = registry.waiters[--registry.waiterCount];
+        }
+        else i++;
+    }
+}
+
+void AcquireTexture(const char *path, const TextureFileType type, Texture2D *target)
+{
+    assert(path && target);
+
+    InternRecord *rec = InternRecordFor(path);
+    registry.stats.acquires++;
+
+    if (rec->entry >= 0)
+    {
+        TextureEntry *e = &registry.entries[rec->entry];
+        registry.stats.hits++;
+
+        if (e->refCount++ == 0 && !e->loading) registry.cachedBytes -= e->bytes;
+
+        if (e->loading) AddWaiter(target, (u32)rec->entry);
+        else            *target = e->texture;
+        return;
+    }
+
+    registry.stats.misses++;
+
+    const int slot = AllocEntry();
+    if (slot < 0) {
+        // Registry is full of live textures: load untracked, ReleaseTexture unloads it
+        LoadTextureAsync(path, type, target);
+        return;
+    }
+
+    TextureEntry *e = &registry.entries[slot];
+    *e = (TextureEntry){
+        .record   = rec,
+        .refCount = 1,
+        .loading  = true,
+        .used     = true
+    };
+    rec->entry = slot;
+
+    AddWaiter(target, (u32)slot);
+    e->handle = LoadTextureAsync(rec->path, type, &e->texture);
+
+    if (e->handle == 0) FinishEntry((u32)slot);
+}
+
+void ReleaseTexture(Texture2D *target)
+{
+    if (!target) return;
+
+    if (target->id == 0)
+    {
+        for (u32 i = 0; i < registry.waiterCount; i++) {
+            if (registry.waiters[i].target != target) continue;
+
+            const u32 slot = registry.waiters[i].entry;
+            registry.waiters[i] = registry.waiters[--registry.waiterCount];
+            DropReference(slot);
+            return;
+        }
+
+        CancelTextureLoads(target, sizeof(Texture2D));
+        return;
+    }
+
+    for (u32 i = 0; i < TEXTURE_REGISTRY_CAPACITY; i++) {
+        const TextureEntry *e = &registry.entries[i];
+        if (!e->used || e->loading || e->texture.id != target->id) continue;
+
+        DropReference(i);
+        *target = (Texture2D){0};
+        return;
+    }
+
+    UnloadTexture(*target);
+    *target = (Texture2D){0};
+}
+
+TextureState GetTextureState(const Texture2D *target)
+{
+    if (target->id != 0) return TEXTURE_READY;
+
+    for (u32 i = 0; i < registry.waiterCount; i++) {
+        if (registry.waiters[i].target == target) return TEXTURE_PENDING;
+    }
+
+    // Untracked loads (registry full) go straight through the asset loader
+    return IsTextureLoadPending(target) ? TEXTURE_PENDING : TEXTURE_FAILED;
+}
+
+void AcquireTextureRegion(const char *path, TextureRegion *region)
+{
+    const AtlasRegion *r = FindAtlasRegion(path);
+
+    if (!r) {
+        region->source = (Rectangle){0};
+        AcquireTexture(path, TEXTURE_FILE_IMAGE_BIN, &region->texture);
+        return;
+    }
+
+    region->source = (Rectangle){ (float)r->x, (float)r->y, (float)r->width, (float)r->height };
+    AcquireTexture(GetAtlasPage(r->page)->path, TEXTURE_FILE_IMAGE_BIN, &region->texture);
+}
+
+void ReleaseTextureRegion(TextureRegion *region)
+{
+    ReleaseTexture(&region->texture);
+    region->source = (Rectangle){0};
+}
+
+Rectangle GetRegionSource(const TextureRegion *region)
+{
+    if (region->source.width > 0.0f) return region->source;
+    return (Rectangle){ 0, 0, (float)region->texture.width, (float)region->texture.height };
+}
+
+Rectangle GetRegionSubRect(const TextureRegion *region, const Rectangle local)
+{
+    return (Rectangle){
+        region->source.x + local.x,
+        region->source.y + local.y,
+        local.width,
+        local.height
+    };
+}
+
+void UpdateTextureRegistry(void)
+{
+    registry.tick++;
+
+    for (u32 i = 0; i < TEXTURE_REGISTRY_CAPACITY; i++) {
+        const TextureEntry *e = &registry.entries[i];
+        if (e->used && e->loading && IsTextureLoaded(e->handle)) FinishEntry(i);
+    }
+
+    while (registry.cachedBytes > TEXTURE_CACHE_BYTES) {
+        const int victim = FindLeastRecentlyUsed();
+        if (victim < 0) break;
+        EvictEntry((u32)victim);
+    }
+}
+
+void DestroyTextureRegistry(void)
+{
+    const TextureRegistryStats stats = GetTextureRegistryStats();
+    TraceLog(LOG_INFO, "TEXTURES: %u acquires, %u hits, %u misses, %u evictions",
+             stats.acquires, stats.hits, stats.misses, stats.evictions);
+
+    for (u32 i = 0; i < TEXTURE_REGISTRY_CAPACITY; i++) {
+        if (registry.entries[i].used) UnloadTexture(registry.entries[i].texture);
+    }
+
+    InternBlock *block = registry.blocks;
+    while (block) {
+        InternBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    memset(&registry, 0, sizeof(registry));
+}
+
+TextureRegistryStats GetTextureRegistryStats(void)
+{
+    TextureRegistryStats stats = registry.stats;
+    stats.entries = 0;
+
+    for (u32 i = 0; i < TEXTURE_REGISTRY_CAPACITY; i++) {
+        if (registry.entries[i].used) stats.entries++;
+    }
+
+    return stats;
+}
\ No newline at end of file
@@ -1,42 +1,35 @@
-
 #include "ivy/tilemap/tilemap.h"
 
-void TM_DrawTileBorder(const Tilemap *tilemap, const Tileset *tileset, const Rectangle src, const Vector2 pos, const u32 x, const u32 y)
+// mask has a bit for every neighbour that holds a tile other than a border
+void TM_AutotileBorder(const float tileSize, const u32 mask, TileQuadList *out)
 {
-    const Layer *layer = &tilemap->layers[0];
-    const Texture2D texture = tileset->texture;
-
-    const u32 mapWidth = layer->width;
-    const u32 mapHeight = layer->height;
-
-    const float tileSize = (float)tilemap->header.tileWidth;
     const float tileHalf = tileSize / 2.0f;
 
-    const bool N  = HAS_TILE(layer, x, y - 1, mapWidth, mapHeight) && TM_GetTileType(tilemap, 0, x, y - 1) != TILE_BORDER;
-    const bool S  = HAS_TILE(layer, x, y + 1, mapWidth, mapHeight) && TM_GetTileType(tilemap, 0, x, y + 1) != TILE_BORDER;
-    const bool W  = HAS_TILE(layer, x - 1, y, mapWidth, mapHeight) && TM_GetTileType(tilemap, 0, x - 1, y) != TILE_BORDER;
-    const bool E  = HAS_TILE(layer, x + 1, y, mapWidth, mapHeight) && TM_GetTileType(tilemap, 0, x + 1, y) != TILE_BORDER;
+    const bool N  = mask & TILE_NEIGHBOUR_N;
+    const bool S  = mask & TILE_NEIGHBOUR_S;
+    const bool W  = mask & TILE_NEIGHBOUR_W;
+    const bool E  = mask & TILE_NEIGHBOUR_E;
 
-    const bool NW = HAS_TILE(layer, x - 1, y - 1, mapWidth, mapHeight) && TM_GetTileType(tilemap, 0, x - 1, y - 1) != TILE_BORDER;
-    const bool NE = HAS_TILE(layer, x + 1, y - 1, mapWidth, mapHeight) && TM_GetTileType(tilemap, 0, x + 1, y - 1) != TILE_BORDER;
-    const bool SW = HAS_TILE(layer, x - 1, y + 1, mapWidth, mapHeight) && TM_GetTileType(tilemap, 0, x - 1, y + 1) != TILE_BORDER;
-    const bool SE = HAS_TILE(layer, x + 1, y + 1, mapWidth, mapHeight) && TM_GetTileType(tilemap, 0, x + 1, y + 1) != TILE_BORDER;
+    const bool NW = mask & TILE_NEIGHBOUR_NW;
+    const bool NE = mask & TILE_NEIGHBOUR_NE;
+    const bool SW = mask & TILE_NEIGHBOUR_SW;
+    const bool SE = mask & TILE_NEIGHBOUR_SE;
 
     // EDGES
-    if (N) DrawTextureRec(texture, (Rectangle){ src.x + tileHalf, src.y + tileSize, tileSize, tileHalf }, pos, WHITE);
-    if (S) DrawTextureRec(texture, (Rectangle){ src.x + tileHalf, src.y + tileSize * 2.0f + tileHalf, tileSize, tileHalf }, (Vector2){ pos.x, pos.y + tileHalf }, WHITE);
-    if (W) DrawTextureRec(texture, (Rectangle){ src.x, src.y + tileSize + tileHalf, tileHalf, tileSize }, pos, WHITE);
-    if (E) DrawTextureRec(texture, (Rectangle){ src.x + tileSize + tileHalf, src.y + tileSize + tileHalf, tileHalf, tileSize }, (Vector2){ pos.x + tileHalf, pos.y }, WHITE);
+    if (N) TM_PushQuad(out, 0, (Rectangle){ tileHalf, tileSize, tileSize, tileHalf }, (Vector2){ 0, 0 });
+    if (S) TM_PushQuad(out, 0, (Rectangle){ tileHalf, tileSize * 2.0f + tileHalf, tileSize, tileHalf }, (Vector2){ 0, tileHalf });
+    if (W) TM_PushQuad(out, 0, (Rectangle){ 0, tileSize + tileHalf, tileHalf, tileSize }, (Vector2){ 0, 0 });
+    if (E) TM_PushQuad(out, 0, (Rectangle){ tileSize + tileHalf, tileSize + tileHalf, tileHalf, tileSize }, (Vector2){ tileHalf, 0 });
 
     // CORNER IN
-    if (N && W) DrawTextureRec(texture, (Rectangle){ src.x, src.y, tileHalf, tileHalf }, pos, WHITE);
-    if (N && E) DrawTextureRec(texture, (Rectangle){ src.x + tileHalf, src.y, tileHalf, tileHalf }, (Vector2){ pos.x + tileHalf, pos.y }, WHITE);
-    if (S && W) DrawTextureRec(texture, (Rectangle){ src.x, src.y + tileHalf, tileHalf, tileHalf }, (Vector2){ pos.x, pos.y + tileHalf }, WHITE);
-    if (S && E) DrawTextureRec(texture, (Rectangle){ src.x + tileHalf, src.y + tileHalf, tileHalf, tileHalf }, (Vector2){ pos.x + tileHalf, pos.y + tileHalf }, WHITE);
+    if (N && W) TM_PushQuad(out, 0, (Rectangle){ 0, 0, tileHalf, tileHalf }, (Vector2){ 0, 0 });
+    if (N && E) TM_PushQuad(out, 0, (Rectangle){ tileHalf, 0, tileHalf, tileHalf }, (Vector2){ tileHalf, 0 });
+    if (S && W) TM_PushQuad(out, 0, (Rectangle){ 0, tileHalf, tileHalf, tileHalf }, (Vector2){ 0, tileHalf });
+    if (S && E) TM_PushQuad(out, 0, (Rectangle){ tileHalf, tileHalf, tileHalf, tileHalf }, (Vector2){ tileHalf, tileHalf });
 
     // CORNER OUT
-    if (!N && !W && NW) DrawTextureRec(texture, (Rectangle){ src.x + tileSize, src.y, tileHalf, tileHalf }, pos, WHITE);
-    if (!N && !E && NE) DrawTextureRec(texture, (Rectangle){ src.x + tileSize + tileHalf, src.y, tileHalf, tileHalf }, (Vector2){ pos.x + tileHalf, pos.y }, WHITE);
-    if (!S && !W && SW) DrawTextureRec(texture, (Rectangle){ src.x + tileSize, src.y + tileHalf, tileHalf, tileHalf }, (Vector2){ pos.x, pos.y + tileHalf }, WHITE);
-    if (!S && !E && SE) DrawTextureRec(texture, (Rectangle){ src.x + tileSize + tileHalf, src.y + tileHalf, tileHalf, tileHalf }, (Vector2){ pos.x + tileHalf, pos.y + tileHalf }, WHITE);
-}
+    if (!N && !W && NW) TM_PushQuad(out, 0, (Rectangle){ tileSize, 0, tileHalf, tileHalf }, (Vector2){ 0, 0 });
+    if (!N && !E && NE) TM_PushQuad(out, 0, (Rectangle){ tileSize + tileHalf, 0, tileHalf, tileHalf }, (Vector2){ tileHalf, 0 });
+    if (!S && !W && SW) TM_PushQuad(out, 0, (Rectangle){ tileSize, tileHalf, tileHalf, tileHalf }, (Vector2){ 0, tileHalf });
+    if (!S && !E && SE) TM_PushQuad(out, 0, (Rectangle){ tileSize + tileHalf, tileHalf, tileHalf, tileHalf }, (Vector2){ tileHalf, tileHalf });
+}
\ No newline at end of file
@@ -1,48 +1,39 @@
 #include "ivy/tilemap/tilemap.h"
 
-void TM_DrawTileCarpet(const Tilemap *tilemap, const Tileset *tileset,
-                    const Rectangle src, const Vector2 pos,
-                    const u32 x, const u32 y)
+void TM_AutotileCarpet(const float tileSize, const u32 mask, TileQuadList *out)
 {
-    const TileType typeN = TM_GetTileType(tilemap, 1, x, y - 1);
-    const TileType typeS = TM_GetTileType(tilemap, 1, x, y + 1);
-    const TileType typeE = TM_GetTileType(tilemap, 1, x + 1, y);
-    const TileType typeW = TM_GetTileType(tilemap, 1, x - 1, y);
+    const bool carpetN = mask & TILE_NEIGHBOUR_N;
+    const bool carpetS = mask & TILE_NEIGHBOUR_S;
+    const bool carpetE = mask & TILE_NEIGHBOUR_E;
+    const bool carpetW = mask & TILE_NEIGHBOUR_W;
 
-    const float sX = src.x;
-    const float sY = src.y;
-    const float pX = pos.x;
-    const float pY = pos.y;
-
-    const float tileSize = (float)tilemap->header.tileWidth;
     const float tileHalf = tileSize * 0.5f;
-    const Texture2D tex = tileset->texture;
 
-    if (typeE == TILE_CARPET) {
-        DrawTextureRec(tex, (Rectangle){ sX + tileHalf, sY + tileSize + tileHalf, tileSize, tileSize }, (Vector2){ pX, pY }, WHITE);
+    if (carpetE) {
+        TM_PushQuad(out, 0, (Rectangle){ tileHalf, tileSize + tileHalf, tileSize, tileSize }, (Vector2){ 0, 0 });
     }
 
-    if (typeE != TILE_CARPET)
-        DrawTextureRec(tex, (Rectangle){ sX + tileSize, sY + tileSize + tileHalf, tileSize, tileSize }, (Vector2){ pX, pY }, WHITE);
+    if (!carpetE)
+        TM_PushQuad(out, 0, (Rectangle){ tileSize, tileSize + tileHalf, tileSize, tileSize }, (Vector2){ 0, 0 });
 
-    if (typeW != TILE_CARPET)
-        DrawTextureRec(tex, (Rectangle){ sX, sY + tileSize + tileHalf, tileSize, tileSize }, (Vector2){ pX, pY }, WHITE);
+    if (!carpetW)
+        TM_PushQuad(out, 0, (Rectangle){ 0, tileSize + tileHalf, tileSize, tileSize }, (Vector2){ 0, 0 });
 
-    if (typeN != TILE_CARPET)
-        DrawTextureRec(tex, (Rectangle){ sX + tileHalf, sY + tileSize, tileSize, tileHalf }, (Vector2){ pX, pY }, WHITE);
+    if (!carpetN)
+        TM_PushQuad(out, 0, (Rectangle){ tileHalf, tileSize, tileSize, tileHalf }, (Vector2){ 0, 0 });
 
-    if (typeS != TILE_CARPET)
-        DrawTextureRec(tex, (Rectangle){ sX + tileHalf, sY + tileSize * 2 + tileHalf, tileSize, tileHalf }, (Vector2){ pX + 0, pY + tileHalf }, WHITE);
+    if (!carpetS)
+        TM_PushQuad(out, 0, (Rectangle){ tileHalf, tileSize * 2 + tileHalf, tileSize, tileHalf }, (Vector2){ 0, tileHalf });
 
-    if (typeN != TILE_CARPET && typeE != TILE_CARPET)
-        DrawTextureRec(tex, (Rectangle){ sX + tileSize + tileHalf, sY + tileSize, tileHalf, tileHalf }, (Vector2){ pX + tileHalf, pY }, WHITE);
+    if (!carpetN && !carpetE)
+        TM_PushQuad(out, 0, (Rectangle){ tileSize + tileHalf, tileSize, tileHalf, tileHalf }, (Vector2){ tileHalf, 0 });
 
-    if (typeN != TILE_CARPET && typeW != TILE_CARPET)
-        DrawTextureRec(tex, (Rectangle){ sX, sY + tileSize, tileHalf, tileHalf }, (Vector2){ pX, pY }, WHITE);
+    if (!carpetN && !carpetW)
+        TM_PushQuad(out, 0, (Rectangle){ 0, tileSize, tileHalf, tileHalf }, (Vector2){ 0, 0 });
 
-    if (typeS != TILE_CARPET && typeE != TILE_CARPET)
-        DrawTextureRec(tex, (Rectangle){ sX + tileSize + tileHalf, sY + 2 * tileSize + tileHalf, tileHalf, tileHalf }, (Vector2){ pX + tileHalf, pY + tileHalf }, WHITE);
+    if (!carpetS && !carpetE)
+        TM_PushQuad(out, 0, (Rectangle){ tileSize + tileHalf, 2 * tileSize + tileHalf, tileHalf, tileHalf }, (Vector2){ tileHalf, tileHalf });
 
-    if (typeS != TILE_CARPET && typeW != TILE_CARPET)
-        DrawTextureRec(tex, (Rectangle){ sX, sY + 2 * tileSize + tileHalf, tileHalf, tileHalf }, (Vector2){ pX, pY + tileHalf }, WHITE);
+    if (!carpetS && !carpetW)
+        TM_PushQuad(out, 0, (Rectangle){ 0, 2 * tileSize + tileHalf, tileHalf, tileHalf }, (Vector2){ 0, tileHalf });
 }
\ No newline at end of file
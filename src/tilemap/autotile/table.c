@@ -1,75 +1,66 @@
 #include "ivy/tilemap/tilemap.h"
 
-void TM_DrawTileTable(const Tilemap *tilemap, const Tileset *tileset,
-                   const Rectangle src, const Vector2 pos,
-                   const u32 x, const u32 y)
+void TM_AutotileTable(const float tileSize, const u32 mask, TileQuadList *out)
 {
     // TODO: Finish Auto Tile Table for vertical!
-    // const TileType typeN = GetTileType(tilemap, 0, x, y - 1);
-    const TileType typeS = TM_GetTileType(tilemap, 1, x, y + 1);
-    const TileType typeE = TM_GetTileType(tilemap, 1, x + 1, y);
-    const TileType typeW = TM_GetTileType(tilemap, 1, x - 1, y);
+    // const bool tableN = mask & TILE_NEIGHBOUR_N;
+    const bool tableS = mask & TILE_NEIGHBOUR_S;
+    const bool tableE = mask & TILE_NEIGHBOUR_E;
+    const bool tableW = mask & TILE_NEIGHBOUR_W;
 
-    const float sX = src.x;
-    const float sY = src.y;
-    const float pX = pos.x;
-    const float pY = pos.y;
-
-    const float tileSize = (float)tilemap->header.tileWidth;
     const float tileHalf = tileSize * 0.5f;
-    const Texture2D tex = tileset->texture;
 
     // Center fill
-    if (typeE == TILE_TABLE)
+    if (tableE)
     {
-        DrawTextureRec(tex,
-            (Rectangle){ sX + tileHalf, sY + tileSize * 2.0f - 8.0f, tileSize, tileSize },
-            (Vector2){ pX + tileHalf, pY }, WHITE);
+        TM_PushQuad(out, 0,
+            (Rectangle){ tileHalf, tileSize * 2.0f - 8.0f, tileSize, tileSize },
+            (Vector2){ tileHalf, 0 });
     }
 
     // Edges
-    if (typeE != TILE_TABLE)
+    if (!tableE)
     {
-        DrawTextureRec(tex,
-            (Rectangle){ sX + tileSize + tileHalf, sY + tileSize * 2.0f - 8.0f, tileHalf, tileSize },
-            (Vector2){ pX + tileHalf, pY }, WHITE);
+        TM_PushQuad(out, 0,
+            (Rectangle){ tileSize + tileHalf, tileSize * 2.0f - 8.0f, tileHalf, tileSize },
+            (Vector2){ tileHalf, 0 });
     }
 
-    if (typeW != TILE_TABLE)
+    if (!tableW)
     {
-        DrawTextureRec(tex,
-            (Rectangle){ sX, sY + tileSize * 2.0f - 8.0f, tileHalf, tileSize },
-            (Vector2){ pX, pY }, WHITE);
+        TM_PushQuad(out, 0,
+            (Rectangle){ 0, tileSize * 2.0f - 8.0f, tileHalf, tileSize },
+            (Vector2){ 0, 0 });
     }
 
-    // if (typeN != TILE_TABLE)
-    //     DrawTextureRec(tex, (Rectangle){ sX + tileHalf, sY + tileSize, tileSize, tileHalf }, (Vector2){ pX, pY - tileHalf }, WHITE);
+    // if (!tableN)
+    //     TM_PushQuad(out, 0, (Rectangle){ tileHalf, tileSize, tileSize, tileHalf }, (Vector2){ 0, -tileHalf });
 
-    if (typeS != TILE_TABLE)
+    if (!tableS)
     {
-        DrawTextureRec(tex,
-            (Rectangle){ sX + tileHalf, sY + tileSize * 3.0f - 8.0f, tileSize, 8.0f },
-            (Vector2){ pX, pY + tileSize }, WHITE);
+        TM_PushQuad(out, 0,
+            (Rectangle){ tileHalf, tileSize * 3.0f - 8.0f, tileSize, 8.0f },
+            (Vector2){ 0, tileSize });
     }
 
     // Corners
-    // if (typeN != TILE_TABLE && typeE != TILE_TABLE)
-    //     DrawTextureRec(tex, (Rectangle){ sX + tileSize + tileHalf, sY + tileSize, tileHalf, tileHalf }, (Vector2){ pX + tileHalf, pY }, WHITE);
+    // if (!tableN && !tableE)
+    //     TM_PushQuad(out, 0, (Rectangle){ tileSize + tileHalf, tileSize, tileHalf, tileHalf }, (Vector2){ tileHalf, 0 });
 
-    // if (typeN != TILE_TABLE && typeW != TILE_TABLE)
-    //     DrawTextureRec(tex, (Rectangle){ sX, sY + tileSize, tileHalf, tileHalf }, (Vector2){ pX, pY }, WHITE);
+    // if (!tableN && !tableW)
+    //     TM_PushQuad(out, 0, (Rectangle){ 0, tileSize, tileHalf, tileHalf }, (Vector2){ 0, 0 });
 
-    if (typeS != TILE_TABLE && typeE != TILE_TABLE)
+    if (!tableS && !tableE)
     {
-        DrawTextureRec(tex,
-            (Rectangle){ sX + tileSize * 2.0f - 8.0f, sY + tileSize * 3.0f - 8.0f, 8.0f, 8.0f },
-            (Vector2){ pX + tileSize - 8.0f, pY + tileSize }, WHITE);
+        TM_PushQuad(out, 0,
+            (Rectangle){ tileSize * 2.0f - 8.0f, tileSize * 3.0f - 8.0f, 8.0f, 8.0f },
+            (Vector2){ tileSize - 8.0f, tileSize });
     }
 
-    if (typeS != TILE_TABLE && typeW != TILE_TABLE)
+    if (!tableS && !tableW)
     {
-        DrawTextureRec(tex,
-            (Rectangle){ sX, sY + tileSize * 3.0f - 8.0f, 8.0f, 8.0f },
-            (Vector2){ pX, pY + tileSize }, WHITE);
+        TM_PushQuad(out, 0,
+            (Rectangle){ 0, tileSize * 3.0f - 8.0f, 8.0f, 8.0f },
+            (Vector2){ 0, tileSize });
     }
 }
\ No newline at end of file
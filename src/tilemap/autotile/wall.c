@@ -1,76 +1,68 @@
 #include "ivy/tilemap/tilemap.h"
 
-void TM_DrawTileWall(const Tilemap *tilemap, const Tileset *tileset,
-             const Rectangle src, const Vector2 pos,
-             const u32 x, const u32 y)
+void TM_AutotileWall(const float tileSize, const u32 mask, TileQuadList *out)
 {
-    const TileType typeN = TM_GetTileType(tilemap, 0, x, y - 1);
-    const TileType typeS = TM_GetTileType(tilemap, 0, x, y + 1);
-    const TileType typeE = TM_GetTileType(tilemap, 0, x + 1, y);
-    const TileType typeW = TM_GetTileType(tilemap, 0, x - 1, y);
+    const bool wallN = mask & TILE_NEIGHBOUR_N;
+    const bool wallS = mask & TILE_NEIGHBOUR_S;
+    const bool wallE = mask & TILE_NEIGHBOUR_E;
+    const bool wallW = mask & TILE_NEIGHBOUR_W;
 
-    const float sX = src.x;
-    const float sY = src.y;
-    const float pX = pos.x;
-    const float pY = pos.y;
-
-    const float tileSize = (float)tilemap->header.tileWidth;
     const float tileHalf = tileSize * 0.5f;
 
     // Center fill
-    if (typeE == TILE_WALL && typeS == TILE_WALL) {
-        DrawTextureRec(tileset->texture,
-            (Rectangle){ sX + tileHalf, sY + tileHalf, tileSize, tileSize },
-            (Vector2){ pX + tileHalf, pY + tileHalf }, WHITE);
+    if (wallE && wallS) {
+        TM_PushQuad(out, 0,
+            (Rectangle){ tileHalf, tileHalf, tileSize, tileSize },
+            (Vector2){ tileHalf, tileHalf });
     }
 
     // Edges
-    if (typeN != TILE_WALL && typeE == TILE_WALL) {
-        DrawTextureRec(tileset->texture,
-            (Rectangle){ sX + tileHalf, sY, tileSize, tileHalf },
-            (Vector2){ pX + tileHalf, pY }, WHITE);
+    if (!wallN && wallE) {
+        TM_PushQuad(out, 0,
+            (Rectangle){ tileHalf, 0, tileSize, tileHalf },
+            (Vector2){ tileHalf, 0 });
     }
 
-    if (typeS != TILE_WALL && typeE == TILE_WALL) {
-        DrawTextureRec(tileset->texture,
-            (Rectangle){ sX + tileHalf, sY + 48, tileSize, tileHalf },
-            (Vector2){ pX + tileHalf, pY + tileHalf }, WHITE);
+    if (!wallS && wallE) {
+        TM_PushQuad(out, 0,
+            (Rectangle){ tileHalf, 48, tileSize, tileHalf },
+            (Vector2){ tileHalf, tileHalf });
     }
 
-    if (typeW != TILE_WALL && typeS == TILE_WALL) {
-        DrawTextureRec(tileset->texture,
-            (Rectangle){ sX, sY + tileHalf, tileHalf, tileSize },
-            (Vector2){ pX, pY + tileHalf }, WHITE);
+    if (!wallW && wallS) {
+        TM_PushQuad(out, 0,
+            (Rectangle){ 0, tileHalf, tileHalf, tileSize },
+            (Vector2){ 0, tileHalf });
     }
 
-    if (typeE != TILE_WALL && typeS == TILE_WALL) {
-        DrawTextureRec(tileset->texture,
-            (Rectangle){ sX + 48, sY + tileHalf, tileHalf, tileSize },
-            (Vector2){ pX + tileHalf, pY + tileHalf }, WHITE);
+    if (!wallE && wallS) {
+        TM_PushQuad(out, 0,
+            (Rectangle){ 48, tileHalf, tileHalf, tileSize },
+            (Vector2){ tileHalf, tileHalf });
     }
 
     // Corners
-    if (typeW != TILE_WALL && typeN != TILE_WALL) {
-        DrawTextureRec(tileset->texture,
-            (Rectangle){ sX, sY, tileHalf, tileHalf },
-            (Vector2){ pX, pY }, WHITE);
+    if (!wallW && !wallN) {
+        TM_PushQuad(out, 0,
+            (Rectangle){ 0, 0, tileHalf, tileHalf },
+            (Vector2){ 0, 0 });
     }
 
-    if (typeE != TILE_WALL && typeN != TILE_WALL) {
-        DrawTextureRec(tileset->texture,
-            (Rectangle){ sX + 48, sY, tileHalf, tileHalf },
-            (Vector2){ pX + tileHalf, pY }, WHITE);
+    if (!wallE && !wallN) {
+        TM_PushQuad(out, 0,
+            (Rectangle){ 48, 0, tileHalf, tileHalf },
+            (Vector2){ tileHalf, 0 });
     }
 
-    if (typeW != TILE_WALL && typeS != TILE_WALL) {
-        DrawTextureRec(tileset->texture,
-            (Rectangle){ sX, sY + 48, tileHalf, tileHalf },
-            (Vector2){ pX, pY + tileHalf }, WHITE);
+    if (!wallW && !wallS) {
+        TM_PushQuad(out, 0,
+            (Rectangle){ 0, 48, tileHalf, tileHalf },
+            (Vector2){ 0, tileHalf });
     }
 
-    if (typeE != TILE_WALL && typeS != TILE_WALL) {
-        DrawTextureRec(tileset->texture,
-            (Rectangle){ sX + 48, sY + 48, tileHalf, tileHalf },
-            (Vector2){ pX + tileHalf, pY + tileHalf }, WHITE);
+    if (!wallE && !wallS) {
+        TM_PushQuad(out, 0,
+            (Rectangle){ 48, 48, tileHalf, tileHalf },
+            (Vector2){ tileHalf, tileHalf });
     }
-}
+}
\ No newline at end of file
@@ -1,69 +1,297 @@
 #include "ivy/tilemap/tilemap.h"
+#include "ivy/utils.h"
+#include "ivy/texture_registry.h"
+#include "ivy/trace.h"
 
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
 
 
+static Tilemap *ReadTilemap(const AssetData asset)
+{
+    ByteReader reader = { .data = asset.data, .size = asset.size, .offset = 0 };
+
+    Tilemap *tilemap = calloc(1, sizeof(Tilemap));
+    assert(tilemap && "[ERROR] Failed to allocate memory tilemap!");
+
+    // Tileset properties and chunks are views into the source, so it stays mapped until unload
+    tilemap->source = asset;
+
+    TM_LoadHeader(&reader, tilemap);
+    TM_LoadTilesets(&reader, tilemap);
+    TM_LoadLayers(&reader, tilemap);
+    TM_LoadSections(tilemap);
+    TM_BuildTileTables(tilemap);
+
+    return tilemap;
+}
+
 Tilemap *LoadTilemapById(const u32 id)
 {
+    TRACE_ZONE("LoadTilemapById");
+
+    Tilemap *tilemap = ReadTilemapById(id);
+    AcquireTilemapTextures(tilemap);
+    return tilemap;
+}
+
+Tilemap *ReadTilemapById(const u32 id)
+{
+    TRACE_ZONE("ReadTilemapById");
+
     char path[MAX_PATH_LEN] = {0};
     snprintf(path, MAX_PATH_LEN, "%s/map_%d.bin", TILEMAP_ASSET_PATH, id);
 
-    FILE *file = fopen(path, "rb");
-    assert(file && "[ERROR] Failed to open file!");
+    AssetData asset = MapAssetData(path);
+    assert(asset.data && "[ERROR] Failed to open file!");
 
-    Tilemap *tilemap = malloc(sizeof(Tilemap));
-    assert(tilemap && "[ERROR] Failed to allocate memory tilemap!");
+    return ReadTilemap(asset);
+}
 
-    TM_LoadHeader(file, tilemap);
-    TM_LoadTilesets(file, tilemap);
-    TM_LoadLayers(file, tilemap);
-    TM_FindMaxGid(tilemap);
-    TM_ReloadCanva(tilemap);
+void AcquireTilemapTextures(Tilemap *tilemap)
+{
+    assert(tilemap && "[ERROR] Tilemap not found!");
+
+    TM_InternTilesetPaths(tilemap);
+    for (u32 i = 0; i < tilemap->header.tilesetCount; i++)
+        AcquireTexture(tilemap->tilesets[i].texturePath, TEXTURE_FILE_PNG_BIN, &tilemap->tilesets[i].texture);
+}
 
-    fclose(file);
+Tilemap *LoadTilemapFromAsset(const AssetData asset)
+{
+    Tilemap *tilemap = ReadTilemap(asset);
+    TM_InternTilesetPaths(tilemap);
     return tilemap;
 }
 
-void DrawTilemapFromCanva(const Tilemap *tilemap)
+// Chunk range covered by a world-space rectangle, clamped to the map
+static TileRect GetViewChunks(const Tilemap *tilemap, const Rectangle view)
+{
+    const TileStream *s = tilemap->stream;
+    const float chunkW  = (float)(TILEMAP_CHUNK_TILES * tilemap->header.tileWidth);
+    const float chunkH  = (float)(TILEMAP_CHUNK_TILES * tilemap->header.tileHeight);
+
+    const int x0 = (int)floorf(view.x / chunkW);
+    const int y0 = (int)floorf(view.y / chunkH);
+    const int x1 = (int)ceilf((view.x + view.width)  / chunkW);
+    const int y1 = (int)ceilf((view.y + view.height) / chunkH);
+
+    return (TileRect){
+        .x0 = x0 < 0 ? 0 : (u32)x0,
+        .y0 = y0 < 0 ? 0 : (u32)y0,
+        .x1 = x1 < 0 ? 0 : ((u32)x1 > s->chunksX ? s->chunksX : (u32)x1),
+        .y1 = y1 < 0 ? 0 : ((u32)y1 > s->chunksY ? s->chunksY : (u32)y1)
+    };
+}
+
+void UpdateTilemapStreaming(Tilemap *tilemap, const Rectangle view)
+{
+    if (!tilemap) return;
+    TRACE_ZONE("UpdateTilemapStreaming");
+
+    TileStream *s = tilemap->stream;
+    s->tick++;
+    tilemap->animTime += GetFrameTime();
+
+    if (!tilemap->drawInfoReady) {
+        if (!TM_TilesetsReady(tilemap)) return;
+        TM_BuildDrawInfo(tilemap);
+    }
+
+    // Bake a little past the screen edge so panning rarely shows a missing chunk; the
+    // margin follows the view so zooming out (which pans faster in world units) looks further ahead
+    const float marginX = fmaxf(view.width  * 0.25f, (float)(tilemap->header.tileWidth  * TILEMAP_CHUNK_TILES) * 0.5f);
+    const float marginY = fmaxf(view.height * 0.25f, (float)(tilemap->header.tileHeight * TILEMAP_CHUNK_TILES) * 0.5f);
+    const Rectangle area = { view.x - marginX, view.y - marginY, view.width + 2.0f * marginX, view.height + 2.0f * marginY };
+    const TileRect r = GetViewChunks(tilemap, area);
+
+    // Edited tiles are redrawn in place, visible or not, so a baked canvas never goes stale
+    if (s->dirtyCount > 0) {
+        for (u32 i = 0; i < s->chunksX * s->chunksY; i++) {
+            TileChunk *chunk = &s->chunks[i];
+            if (chunk->dirty.x0 == chunk->dirty.x1) continue;
+            TM_RebakeDirty(tilemap, chunk);
+        }
+        s->dirtyCount = 0;
+    }
+
+    u32 baked = 0;
+    for (u32 cy = r.y0; cy < r.y1; cy++) {
+        for (u32 cx = r.x0; cx < r.x1; cx++) {
+            TileChunk *chunk = &s->chunks[cy * s->chunksX + cx];
+            chunk->lastSeen = s->tick;
+
+            if (chunk->canva.id != 0 || baked >= TILEMAP_BAKES_PER_FRAME) continue;
+            TM_BakeChunk(tilemap, chunk);
+            baked++;
+        }
+    }
+
+    TM_TrimChunks(tilemap);
+}
+
+static void DrawChunkCanvas(const Tilemap *tilemap, const TileRect r, const int level, const ChunkCanvas which)
+{
+    TileStream *s = tilemap->stream;
+
+    for (u32 cy = r.y0; cy < r.y1; cy++) {
+        for (u32 cx = r.x0; cx < r.x1; cx++) {
+            TileChunk *chunk              = &s->chunks[cy * s->chunksX + cx];
+            const RenderTexture2D *canvas = TM_GetChunkCanvas(chunk, which);
+            if (canvas->id == 0) continue;
+
+            const float w = (float)canvas->texture.width;
+            const float h = (float)canvas->texture.height;
+            if (level > 0) canvas = &chunk->mips[which][level - 1];
+
+            const Rectangle src = { 0.0f, 0.0f, (float)canvas->texture.width, -(float)canvas->texture.height };
+            const Rectangle dst = {
+                (float)(cx * TILEMAP_CHUNK_TILES * tilemap->header.tileWidth),
+                (float)(cy * TILEMAP_CHUNK_TILES * tilemap->header.tileHeight),
+                w, h
+            };
+
+            DrawTexturePro(canvas->texture, src, dst, (Vector2){0}, 0.0f, WHITE);
+        }
+    }
+}
+
+static void DrawAnimatedCells(const Tilemap *tilemap, const TileRect r, const bool above, const bool overCanvas)
+{
+    const TileStream *s = tilemap->stream;
+
+    for (u32 cy = r.y0; cy < r.y1; cy++) {
+        for (u32 cx = r.x0; cx < r.x1; cx++) {
+            const TileChunk *chunk = &s->chunks[cy * s->chunksX + cx];
+            if (chunk->animCount > 0) TM_DrawAnimatedCells(tilemap, chunk, above, overCanvas);
+        }
+    }
+}
+
+// Animated cells of the background's animLayer go between the canvas below it and the one
+// from it up; every other live cell goes over the last canvas of its pass
+static void DrawChunkCanvases(const Tilemap *tilemap, const Rectangle view, const float zoom, const bool above)
+{
+    const TileRect r = GetViewChunks(tilemap, view);
+
+    // Nearest level: the one whose texels come closest to one per screen pixel
+    int level = zoom >= 1.0f ? 0 : (int)floorf(log2f(1.0f / zoom) + 0.5f);
+    if (level > TILEMAP_CANVAS_LEVELS - 1) level = TILEMAP_CANVAS_LEVELS - 1;
+
+    DrawChunkCanvas(tilemap, r, level, above ? CHUNK_CANVAS_ABOVE : CHUNK_CANVAS_BELOW);
+    DrawAnimatedCells(tilemap, r, above, false);
+
+    if (!above) {
+        DrawChunkCanvas(tilemap, r, level, CHUNK_CANVAS_OVER);
+        DrawAnimatedCells(tilemap, r, false, true);
+    }
+}
+
+void DrawTilemap(const Tilemap *tilemap, const Rectangle view, const float zoom)
+{
+    assert(tilemap && "[ERROR] Tilemap not found!");
+    DrawChunkCanvases(tilemap, view, zoom, false);
+}
+
+void DrawTilemapForeground(const Tilemap *tilemap, const Rectangle view, const float zoom)
+{
+    assert(tilemap && "[ERROR] Tilemap not found!");
+    DrawChunkCanvases(tilemap, view, zoom, true);
+}
+
+void DrawTilemapOverview(const Tilemap *tilemap, const Rectangle dest, const Color tint)
+{
+    assert(tilemap && "[ERROR] Tilemap not found!");
+
+    const RenderTexture2D *overview = &tilemap->stream->overview;
+    if (overview->id == 0) return;
+
+    const Rectangle src = { 0.0f, 0.0f, (float)overview->texture.width, -(float)overview->texture.height };
+    DrawTexturePro(overview->texture, src, dest, (Vector2){0}, 0.0f, tint);
+}
+
+void SetTile(Tilemap *tilemap, const u32 layer, const u32 x, const u32 y, const u32 gid)
 {
     assert(tilemap && "[ERROR] Tilemap not found!");
 
-    const float canvaW = (float)tilemap->canva.texture.width;
-    const float canvaH = (float)tilemap->canva.texture.height;
+    const TilemapHeader *h = &tilemap->header;
+    if (layer >= h->layerCount || x >= h->width || y >= h->height) return;
+
+    const u32 id = gid == 0 ? 0 : TM_AddTile(tilemap, gid);
+    if (gid != 0 && id == 0) {
+        TraceLog(LOG_WARNING, "TILEMAP: gid %u belongs to none of the map's tilesets", gid);
+        return;
+    }
+
+    TileStream *s    = tilemap->stream;
+    TileChunk *chunk = &s->chunks[(y >> TILEMAP_CHUNK_SHIFT) * s->chunksX + (x >> TILEMAP_CHUNK_SHIFT)];
+    u32 *data        = TM_GetWritableChunk(tilemap, chunk);
+
+    const u32 plane = layer << (2 * TILEMAP_CHUNK_SHIFT);
+    u32 *cell       = &data[plane + ((y & TILEMAP_CHUNK_MASK) << TILEMAP_CHUNK_SHIFT) + (x & TILEMAP_CHUNK_MASK)];
+    if (*cell == id) return;
+    *cell = id;
 
-    const Rectangle src = { 0.0f, 0.0f, canvaW, -canvaH };
-    const Rectangle dst = { 0.0f, 0.0f, canvaW,  canvaH  };
+    // The cooked collision rects describe the map as shipped
+    tilemap->cookedRects     = NULL;
+    tilemap->cookedRectCount = 0;
 
-    DrawTexturePro(tilemap->canva.texture, src, dst, (Vector2){0}, 0.0f, WHITE);
+    // The tile and its neighbours may pick different autotile quads now
+    TM_MarkDirty(tilemap, (TileRect){
+        .x0 = x > 0 ? x - 1 : 0,
+        .y0 = y > 0 ? y - 1 : 0,
+        .x1 = x + 2 < h->width  ? x + 2 : h->width,
+        .y1 = y + 2 < h->height ? y + 2 : h->height
+    });
 }
 
 void UnloadTilemap(Tilemap *tilemap)
 {
     if (!tilemap) return;
 
-    UnloadRenderTexture(tilemap->canva);
+    if (tilemap->stream) {
+        TileStream *s = tilemap->stream;
+        for (u32 i = 0; i < s->chunksX * s->chunksY; i++) {
+            if (s->chunks[i].canva.id != 0) TM_UnloadChunkCanvas(tilemap, &s->chunks[i]);
+            if (s->chunks[i].owned) free((void *)s->chunks[i].data);
+        }
+        if (s->overview.id != 0) {
+            s->bakedBytes -= (u64)s->overview.texture.width * s->overview.texture.height * 4;
+            UnloadRenderTexture(s->overview);
+        }
+        free(s->emptyChunk);
+        free(s->scratch.quads);
+        free(s->mapOrder.quads);
+        free(s->quadKeys);
+        free(s->keyCounts);
+        free(s->neighbours.ids);
+        free(s->neighbours.masks);
+        free(s->neighbours.types);
+        free(s->chunks);
+        free(s);
+    }
 
     if (tilemap->tilesets) {
         for (u32 i = 0; i < tilemap->header.tilesetCount; i++) {
-            UnloadTexture(tilemap->tilesets[i].texture);
-            free(tilemap->tilesets[i].texturePath);
-            free(tilemap->tilesets[i].properties);
+            ReleaseTexture(&tilemap->tilesets[i].texture);
+            if (tilemap->tilesets[i].propertiesOwned) free((void *)tilemap->tilesets[i].properties);
+            free(tilemap->tilesets[i].propIndex);
         }
         free(tilemap->tilesets);
     }
 
-    if (tilemap->layers) {
-        for (u32 i = 0; i < tilemap->header.layerCount; i++) {
-            free(tilemap->layers[i].data);
-        }
-        free(tilemap->layers);
-    }
-
     free(tilemap->tileDrawInfoTable);
+    if (tilemap->autotileTable) free(tilemap->autotileTable->quads.quads);
+    free(tilemap->autotileTable);
     free(tilemap->tilesetIndexTable);
+    free(tilemap->tileFlagTable);
     free(tilemap->tileTypeTable);
+    free(tilemap->tileGids);
+    free(tilemap->tileOrder);
+    free(tilemap->tilesetsByGid);
 
+    UnloadAssetData(&tilemap->source);
     free(tilemap);
 }
\ No newline at end of file
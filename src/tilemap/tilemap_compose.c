@@ -0,0 +1,141 @@
+#include "ivy/tilemap/tilemap_compose.h"
+#include "ivy/platform.h"
+#include "ivy/trace.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const Image         *tilesets;
+    u32                 tilesetCount;
+    const TilemapQuad   *quads;
+    u32                 count;
+    Vector2             origin;     // world position of the image's top-left pixel
+    Image               target;
+    int                 y0, y1;     // rows of target this band owns
+} ComposeBand;
+
+// glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) on an RGBA8 target, alpha included
+static void BlendRow(u8 *dst, const u8 *src, const int width)
+{
+    for (int i = 0; i < width; i++, dst += 4, src += 4)
+    {
+        const u32 a = src[3];
+        if (a == 0) continue;
+        if (a == 255) {
+            memcpy(dst, src, 4);
+            continue;
+        }
+
+        for (int c = 0; c < 4; c++)
+            dst[c] = (u8)((src[c] * a + dst[c] * (255 - a) + 127) / 255);
+    }
+}
+
+// Every band walks the whole list in order and keeps the rows it owns, so the bands
+// never share a pixel and the result matches a sequential draw
+static void ComposeBandMain(void *arg)
+{
+    TRACE_ZONE("ComposeBand");
+    const ComposeBand *b = arg;
+    u8 *pixels           = b->target.data;
+    const int pitch      = b->target.width * 4;
+
+    for (u32 i = 0; i < b->count; i++)
+    {
+        const TilemapQuad *q = &b->quads[i];
+        if (q->tileset >= b->tilesetCount) continue;
+        const Image *ts = &b->tilesets[q->tileset];
+        if (!ts->data) continue;
+
+        int sx = (int)q->srcX, sy = (int)q->srcY;
+        int dx = (int)(q->dstX - b->origin.x), dy = (int)(q->dstY - b->origin.y);
+        int w  = (int)q->srcWidth, h = (int)q->srcHeight;
+
+        // Clip against the band, the target and the tileset
+        if (dx < 0)     { sx -= dx; w += dx; dx = 0; }
+        if (dy < b->y0) { sy += b->y0 - dy; h -= b->y0 - dy; dy = b->y0; }
+        if (sx < 0)     { dx -= sx; w += sx; sx = 0; }
+        if (sy < 0)     { dy -= sy; h += sy; sy = 0; }
+        if (dx + w > b->target.width) w = b->target.width - dx;
+        if (dy + h > b->y1)           h = b->y1 - dy;
+        if (sx + w > ts->width)       w = ts->width - sx;
+        if (sy + h > ts->height)      h = ts->height - sy;
+        if (w <= 0 || h <= 0) continue;
+
+        const u8 *src = (const u8 *)ts->data + ((size_t)sy * ts->width + sx) * 4;
+        u8 *dst       = pixels + (size_t)dy * pitch + (size_t)dx * 4;
+        for (int row = 0; row < h; row++, src += ts->width * 4, dst += pitch)
+            BlendRow(dst, src, w);
+    }
+}
+
+Image ComposeTilemapImage(const Tilemap *tilemap, const Image *tilesets, const TileRect rect, const bool foreground)
+{
+    TRACE_ZONE("ComposeTilemapImage");
+    assert(tilemap && tilemap->tileDrawInfoTable && "[ERROR] Tilemap draw info not built!");
+
+    const TilemapHeader *h = &tilemap->header;
+    const int width        = (int)((rect.x1 - rect.x0) * h->tileWidth);
+    const int height       = (int)((rect.y1 - rect.y0) * h->tileHeight);
+
+    Image image = {
+        .data    = calloc((size_t)width * height, 4),
+        .width   = width,
+        .height  = height,
+        .mipmaps = 1,
+        .format  = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+    };
+    assert((image.data || width * height == 0) && "[ERROR] Failed to allocate memory for composed image!");
+    if (width == 0 || height == 0) return image;
+
+    for (u32 i = 0; i < h->tilesetCount; i++) {
+        if (tilesets[i].data && tilesets[i].format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) {
+            TraceLog(LOG_WARNING, "TILEMAP: Compose needs RGBA8 tilesets, tileset %u is format %d", i, tilesets[i].format);
+            return image;
+        }
+    }
+
+    // Same draw list as a bake of rect, a one tile apron included for the autotiles that spill over
+    TileQuadList list = {0};
+    const u32 above = TM_CollectQuads(tilemap, (TileRect){
+        .x0 = rect.x0 > 0 ? rect.x0 - 1 : 0,
+        .y0 = rect.y0 > 0 ? rect.y0 - 1 : 0,
+        .x1 = rect.x1 < h->width  ? rect.x1 + 1 : h->width,
+        .y1 = rect.y1 < h->height ? rect.y1 + 1 : h->height
+    }, TILEMAP_ANIM_STILLS, &list, NULL);
+    const u32 below = list.count - above;
+
+    u32 bandCount = (u32)height / TILEMAP_COMPOSE_MIN_ROWS;
+    const u32 cpus = GetCpuCount();
+    if (bandCount > cpus)                    bandCount = cpus;
+    if (bandCount > TILEMAP_COMPOSE_THREADS) bandCount = TILEMAP_COMPOSE_THREADS;
+    if (bandCount == 0)                      bandCount = 1;
+
+    ComposeBand bands[TILEMAP_COMPOSE_THREADS];
+    Thread threads[TILEMAP_COMPOSE_THREADS] = {0};
+
+    for (u32 i = 0; i < bandCount; i++) {
+        bands[i] = (ComposeBand){
+            .tilesets     = tilesets,
+            .tilesetCount = h->tilesetCount,
+            .quads        = list.quads + (foreground ? below : 0),
+            .count        = foreground ? above : below,
+            .origin       = { (float)(rect.x0 * h->tileWidth), (float)(rect.y0 * h->tileHeight) },
+            .target       = image,
+            .y0           = (int)((u64)height * i / bandCount),
+            .y1           = (int)((u64)height * (i + 1) / bandCount)
+        };
+    }
+
+    // The calling thread takes the first band; a band whose thread fails to start runs here too
+    for (u32 i = 1; i < bandCount; i++) {
+        if (!StartThread(&threads[i], ComposeBandMain, &bands[i])) ComposeBandMain(&bands[i]);
+    }
+    ComposeBandMain(&bands[0]);
+    for (u32 i = 1; i < bandCount; i++) JoinThread(&threads[i]);
+
+    free(list.quads);
+    return image;
+}
\ No newline at end of file
@@ -1,165 +1,757 @@
 #include "ivy/tilemap/tilemap.h"
 #include "ivy/utils.h"
+#include "ivy/texture_registry.h"
+#include "ivy/trace.h"
 
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <assert.h>
 
-#define EXTRA_GID 256
+#define TILE_TABLE_MIN_CAPACITY 64
+#define DENSE_EXTRA_GIDS        256     // spare gids the old gid-indexed tables kept for SetTile
 
-u32 TM_BuildTileTable(const Tilemap *tilemap)
+static int CompareU32(const void *a, const void *b)
 {
-    u32 max = 0;
+    const u32 x = *(const u32 *)a, y = *(const u32 *)b;
+    return (x > y) - (x < y);
+}
 
-    for (u32 l = 0; l < tilemap->header.layerCount; l++)
+static u32 GetTileProp(const Tileset *ts, const u32 tileIndex)
+{
+    if (tileIndex >= ts->propIndexCount) return TILE_GROUND;
+
+    const u32 p = ts->propIndex[tileIndex];
+    return p == 0 ? TILE_GROUND : ts->properties[p - 1].type;
+}
+
+// Tileset whose gid range holds gid: the one with the highest firstGid not above it
+static int FindTilesetOfGid(const Tilemap *tilemap, const u32 gid)
+{
+    int lo = 0, hi = (int)tilemap->header.tilesetCount - 1, found = -1;
+    while (lo <= hi) {
+        const int mid = (lo + hi) / 2;
+        const u32 ts  = tilemap->tilesetsByGid[mid];
+        if (tilemap->tilesets[ts].firstGid <= gid) {
+            found = (int)ts;
+            lo    = mid + 1;
+        }
+        else hi = mid - 1;
+    }
+    return found;
+}
+
+static void ReserveTiles(Tilemap *tilemap, const u32 count)
+{
+    if (count + 1 <= tilemap->tileCapacity) return;
+
+    const u32 old = tilemap->tileCapacity;
+    u32 capacity  = old == 0 ? TILE_TABLE_MIN_CAPACITY : old;
+    while (capacity < count + 1) capacity *= 2;
+
+    tilemap->tileTypeTable      = realloc(tilemap->tileTypeTable,     capacity * sizeof(u8));
+    tilemap->tilesetIndexTable  = realloc(tilemap->tilesetIndexTable, capacity * sizeof(u16));
+    tilemap->tileFlagTable      = realloc(tilemap->tileFlagTable,     capacity * sizeof(u32));
+    tilemap->tileDrawInfoTable  = realloc(tilemap->tileDrawInfoTable, capacity * sizeof(TileDrawInfo));
+    tilemap->tileGids           = realloc(tilemap->tileGids,          capacity * sizeof(u32));
+    tilemap->tileOrder          = realloc(tilemap->tileOrder,         capacity * sizeof(u32));
+
+    assert(tilemap->tileTypeTable && tilemap->tilesetIndexTable && tilemap->tileFlagTable &&
+           tilemap->tileDrawInfoTable && tilemap->tileGids && tilemap->tileOrder && "[ERROR] Failed to grow tile tables!");
+
+    const u32 added = capacity - old;
+    memset(tilemap->tileTypeTable     + old, 0, added * sizeof(u8));
+    memset(tilemap->tilesetIndexTable + old, 0, added * sizeof(u16));
+    memset(tilemap->tileFlagTable     + old, 0, added * sizeof(u32));
+    memset(tilemap->tileDrawInfoTable + old, 0, added * sizeof(TileDrawInfo));
+    memset(tilemap->tileGids          + old, 0, added * sizeof(u32));
+    memset(tilemap->tileOrder         + old, 0, added * sizeof(u32));
+    tilemap->tileCapacity = capacity;
+}
+
+static void FillTileDrawInfo(Tilemap *tilemap, const u32 id)
+{
+    const Tileset *ts       = &tilemap->tilesets[tilemap->tilesetIndexTable[id]];
+    const u32 tilesPerRow   = ts->texture.width  / tilemap->header.tileWidth;
+    const u32 tilesPerCol   = ts->texture.height / tilemap->header.tileHeight;
+    const u32 tileIndex     = tilemap->tileGids[id] - ts->firstGid;
+
+    // Gids past the tileset image draw nothing
+    if (tileIndex >= tilesPerRow * tilesPerCol) {
+        tilemap->tileDrawInfoTable[id] = (TileDrawInfo){0};
+        return;
+    }
+
+    const u32 flags     = tilemap->tileFlagTable[id];
+    const TileType type = (TileType)tilemap->tileTypeTable[id];
+    const bool autotile = type == TILE_WALL || type == TILE_BORDER || type == TILE_CARPET || type == TILE_TABLE;
+    const u32 duration  = (flags >> TILE_PROP_DURATION_SHIFT) & TILE_PROP_DURATION_MASK;
+
+    tilemap->tileDrawInfoTable[id] = (TileDrawInfo) {
+        .src = (Rectangle) {
+            .x      = (float)(tileIndex % tilesPerRow) * (float)tilemap->header.tileWidth,
+            .y      = (float)(tileIndex / tilesPerRow) * (float)tilemap->header.tileHeight,
+            .width  = (float)tilemap->header.tileWidth,
+            .height = (float)tilemap->header.tileHeight
+        },
+        .pos    = (Vector2){ 0 },
+        .type   = type,
+        .tileset = ts,
+        .foreground = (flags & TILE_PROP_FOREGROUND) != 0,
+        .frames     = autotile ? 1 : (u8)(((flags >> TILE_PROP_FRAMES_SHIFT) & TILE_PROP_FRAMES_MASK) + 1),
+        .frameTime  = duration > 0 ? (u8)duration : 10
+    };
+
+    if (tilemap->tileDrawInfoTable[id].frames > 1) tilemap->hasAnimatedTiles = true;
+}
+
+// Types only depend on the gid, so they are known before any texture arrives
+static void FillTile(Tilemap *tilemap, const u32 id)
+{
+    const int tsIdx = FindTilesetOfGid(tilemap, tilemap->tileGids[id]);
+    if (tsIdx < 0) return;
+
+    const Tileset *ts = &tilemap->tilesets[tsIdx];
+    const u32 prop    = GetTileProp(ts, tilemap->tileGids[id] - ts->firstGid);
+
+    tilemap->tilesetIndexTable[id] = (u16)tsIdx;
+    tilemap->tileTypeTable[id]     = (u8)(prop & TILE_PROP_TYPE_MASK);
+    tilemap->tileFlagTable[id]     = prop & ~TILE_PROP_TYPE_MASK;
+
+    if (tilemap->drawInfoReady) FillTileDrawInfo(tilemap, id);
+}
+
+// Appends gid and the later frames of its animation; the caller keeps tileGids ascending
+static void PushTileGids(const Tilemap *tilemap, u32 **gids, u32 *count, u32 *capacity, const u32 gid)
+{
+    const int tsIdx  = FindTilesetOfGid(tilemap, gid);
+    const u32 frames = tsIdx < 0 ? 0 :
+        (GetTileProp(&tilemap->tilesets[tsIdx], gid - tilemap->tilesets[tsIdx].firstGid) >> TILE_PROP_FRAMES_SHIFT) & TILE_PROP_FRAMES_MASK;
+
+    for (u32 f = 0; f <= frames; f++) {
+        if (*count == *capacity) {
+            *capacity = *capacity == 0 ? 256 : *capacity * 2;
+            u32 *tmp  = realloc(*gids, *capacity * sizeof(u32));
+            assert(tmp && "[ERROR] Failed to realloc tile gids");
+            *gids = tmp;
+        }
+        (*gids)[(*count)++] = gid + f;
+    }
+}
+
+// Gives every tile the layers use a compact local id. v3 maps ship the table and ids in
+// their chunks; v1 layers are scanned here and remapped as their chunks are cut.
+void TM_BuildTileTables(Tilemap *tilemap)
+{
+    TRACE_ZONE("TM_BuildTileTables");
+
+    const u32 tilesetCount = tilemap->header.tilesetCount;
+    tilemap->tilesetsByGid = malloc((tilesetCount ? tilesetCount : 1) * sizeof(u32));
+    assert(tilemap->tilesetsByGid && "[ERROR] Failed to allocate memory for tileset order!");
+
+    // Insertion sort on firstGid; ties keep file order, so of two tilesets sharing a
+    // firstGid the later one owns the range
+    for (u32 i = 0; i < tilesetCount; i++) {
+        u32 at = i;
+        while (at > 0 && tilemap->tilesets[tilemap->tilesetsByGid[at - 1]].firstGid > tilemap->tilesets[i].firstGid) {
+            tilemap->tilesetsByGid[at] = tilemap->tilesetsByGid[at - 1];
+            at--;
+        }
+        tilemap->tilesetsByGid[at] = i;
+    }
+
+    u32 maxGid = 0;
+    u32 count  = 0;
+
+    if (tilemap->file.version != 0)
+    {
+        const TilemapFileHeader *f = &tilemap->file;
+        assert((u64)f->tileOffset + (u64)f->tileCount * sizeof(u32) <= tilemap->source.size && "[ERROR] Truncated tile table!");
+
+        count  = f->tileCount;
+        maxGid = f->maxGid;
+        ReserveTiles(tilemap, count);
+        memcpy(tilemap->tileGids + 1, tilemap->source.data + f->tileOffset, count * sizeof(u32));
+    }
+    else
     {
-        const u32 totalCells = tilemap->layers[l].width * tilemap->layers[l].height;
-        for (u32 i = 0; i < totalCells; i++) {
-            if (tilemap->layers[l].data[i] > max)
-                max = tilemap->layers[l].data[i];
+        // v1 maps are small enough to scan once at load
+        const u32 cellCount = tilemap->header.width * tilemap->header.height;
+        const u8 *record    = tilemap->layerData;
+        u32 *gids = NULL, capacity = 0;
+
+        for (u32 l = 0; l < tilemap->header.layerCount; l++)
+        {
+            const u8 *cells = record + 2 * sizeof(u32);
+            for (u32 i = 0; i < cellCount; i++) {
+                u32 gid;
+                memcpy(&gid, cells + i * sizeof(u32), sizeof(u32));
+                if (gid > maxGid) maxGid = gid;
+                if (gid != 0) PushTileGids(tilemap, &gids, &count, &capacity, gid);
+            }
+            record = cells + cellCount * sizeof(u32);
+        }
+
+        if (count > 0) qsort(gids, count, sizeof(u32), CompareU32);
+        u32 unique = 0;
+        for (u32 i = 0; i < count; i++) {
+            if (unique == 0 || gids[i] != gids[unique - 1]) gids[unique++] = gids[i];
         }
+
+        count = unique;
+        ReserveTiles(tilemap, count);
+        if (count > 0) memcpy(tilemap->tileGids + 1, gids, count * sizeof(u32));
+        free(gids);
+    }
+
+    tilemap->tileCount = count;
+    for (u32 id = 1; id <= count; id++) {
+        tilemap->tileOrder[id - 1] = id;
+        FillTile(tilemap, id);
     }
 
-    return max;
+    const u64 entry   = sizeof(u8) + sizeof(u32) + sizeof(TileDrawInfo);
+    const u64 dense   = ((u64)maxGid + DENSE_EXTRA_GIDS + 1) * (entry + sizeof(u8));
+    const u64 compact = (u64)tilemap->tileCapacity * (entry + sizeof(u16) + 2 * sizeof(u32));
+    TraceLog(LOG_INFO, "TILEMAP: %u tiles in use up to gid %u, tile tables %.1f KB (%.1f KB indexed by gid)",
+             count, maxGid, (double)compact / 1024.0, (double)dense / 1024.0);
 }
 
-void TM_FindMaxGid(Tilemap *tilemap)
+u32 TM_FindTileId(const Tilemap *tilemap, const u32 gid)
 {
-    const u32 maxGid    = TM_BuildTileTable(tilemap);
-    tilemap->maxGid     = maxGid + EXTRA_GID;
+    int lo = 0, hi = (int)tilemap->tileCount - 1;
+    while (lo <= hi) {
+        const int mid = (lo + hi) / 2;
+        const u32 id  = tilemap->tileOrder[mid];
+        if (tilemap->tileGids[id] == gid) return id;
+        if (tilemap->tileGids[id] < gid) lo = mid + 1;
+        else                             hi = mid - 1;
+    }
+    return 0;
+}
 
-    tilemap->tileTypeTable     = calloc(tilemap->maxGid + 1, sizeof(u8));
-    tilemap->tilesetIndexTable = calloc(tilemap->maxGid + 1, sizeof(u8));
-    tilemap->tileDrawInfoTable = calloc(tilemap->maxGid + 1, sizeof(TileDrawInfo));
+// Local id of gid, appended with its animation frames when the map did not use it yet
+u32 TM_AddTile(Tilemap *tilemap, const u32 gid)
+{
+    const u32 known = TM_FindTileId(tilemap, gid);
+    if (known != 0 || FindTilesetOfGid(tilemap, gid) < 0) return known;
 
-    assert(tilemap->tileTypeTable && tilemap->tilesetIndexTable && tilemap->tileDrawInfoTable);
+    u32 *gids = NULL, count = 0, capacity = 0;
+    PushTileGids(tilemap, &gids, &count, &capacity, gid);
+    ReserveTiles(tilemap, tilemap->tileCount + count);
 
-    for (u32 tsIdx = 0; tsIdx < tilemap->header.tilesetCount; tsIdx++)
+    const u32 first = tilemap->tileCount + 1;
+    for (u32 i = 0; i < count; i++)
     {
-        const Tileset *ts       = &tilemap->tilesets[tsIdx];
-        const u32 tilesPerRow   = ts->texture.width  / tilemap->header.tileWidth;
-        const u32 tilesPerCol   = ts->texture.height / tilemap->header.tileHeight;
-        const u32 tileCount     = tilesPerRow * tilesPerCol;
+        const u32 id = first + i;
+        tilemap->tileGids[id] = gids[i];
+
+        // Frames get consecutive ids even when another id already stands for their gid
+        u32 at = tilemap->tileCount;
+        while (at > 0 && tilemap->tileGids[tilemap->tileOrder[at - 1]] > gids[i]) {
+            tilemap->tileOrder[at] = tilemap->tileOrder[at - 1];
+            at--;
+        }
+        tilemap->tileOrder[at] = id;
+        tilemap->tileCount++;
+        FillTile(tilemap, id);
+    }
+
+    free(gids);
+    return first;
+}
+
+bool TM_TilesetsReady(const Tilemap *tilemap)
+{
+    for (u32 i = 0; i < tilemap->header.tilesetCount; i++) {
+        if (GetTextureState(&tilemap->tilesets[i].texture) == TEXTURE_PENDING) return false;
+    }
+
+    // Called until it returns true, so each missing tileset is reported once
+    for (u32 i = 0; i < tilemap->header.tilesetCount; i++) {
+        if (tilemap->tilesets[i].texture.id != 0) continue;
+        TraceLog(LOG_ERROR, "TILEMAP: Tileset '%s' failed to load, its tiles are skipped", tilemap->tilesets[i].texturePath);
+    }
+    return true;
+}
+
+void TM_BuildDrawInfo(Tilemap *tilemap)
+{
+    tilemap->drawInfoReady = true;
+    for (u32 id = 1; id <= tilemap->tileCount; id++) FillTileDrawInfo(tilemap, id);
+
+    TM_BuildAutotileTable(tilemap);
+}
 
-        for (u32 localId = 0; localId < tileCount; localId++)
+void TM_BuildAutotileTable(Tilemap *tilemap)
+{
+    if (tilemap->autotileTable) return;
+
+    TileAutotileTable *table = calloc(1, sizeof(TileAutotileTable));
+    assert(table && "[ERROR] Failed to allocate autotile table!");
+
+    static void (*const rules[AUTOTILE_KIND_COUNT])(float, u32, TileQuadList *) = {
+        [AUTOTILE_WALL]   = TM_AutotileWall,
+        [AUTOTILE_TABLE]  = TM_AutotileTable,
+        [AUTOTILE_BORDER] = TM_AutotileBorder,
+        [AUTOTILE_CARPET] = TM_AutotileCarpet
+    };
+    // Only borders look at diagonals, the other masks share the recipe of their cardinal bits
+    static const u32 relevant[AUTOTILE_KIND_COUNT] = {
+        [AUTOTILE_WALL]   = TILE_NEIGHBOUR_CARDINAL,
+        [AUTOTILE_TABLE]  = TILE_NEIGHBOUR_CARDINAL,
+        [AUTOTILE_BORDER] = 0xFF,
+        [AUTOTILE_CARPET] = TILE_NEIGHBOUR_CARDINAL
+    };
+
+    const float tileSize = (float)tilemap->header.tileWidth;
+
+    for (u32 kind = 0; kind < AUTOTILE_KIND_COUNT; kind++) {
+        for (u32 mask = 0; mask < 256; mask++)
         {
-            const u32 gid = ts->firstGid + localId;
-            if (gid > tilemap->maxGid) continue;
+            const u32 canonical = mask & relevant[kind];
+            if (canonical != mask) {
+                table->ranges[kind][mask] = table->ranges[kind][canonical];
+                continue;
+            }
+
+            table->ranges[kind][mask].first = table->quads.count;
+            rules[kind](tileSize, mask, &table->quads);
+            table->ranges[kind][mask].count = table->quads.count - table->ranges[kind][mask].first;
+        }
+    }
+
+    tilemap->autotileTable = table;
+}
+
+static u8 GetCellType(const Tilemap *tilemap, const u32 localId)
+{
+    return localId == 0 || localId > tilemap->tileCount ? (u8)TILE_NONE : tilemap->tileTypeTable[localId];
+}
+
+void TM_BuildNeighbourPlanes(const Tilemap *tilemap, const TileRect rect, TileNeighbourPlanes *planes)
+{
+    TRACE_ZONE("TM_BuildNeighbourPlanes");
+
+    const u32 layerCount = tilemap->header.layerCount;
+    const u32 stride     = rect.x1 - rect.x0 + 2;
+    const u32 rows       = rect.y1 - rect.y0 + 2;
+    const u32 cells      = stride * rows;
+
+    if (cells > planes->capacity) {
+        free(planes->ids);
+        free(planes->masks);
+        free(planes->types);
+        planes->ids      = malloc((size_t)layerCount * cells * sizeof(u32));
+        planes->masks    = malloc((size_t)layerCount * cells * sizeof(u16));
+        planes->types    = malloc(cells);
+        planes->capacity = cells;
+        assert(planes->ids && planes->masks && planes->types && "[ERROR] Failed to allocate neighbour planes!");
+    }
+    planes->stride = stride;
+
+    // Gather: one tile id lookup per cell, the ring outside the map reads as empty
+    for (u32 l = 0; l < layerCount; l++) {
+        u32 *ids = planes->ids + (size_t)l * planes->capacity;
+        for (u32 py = 0; py < rows; py++) {
+            for (u32 px = 0; px < stride; px++)
+                ids[py * stride + px] = TM_GetTileId(tilemap, l, rect.x0 + px - 1, rect.y0 + py - 1);
+        }
+    }
 
-            tilemap->tilesetIndexTable[gid] = (u8)tsIdx;
+    // Sweep: the type of every cell once, then eight branch-free compares against it
+    u8 *types = planes->types;
 
-            TileType type = TILE_GROUND;
-            for (u32 p = 0; p < ts->propertyCount; p++) {
-                if (ts->properties[p].id == localId) {
-                    type = ts->properties[p].type;
-                    break;
+    for (u32 l = 0; l < layerCount; l++)
+    {
+        const u32 *ids = planes->ids + (size_t)l * planes->capacity;
+        u16 *masks      = planes->masks + (size_t)l * planes->capacity;
+
+        for (u32 i = 0; i < cells; i++) types[i] = GetCellType(tilemap, ids[i]);
+        memset(masks, 0, cells * sizeof(u16));
+
+        for (u32 py = 1; py + 1 < rows; py++) {
+            for (u32 px = 1; px + 1 < stride; px++)
+            {
+                const u32 i  = py * stride + px;
+                const u8  t  = types[i];
+                const u32 n[8] = { i - stride, i - stride + 1, i + 1, i + stride + 1,
+                                   i + stride, i + stride - 1, i - 1, i - stride - 1 };
+
+                u32 mask = 0;
+                for (u32 b = 0; b < 8; b++) {
+                    mask |= (u32)(types[n[b]] == t) << b;
+                    mask |= (u32)(ids[n[b]] != 0) << (b + 8);
                 }
+                masks[i] = (u16)mask;
             }
-
-            tilemap->tileTypeTable[gid] = (u8)type;
-
-            tilemap->tileDrawInfoTable[gid] = (TileDrawInfo) {
-                .src = (Rectangle) {
-                    .x      = (float)(localId % tilesPerRow) * (float)tilemap->header.tileWidth,
-                    .y      = (float)(localId / tilesPerRow) * (float)tilemap->header.tileHeight,
-                    .width  = (float)tilemap->header.tileWidth,
-                    .height = (float)tilemap->header.tileHeight
-                },
-                .pos    = (Vector2){ 0 },
-                .type   = type,
-                .tileset = ts
-            };
         }
     }
 }
 
-int TM_FindTilesetIndexByGid(const Tilemap *tilemap, const u32 gid)
+int TM_FindTilesetIndexById(const Tilemap *tilemap, const u32 id)
 {
-    if (gid == 0 || gid > tilemap->maxGid) return -1;
-    return tilemap->tilesetIndexTable[gid];
+    if (id == 0 || id > tilemap->tileCount) return -1;
+    return tilemap->tilesetIndexTable[id];
 }
 
-TileType TM_GetTileType(const Tilemap *tilemap, const u32 layerIndex, const u32 x, const u32 y)
+u32 TM_GetTileId(const Tilemap *tilemap, const u32 layerIndex, const u32 x, const u32 y)
 {
-    if (layerIndex >= tilemap->header.layerCount)   return TILE_NONE;
-    if (x >= tilemap->header.width)                 return TILE_NONE;
-    if (y >= tilemap->header.height)                return TILE_NONE;
+    if (layerIndex >= tilemap->header.layerCount)   return 0;
+    if (x >= tilemap->header.width)                 return 0;
+    if (y >= tilemap->header.height)                return 0;
 
-    const u32 gid = tilemap->layers[layerIndex].data[y * tilemap->header.width + x];
-    if (gid == 0 || gid > tilemap->maxGid)          return TILE_NONE;
+    TileStream *s = tilemap->stream;
+    TileChunk *chunk = &s->chunks[(y >> TILEMAP_CHUNK_SHIFT) * s->chunksX + (x >> TILEMAP_CHUNK_SHIFT)];
 
-    return (TileType)tilemap->tileTypeTable[gid];
+    if (!chunk->data) TM_LoadChunk(tilemap, chunk);
+    chunk->lastUsed = s->tick;
+
+    const u32 plane = layerIndex << (2 * TILEMAP_CHUNK_SHIFT);
+    return chunk->data[plane + ((y & TILEMAP_CHUNK_MASK) << TILEMAP_CHUNK_SHIFT) + (x & TILEMAP_CHUNK_MASK)];
 }
 
-void TM_LoadHeader(FILE *file, Tilemap *tilemap)
+TileType TM_GetTileType(const Tilemap *tilemap, const u32 layerIndex, const u32 x, const u32 y)
 {
-    ReadExact(file, &tilemap->header, sizeof(TilemapHeader));
+    const u32 id = TM_GetTileId(tilemap, layerIndex, x, y);
+    if (id == 0 || id > tilemap->tileCount)          return TILE_NONE;
+
+    return (TileType)tilemap->tileTypeTable[id];
 }
 
-void TM_LoadTilesets(FILE *file, Tilemap *tilemap)
+void TM_LoadHeader(ByteReader *reader, Tilemap *tilemap)
 {
-    tilemap->tilesets = malloc(sizeof(Tileset) * tilemap->header.tilesetCount);
+    u32 magic = 0;
+    if (reader->size >= sizeof(u32)) memcpy(&magic, reader->data, sizeof(u32));
+
+    if (magic == TILEMAP_MAGIC) {
+        ReadExact(reader, &tilemap->file, sizeof(TilemapFileHeader));
+        assert(tilemap->file.version == TILEMAP_VERSION && "[ERROR] Unsupported map version!");
+        assert(tilemap->file.chunkTiles == TILEMAP_CHUNK_TILES && "[ERROR] Unsupported map chunk size!");
+    }
+
+    ReadExact(reader, &tilemap->header, sizeof(TilemapHeader));
+}
+
+void TM_LoadTilesets(ByteReader *reader, Tilemap *tilemap)
+{
+    tilemap->tilesets = calloc(tilemap->header.tilesetCount, sizeof(Tileset));
     assert(tilemap->tilesets && "[ERROR] Failed to allocate memory tilesets!");
 
+    for (u32 i = 0; i < tilemap->header.tilesetCount; i++)
+    {
+        Tileset *ts = &tilemap->tilesets[i];
+
+        ReadExact(reader, &ts->firstGid,      sizeof(u32));
+        ReadExact(reader, &ts->propertyCount, sizeof(u32));
+
+        // The chunker pads names with NULs so the properties after them stay aligned
+        u32 nameLength = 0;
+        ReadExact(reader, &nameLength, sizeof(u32));
+        const char *name = ReadView(reader, nameLength);
+        const char *end  = memchr(name, '\0', nameLength);
+        if (end) nameLength = (u32)(end - name);
+
+        const TileProp *props = ReadView(reader, sizeof(TileProp) * ts->propertyCount);
+
+        if (((uintptr_t)props % _Alignof(TileProp)) == 0) {
+            ts->properties = props;
+        }
+        else {
+            TileProp *copy = malloc(ts->propertyCount * sizeof(TileProp));
+            assert(copy && "[ERROR] Failed to allocate memory tile properties!");
+            memcpy(copy, props, ts->propertyCount * sizeof(TileProp));
+
+            ts->properties      = copy;
+            ts->propertiesOwned = true;
+        }
+
+        // Direct index from local id to property; the first property listed for an id wins
+        for (u32 p = 0; p < ts->propertyCount; p++) {
+            if (ts->properties[p].id + 1 > ts->propIndexCount) ts->propIndexCount = ts->properties[p].id + 1;
+        }
+        if (ts->propIndexCount > 0) {
+            ts->propIndex = calloc(ts->propIndexCount, sizeof(u32));
+            assert(ts->propIndex && "[ERROR] Failed to allocate memory tile property index!");
+        }
+        for (u32 p = ts->propertyCount; p-- > 0; ) ts->propIndex[ts->properties[p].id] = p + 1;
+
+        ts->name       = name;
+        ts->nameLength = nameLength;
+    }
+}
+
+void TM_InternTilesetPaths(Tilemap *tilemap)
+{
     char pathBuffer[MAX_PATH_LEN] = {0};
 
     for (u32 i = 0; i < tilemap->header.tilesetCount; i++)
     {
         Tileset *ts = &tilemap->tilesets[i];
+        if (ts->texturePath) continue;
 
-        ReadExact(file, &ts->firstGid,      sizeof(u32));
-        ReadExact(file, &ts->propertyCount, sizeof(u32));
+        snprintf(pathBuffer, MAX_PATH_LEN, "%s/%.*s", TILESET_ASSET_PATH, (int)ts->nameLength, ts->name);
+        ts->texturePath = InternPath(pathBuffer);
+    }
+}
 
-        ts->texturePath = ReadString(file);
+void TM_LoadLayers(ByteReader *reader, Tilemap *tilemap)
+{
+    const TilemapHeader *h = &tilemap->header;
 
-        ts->properties = malloc(ts->propertyCount * sizeof(TileProp));
-        assert(ts->properties && "[ERROR] Failed to allocate memory tile properties!");
+    TileStream *s = calloc(1, sizeof(TileStream));
+    assert(s && "[ERROR] Failed to allocate memory for tile stream!");
 
-        ReadExact(file, ts->properties, sizeof(TileProp) * ts->propertyCount);
+    s->chunksX    = (h->width  + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT;
+    s->chunksY    = (h->height + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT;
+    s->chunkBytes = h->layerCount * TILEMAP_CHUNK_TILES * TILEMAP_CHUNK_TILES * sizeof(u32);
+    s->chunks     = calloc((size_t)s->chunksX * s->chunksY, sizeof(TileChunk));
+    assert(s->chunks && "[ERROR] Failed to allocate memory for chunks!");
 
-        snprintf(pathBuffer, MAX_PATH_LEN, "%s/%s", TILESET_ASSET_PATH, (const char *)ts->texturePath);
-        ts->texture = LoadTextureFromBin(pathBuffer);
+    tilemap->stream = s;
+
+    if (tilemap->file.version != 0)
+    {
+        s->emptyChunk = calloc(1, s->chunkBytes);
+        assert(s->emptyChunk && "[ERROR] Failed to allocate memory for chunk!");
+
+        const u32 chunkCount = s->chunksX * s->chunksY;
+        assert(tilemap->file.chunksX == s->chunksX && tilemap->file.chunksY == s->chunksY);
+        assert((u64)tilemap->file.indexOffset + (u64)chunkCount * sizeof(TilemapChunkEntry) <= reader->size &&
+               "[ERROR] Truncated chunk index!");
+
+        tilemap->chunkIndex = reader->data + tilemap->file.indexOffset;
+
+        for (u32 i = 0; i < chunkCount; i++) {
+            TilemapChunkEntry entry;
+            memcpy(&entry, tilemap->chunkIndex + i * sizeof(entry), sizeof(entry));
+            assert((entry.size == 0 || entry.size == s->chunkBytes) && "[ERROR] Bad chunk size!");
+            assert((u64)entry.offset + entry.size <= reader->size && "[ERROR] Truncated chunk data!");
+        }
+        return;
+    }
+
+    // v1: layers stay in the source buffer and are cut into chunks on demand
+    tilemap->layerData = reader->data + reader->offset;
+
+    for (u32 i = 0; i < h->layerCount; i++)
+    {
+        u32 width, height;
+        ReadExact(reader, &width,  sizeof(u32));
+        ReadExact(reader, &height, sizeof(u32));
+        assert(width == h->width && height == h->height && "[ERROR] Layer size differs from map size!");
+
+        const u32 cellBytes = width * height * sizeof(u32);
+        assert(reader->offset + cellBytes <= reader->size && "[ERROR] Failed to read file!");
+        reader->offset += cellBytes;
     }
 }
 
-void TM_LoadLayers(FILE *file, Tilemap *tilemap)
+// Cooked sections are optional; anything missing or malformed is left NULL and computed live
+void TM_LoadSections(Tilemap *tilemap)
 {
-    tilemap->layers = malloc(tilemap->header.layerCount * sizeof(Layer));
-    assert(tilemap->layers && "[ERROR] Failed to allocate memory for layers!");
+    const u32 offset = tilemap->file.sectionOffset;
+    const AssetData *src = &tilemap->source;
+    if (offset == 0 || (u64)offset + sizeof(u32) > src->size) return;
+
+    u32 count;
+    memcpy(&count, src->data + offset, sizeof(u32));
+    if ((u64)offset + sizeof(u32) + (u64)count * sizeof(TilemapSection) > src->size) return;
 
-    for (u32 i = 0; i < tilemap->header.layerCount; i++)
+    const u32 chunkCount = tilemap->stream->chunksX * tilemap->stream->chunksY;
+
+    for (u32 i = 0; i < count; i++)
     {
-        Layer *layer = &tilemap->layers[i];
+        TilemapSection section;
+        memcpy(&section, src->data + offset + sizeof(u32) + i * sizeof(section), sizeof(section));
+        if ((u64)section.offset + section.size > src->size) continue;
+
+        const u8 *data = src->data + section.offset;
+        if (((uintptr_t)data % _Alignof(TilemapQuad)) != 0) continue;
+
+        if (section.tag == TILEMAP_SECTION_COLLISION && section.size >= sizeof(u32))
+        {
+            u32 rectCount;
+            memcpy(&rectCount, data, sizeof(u32));
+            if (sizeof(u32) + (u64)rectCount * sizeof(TilemapRect) > section.size) continue;
+
+            tilemap->cookedRects     = (const TilemapRect *)(data + sizeof(u32));
+            tilemap->cookedRectCount = rectCount;
+        }
+        else if (section.tag == TILEMAP_SECTION_QUADS)
+        {
+            const u64 rangeBytes = (u64)chunkCount * sizeof(TilemapQuadRange);
+            if (rangeBytes > section.size) continue;
+
+            const TilemapQuadRange *ranges = (const TilemapQuadRange *)data;
+            const u32 quadCount = (u32)((section.size - rangeBytes) / sizeof(TilemapQuad));
+
+            bool valid = true;
+            for (u32 c = 0; c < chunkCount && valid; c++)
+                valid = (u64)ranges[c].first + ranges[c].count <= quadCount && ranges[c].foreground <= ranges[c].count;
+            if (!valid) continue;
+
+            tilemap->cookedRanges    = ranges;
+            tilemap->cookedQuads     = (const TilemapQuad *)(data + rangeBytes);
+            tilemap->cookedQuadCount = quadCount;
+        }
+    }
+}
+
+void TM_LoadChunk(const Tilemap *tilemap, TileChunk *chunk)
+{
+    TileStream *s = tilemap->stream;
+    const u32 index = (u32)(chunk - s->chunks);
+
+    // v3 blobs are used in place; only a misaligned source forces a copy
+    if (tilemap->chunkIndex)
+    {
+        TilemapChunkEntry entry;
+        memcpy(&entry, tilemap->chunkIndex + index * sizeof(entry), sizeof(entry));
+
+        const u8 *blob = tilemap->source.data + entry.offset;
+        if (entry.size == 0) {
+            chunk->data = s->emptyChunk;
+            return;
+        }
+        if (((uintptr_t)blob % _Alignof(u32)) == 0) {
+            chunk->data = (const u32 *)blob;
+            return;
+        }
+    }
+
+    u32 *data = calloc(1, s->chunkBytes);
+    assert(data && "[ERROR] Failed to allocate memory for chunk!");
+
+    chunk->data  = data;
+    chunk->owned = true;
+
+    s->residentCount++;
+    s->residentBytes += s->chunkBytes;
+
+    if (tilemap->chunkIndex)
+    {
+        TilemapChunkEntry entry;
+        memcpy(&entry, tilemap->chunkIndex + index * sizeof(entry), sizeof(entry));
+        memcpy(data, tilemap->source.data + entry.offset, entry.size);
+        return;
+    }
+
+    const TileRect rect  = TM_GetChunkRect(tilemap, chunk);
+    const u32 mapWidth   = tilemap->header.width;
+    const u32 layerBytes = 2 * sizeof(u32) + mapWidth * tilemap->header.height * sizeof(u32);
+    const u32 rowBytes   = (rect.x1 - rect.x0) * sizeof(u32);
+
+    for (u32 l = 0; l < tilemap->header.layerCount; l++)
+    {
+        const u8 *cells = tilemap->layerData + l * layerBytes + 2 * sizeof(u32);
+        u32 *plane      = data + (l << (2 * TILEMAP_CHUNK_SHIFT));
+
+        for (u32 y = rect.y0; y < rect.y1; y++)
+        {
+            u32 *row = plane + ((y - rect.y0) << TILEMAP_CHUNK_SHIFT);
+            memcpy(row, cells + ((size_t)y * mapWidth + rect.x0) * sizeof(u32), rowBytes);
+
+            // v1 layers hold gids; swap them for local ids as the chunk is cut
+            for (u32 x = 0; x < rect.x1 - rect.x0; x++) {
+                if (row[x] != 0) row[x] = TM_FindTileId(tilemap, row[x]);
+            }
+        }
+    }
+}
+
+// Drops tile data for chunks not touched this frame, least recently used first
+void TM_TrimChunks(Tilemap *tilemap)
+{
+    TileStream *s = tilemap->stream;
+    const u32 chunkCount = s->chunksX * s->chunksY;
+
+    while (s->residentBytes > TILEMAP_CHUNK_DATA_BUDGET)
+    {
+        TileChunk *victim = NULL;
+        for (u32 i = 0; i < chunkCount; i++) {
+            TileChunk *c = &s->chunks[i];
+            if (!c->owned || c->modified || c->lastUsed == s->tick) continue;
+            if (!victim || c->lastUsed < victim->lastUsed) victim = c;
+        }
+        if (!victim) break;
+
+        free((void *)victim->data);
+        victim->data  = NULL;
+        victim->owned = false;
+        s->residentCount--;
+        s->residentBytes -= s->chunkBytes;
+    }
+
+    while (s->bakedBytes > TILEMAP_CHUNK_VRAM_BUDGET)
+    {
+        TileChunk *victim = NULL;
+        for (u32 i = 0; i < chunkCount; i++) {
+            TileChunk *c = &s->chunks[i];
+            if (c->canva.id == 0 || c->lastSeen == s->tick) continue;
+            if (!victim || c->lastSeen < victim->lastSeen) victim = c;
+        }
+        if (!victim) break;
+
+        TM_UnloadChunkCanvas(tilemap, victim);
+    }
+}
 
-        ReadExact(file, &layer->width,  sizeof(u32));
-        ReadExact(file, &layer->height, sizeof(u32));
+TileRect TM_GetChunkRect(const Tilemap *tilemap, const TileChunk *chunk)
+{
+    const TileStream *s = tilemap->stream;
+    const u32 index = (u32)(chunk - s->chunks);
+    const u32 x0    = (index % s->chunksX) << TILEMAP_CHUNK_SHIFT;
+    const u32 y0    = (index / s->chunksX) << TILEMAP_CHUNK_SHIFT;
 
-        const u32 cellCount = layer->width * layer->height;
-        layer->data = malloc(sizeof(u32) * cellCount);
-        assert(layer->data && "[ERROR] Failed to allocate memory for layer data!");
+    return (TileRect){
+        .x0 = x0,
+        .y0 = y0,
+        .x1 = x0 + TILEMAP_CHUNK_TILES < tilemap->header.width  ? x0 + TILEMAP_CHUNK_TILES : tilemap->header.width,
+        .y1 = y0 + TILEMAP_CHUNK_TILES < tilemap->header.height ? y0 + TILEMAP_CHUNK_TILES : tilemap->header.height
+    };
+}
+
+static void EmitAutotile(const Tilemap *tilemap, const AutotileKind kind, const u32 mask,
+                         const u32 tileset, const TileDrawInfo *info, TileQuadList *out)
+{
+    const TileAutotileTable *table = tilemap->autotileTable;
+    const TilemapQuadRange range   = table->ranges[kind][mask & 0xFF];
 
-        ReadExact(file, layer->data, cellCount * sizeof(u32));
+    for (u32 i = 0; i < range.count; i++) {
+        const TilemapQuad *q = &table->quads.quads[range.first + i];
+        TM_PushQuad(out, tileset,
+            (Rectangle){ info->src.x + q->srcX, info->src.y + q->srcY, q->srcWidth, q->srcHeight },
+            (Vector2){ info->pos.x + q->dstX, info->pos.y + q->dstY });
     }
 }
 
-void DrawTileById(const Tilemap *tilemap, const TileDrawInfo *info, const u32 x, const u32 y)
+// neighbours is the mask of the tile's rule layer (see NeighbourMask)
+void EmitTileById(const Tilemap *tilemap, const TileDrawInfo *info, const u32 neighbours, TileQuadList *out)
 {
+    const u32 ts = (u32)(info->tileset - tilemap->tilesets);
+
+    // A border edge faces any neighbour that holds a tile other than a border
+    const u32 same     = neighbours & 0xFF;
+    const u32 occupied = neighbours >> 8;
+
     switch (info->type)
     {
-        case TILE_WALL:   TM_DrawTileWall  (tilemap, info->tileset, info->src, info->pos, x, y); break;
-        case TILE_CARPET: TM_DrawTileCarpet(tilemap, info->tileset, info->src, info->pos, x, y); break;
-        case TILE_TABLE:  TM_DrawTileTable (tilemap, info->tileset, info->src, info->pos, x, y); break;
-        case TILE_BORDER: TM_DrawTileBorder(tilemap, info->tileset, info->src, info->pos, x, y); break;
+        case TILE_WALL:   EmitAutotile(tilemap, AUTOTILE_WALL,   same,             ts, info, out); break;
+        case TILE_CARPET: EmitAutotile(tilemap, AUTOTILE_CARPET, same,             ts, info, out); break;
+        case TILE_TABLE:  EmitAutotile(tilemap, AUTOTILE_TABLE,  same,             ts, info, out); break;
+        case TILE_BORDER: EmitAutotile(tilemap, AUTOTILE_BORDER, occupied & ~same, ts, info, out); break;
 
-        default:          DrawTextureRec(info->tileset->texture, info->src, info->pos, WHITE);   break;
+        default:          TM_PushQuad(out, ts, info->src, info->pos);                              break;
     }
 }
 
-TileDrawInfo GetTileDrawInfo(const Tilemap *tilemap, const Layer *layer, const u32 x, const u32 y)
+TileDrawInfo GetTileDrawInfo(const Tilemap *tilemap, const u32 layerIndex, const u32 x, const u32 y)
 {
-    const u32 gid = layer->data[y * layer->width + x];
-    if (gid == 0 || gid > tilemap->maxGid) return (TileDrawInfo){0};
+    const u32 id = TM_GetTileId(tilemap, layerIndex, x, y);
+    if (id == 0 || id > tilemap->tileCount) return (TileDrawInfo){0};
 
-    TileDrawInfo info = tilemap->tileDrawInfoTable[gid];
+    TileDrawInfo info = tilemap->tileDrawInfoTable[id];
     if (!info.tileset) return (TileDrawInfo){0};
 
     info.pos = (Vector2) {
@@ -170,52 +762,640 @@ TileDrawInfo GetTileDrawInfo(const Tilemap *tilemap, const Layer *layer, const u
     return info;
 }
 
-void TM_ReloadCanva(Tilemap *tilemap)
+TileRect TM_GetChunkApron(const Tilemap *tilemap, const TileChunk *chunk)
+{
+    const TilemapHeader *h = &tilemap->header;
+    const TileRect rect    = TM_GetChunkRect(tilemap, chunk);
+
+    // Autotiles reach up to one tile into their neighbours, so a bake also draws
+    // the ring of tiles around the chunk and lets the render target clip them.
+    return (TileRect){
+        .x0 = rect.x0 > 0 ? rect.x0 - 1 : 0,
+        .y0 = rect.y0 > 0 ? rect.y0 - 1 : 0,
+        .x1 = rect.x1 < h->width  ? rect.x1 + 1 : h->width,
+        .y1 = rect.y1 < h->height ? rect.y1 + 1 : h->height
+    };
+}
+
+// Edits need a private copy of chunks that are views into the source or the shared empty chunk
+u32 *TM_GetWritableChunk(const Tilemap *tilemap, TileChunk *chunk)
+{
+    TileStream *s = tilemap->stream;
+
+    if (!chunk->data) TM_LoadChunk(tilemap, chunk);
+    chunk->lastUsed = s->tick;
+    chunk->modified = true;
+
+    if (chunk->owned) return (u32 *)chunk->data;
+
+    u32 *copy = malloc(s->chunkBytes);
+    assert(copy && "[ERROR] Failed to allocate memory for chunk!");
+    memcpy(copy, chunk->data, s->chunkBytes);
+
+    chunk->data  = copy;
+    chunk->owned = true;
+
+    s->residentCount++;
+    s->residentBytes += s->chunkBytes;
+    return copy;
+}
+
+static Camera2D GetChunkCamera(const Tilemap *tilemap, const TileRect rect)
+{
+    return (Camera2D){
+        .target = { (float)(rect.x0 * tilemap->header.tileWidth), (float)(rect.y0 * tilemap->header.tileHeight) },
+        .zoom   = 1.0f
+    };
+}
+
+// cells pick new quads, and those reach one tile further; every chunk within that
+// reach redraws it and stops trusting its cooked draw list
+void TM_MarkDirty(const Tilemap *tilemap, const TileRect cells)
 {
     const TilemapHeader *h = &tilemap->header;
+    TileStream *s          = tilemap->stream;
+
+    const TileRect reach = {
+        .x0 = cells.x0 > 0 ? cells.x0 - 1 : 0,
+        .y0 = cells.y0 > 0 ? cells.y0 - 1 : 0,
+        .x1 = cells.x1 < h->width  ? cells.x1 + 1 : h->width,
+        .y1 = cells.y1 < h->height ? cells.y1 + 1 : h->height
+    };
 
-    tilemap->canva = LoadRenderTexture(h->width * h->tileWidth, h->height * h->tileHeight);
+    for (u32 cy = reach.y0 >> TILEMAP_CHUNK_SHIFT; cy <= (reach.y1 - 1) >> TILEMAP_CHUNK_SHIFT; cy++) {
+        for (u32 cx = reach.x0 >> TILEMAP_CHUNK_SHIFT; cx <= (reach.x1 - 1) >> TILEMAP_CHUNK_SHIFT; cx++)
+        {
+            TileChunk *chunk = &s->chunks[cy * s->chunksX + cx];
+            chunk->modified  = true;
+            if (chunk->canva.id == 0) continue;
+
+            const TileRect rect = TM_GetChunkRect(tilemap, chunk);
+            const TileRect clip = {
+                .x0 = reach.x0 > rect.x0 ? reach.x0 : rect.x0,
+                .y0 = reach.y0 > rect.y0 ? reach.y0 : rect.y0,
+                .x1 = reach.x1 < rect.x1 ? reach.x1 : rect.x1,
+                .y1 = reach.y1 < rect.y1 ? reach.y1 : rect.y1
+            };
+
+            TileRect *d = &chunk->dirty;
+            if (d->x0 == d->x1) {
+                *d = clip;
+                s->dirtyCount++;
+                continue;
+            }
+
+            if (clip.x0 < d->x0) d->x0 = clip.x0;
+            if (clip.y0 < d->y0) d->y0 = clip.y0;
+            if (clip.x1 > d->x1) d->x1 = clip.x1;
+            if (clip.y1 > d->y1) d->y1 = clip.y1;
+        }
+    }
+}
 
-    BeginTextureMode(tilemap->canva);
+static RenderTexture2D LoadChunkCanvas(const Tilemap *tilemap, const TileRect rect)
+{
+    TileStream *s = tilemap->stream;
+    const RenderTexture2D canvas = LoadRenderTexture((int)((rect.x1 - rect.x0) * tilemap->header.tileWidth),
+                                                     (int)((rect.y1 - rect.y0) * tilemap->header.tileHeight));
+    s->bakedBytes += (u64)canvas.texture.width * canvas.texture.height * 4;
+
+    BeginTextureMode(canvas);
         ClearBackground(BLANK);
-        TM_DrawOnCanva(tilemap);
     EndTextureMode();
+
+    return canvas;
 }
 
-void TM_DrawOnCanva(const Tilemap *tilemap)
+void TM_UnloadChunkCanvas(const Tilemap *tilemap, TileChunk *chunk)
 {
-    DrawNonBorderTiles(tilemap);
-    DrawBorderTiles(tilemap);
+    TileStream *s = tilemap->stream;
+    RenderTexture2D *canvases[CHUNK_CANVAS_COUNT * TILEMAP_CANVAS_LEVELS];
+    for (u32 c = 0; c < CHUNK_CANVAS_COUNT; c++) {
+        canvases[c * TILEMAP_CANVAS_LEVELS] = TM_GetChunkCanvas(chunk, (ChunkCanvas)c);
+        for (u32 l = 0; l < TILEMAP_CANVAS_LEVELS - 1; l++)
+            canvases[c * TILEMAP_CANVAS_LEVELS + 1 + l] = &chunk->mips[c][l];
+    }
+
+    for (u32 i = 0; i < CHUNK_CANVAS_COUNT * TILEMAP_CANVAS_LEVELS; i++) {
+        if (canvases[i]->id == 0) continue;
+        s->bakedBytes -= (u64)canvases[i]->texture.width * canvases[i]->texture.height * 4;
+        UnloadRenderTexture(*canvases[i]);
+        *canvases[i] = (RenderTexture2D){0};
+    }
+
+    free(chunk->anims);
+    chunk->anims     = NULL;
+    chunk->animCount = 0;
+    s->bakedCount--;
 }
 
-void DrawNonBorderTiles(const Tilemap *tilemap)
+// Walls and borders look at layer 0, tables and carpets at layer 1, whatever layer they sit on
+static u32 NeighbourMask(const Tilemap *tilemap, const TileNeighbourPlanes *planes,
+                         const u32 layer, const u32 cell, const TileType type)
 {
-    for (u32 l = 0; l < tilemap->header.layerCount; l++)
+    const u32 ruleLayer = (type == TILE_TABLE || type == TILE_CARPET) ? 1 : 0;
+    if (ruleLayer == layer) return planes->masks[(size_t)layer * planes->capacity + cell];
+    if (ruleLayer >= tilemap->header.layerCount) return 0;
+
+    const u32 *ids   = planes->ids + (size_t)ruleLayer * planes->capacity;
+    const u32 stride = planes->stride;
+    const u32 n[8]   = { cell - stride, cell - stride + 1, cell + 1, cell + stride + 1,
+                         cell + stride, cell + stride - 1, cell - 1, cell - stride - 1 };
+
+    u32 mask = 0;
+    for (u32 b = 0; b < 8; b++) {
+        mask |= (u32)(GetCellType(tilemap, ids[n[b]]) == type) << b;
+        mask |= (u32)(ids[n[b]] != 0) << (b + 8);
+    }
+    return mask;
+}
+
+static TileDrawInfo GetPlaneDrawInfo(const Tilemap *tilemap, const u32 id, const u32 x, const u32 y)
+{
+    if (id == 0 || id > tilemap->tileCount) return (TileDrawInfo){0};
+
+    TileDrawInfo info = tilemap->tileDrawInfoTable[id];
+    if (!info.tileset) return (TileDrawInfo){0};
+
+    info.pos = (Vector2){ (float)x * (float)tilemap->header.tileWidth, (float)y * (float)tilemap->header.tileHeight };
+    return info;
+}
+
+// Animated cells are drawn live, and so is anything of their pass stacked on one. The
+// exception is the background's animLayer: its cells go between the two canvases and
+// the OVER canvas already holds what sits on them.
+static bool IsLiveCell(const Tilemap *tilemap, const TileNeighbourPlanes *planes, const u32 layer,
+                       const u32 cell, const bool foreground, const u32 animLayer)
+{
+    if (!tilemap->hasAnimatedTiles || animLayer == TILEMAP_ANIM_STILLS) return false;
+
+    for (u32 l = 0; l <= layer; l++)
     {
-        const Layer *layer = &tilemap->layers[l];
+        const u32 id = planes->ids[(size_t)l * planes->capacity + cell];
+        if (id == 0 || id > tilemap->tileCount) continue;
+
+        const TileDrawInfo *info = &tilemap->tileDrawInfoTable[id];
+        if (!info->tileset || info->frames <= 1 || info->foreground != foreground) continue;
+        if (l == layer || foreground || l != animLayer) return true;
+    }
+    return false;
+}
+
+static bool AnimCellBefore(const TileAnimCell *a, const TileAnimCell *b)
+{
+    if (a->foreground != b->foreground) return a->foreground < b->foreground;
+    if (a->layer != b->layer)           return a->layer < b->layer;
+    return a->tileset <= b->tileset;
+}
+
+// Keeps the cells sorted by (foreground, layer, tileset) as they come in layer order
+static void PushAnimCell(TileChunk *chunk, u32 *capacity, const TileAnimCell cell)
+{
+    if (chunk->animCount == *capacity) {
+        *capacity = *capacity == 0 ? 16 : *capacity * 2;
+        TileAnimCell *tmp = realloc(chunk->anims, *capacity * sizeof(TileAnimCell));
+        assert(tmp && "[ERROR] Failed to realloc animated cells");
+        chunk->anims = tmp;
+    }
+
+    u32 at = chunk->animCount++;
+    while (at > 0 && !AnimCellBefore(&chunk->anims[at - 1], &cell)) {
+        chunk->anims[at] = chunk->anims[at - 1];
+        at--;
+    }
+    chunk->anims[at] = cell;
+}
+
+// Animated cells stay out of the bake; the chunk keeps them in draw order instead, along
+// with the quads of the still cells stacked on them, which must stay on top. Cells on the
+// lowest animated background layer go between the two background canvases (the bake
+// splits there), every other one after the last canvas of its pass. Cells of one layer
+// never overlap, so within a layer they are grouped by tileset and batch like a bake.
+void TM_CollectAnimatedCells(const Tilemap *tilemap, TileChunk *chunk)
+{
+    const u32 layerCount = tilemap->header.layerCount;
+    u32 capacity         = chunk->animCount;
+
+    chunk->animLayer = layerCount;
+    chunk->animCount = 0;
+    if (!tilemap->hasAnimatedTiles) return;
 
-        for (u32 y = 0; y < layer->height; y++) {
-            for (u32 x = 0; x < layer->width; x++) {
-                TileDrawInfo info = GetTileDrawInfo(tilemap, layer, x, y);
-                if (info.type == TILE_NONE || info.type == TILE_BORDER) continue;
-                DrawTileById(tilemap, &info, x, y);
+    const TileRect rect = TM_GetChunkRect(tilemap, chunk);
+
+    for (u32 l = 0; l < layerCount && chunk->animLayer == layerCount; l++) {
+        for (u32 y = rect.y0; y < rect.y1 && chunk->animLayer == layerCount; y++) {
+            for (u32 x = rect.x0; x < rect.x1; x++) {
+                const TileDrawInfo info = GetTileDrawInfo(tilemap, l, x, y);
+                if (info.frames > 1 && !info.foreground) { chunk->animLayer = l; break; }
+            }
+        }
+    }
+
+    TileStream *s               = tilemap->stream;
+    TileNeighbourPlanes *planes = &s->neighbours;
+    TM_BuildNeighbourPlanes(tilemap, rect, planes);
+
+    for (u32 l = 0; l < layerCount; l++)
+    {
+        const u32 *ids = planes->ids + (size_t)l * planes->capacity;
+
+        for (u32 y = rect.y0; y < rect.y1; y++) {
+            for (u32 x = rect.x0; x < rect.x1; x++)
+            {
+                const u32 cell    = (y - rect.y0 + 1) * planes->stride + (x - rect.x0 + 1);
+                TileDrawInfo info = GetPlaneDrawInfo(tilemap, ids[cell], x, y);
+                if (info.type == TILE_NONE) continue;
+                if (!IsLiveCell(tilemap, planes, l, cell, info.foreground, chunk->animLayer)) continue;
+
+                const u32 ts = (u32)(info.tileset - tilemap->tilesets);
+                if (info.frames > 1) {
+                    PushAnimCell(chunk, &capacity, (TileAnimCell){
+                        .pos = info.pos, .localId = ids[cell], .tileset = ts, .layer = l, .foreground = info.foreground
+                    });
+                    continue;
+                }
+
+                // A still cell keeps its autotile quads; the bake's scratch list is free until it starts
+                s->scratch.count = 0;
+                EmitTileById(tilemap, &info, NeighbourMask(tilemap, planes, l, cell, info.type), &s->scratch);
+                for (u32 i = 0; i < s->scratch.count; i++) {
+                    const TilemapQuad *q = &s->scratch.quads[i];
+                    PushAnimCell(chunk, &capacity, (TileAnimCell){
+                        .src        = { q->srcX, q->srcY, q->srcWidth, q->srcHeight },
+                        .pos        = { q->dstX, q->dstY },
+                        .tileset    = q->tileset,
+                        .layer      = l,
+                        .foreground = info.foreground
+                    });
+                }
             }
         }
     }
+    s->scratch.count = 0;
 }
 
-void DrawBorderTiles(const Tilemap *tilemap)
+void TM_DrawAnimatedCells(const Tilemap *tilemap, const TileChunk *chunk, const bool foreground, const bool overCanvas)
 {
-    for (u32 l = 0; l < tilemap->header.layerCount; l++)
+    const u32 ticks = (u32)(tilemap->animTime * 100.0f);
+
+    for (u32 i = 0; i < chunk->animCount; i++)
+    {
+        const TileAnimCell *cell = &chunk->anims[i];
+        if (cell->foreground != foreground) continue;
+        if (!foreground && (cell->layer != chunk->animLayer) != overCanvas) continue;
+
+        if (cell->localId == 0) {
+            DrawTextureRec(tilemap->tilesets[cell->tileset].texture, cell->src, cell->pos, WHITE);
+            continue;
+        }
+
+        const TileDrawInfo *first = &tilemap->tileDrawInfoTable[cell->localId];
+        const u32 id = cell->localId + (ticks / first->frameTime) % first->frames;
+        if (id > tilemap->tileCount || tilemap->tileDrawInfoTable[id].tileset != first->tileset) continue;
+
+        DrawTextureRec(first->tileset->texture, tilemap->tileDrawInfoTable[id].src, cell->pos, WHITE);
+    }
+}
+
+// Draws quads into canvas, limited to the clip tiles when clip is not empty
+static void DrawChunkQuads(const Tilemap *tilemap, const RenderTexture2D canvas, const TileRect rect,
+                           const TileRect clip, const TilemapQuad *quads, const u32 count)
+{
+    const TilemapHeader *h = &tilemap->header;
+    const bool clipped     = clip.x0 != clip.x1;
+
+    BeginTextureMode(canvas);
+        if (clipped) {
+            BeginScissorMode((int)((clip.x0 - rect.x0) * h->tileWidth), (int)((clip.y0 - rect.y0) * h->tileHeight),
+                             (int)((clip.x1 - clip.x0) * h->tileWidth), (int)((clip.y1 - clip.y0) * h->tileHeight));
+        }
+        ClearBackground(BLANK);
+        BeginMode2D(GetChunkCamera(tilemap, rect));
+            TM_DrawQuads(tilemap, quads, count);
+        EndMode2D();
+        if (clipped) EndScissorMode();
+    EndTextureMode();
+}
+
+// Draws source into a blank target of any size with the premultiply blend, which copies
+// texels, alpha included, instead of blending them a second time. A bilinear draw at exactly
+// half size lands every sample on the corner of a 2x2 texel block, so each step is a box filter.
+static void DownsampleCanvas(const RenderTexture2D source, const RenderTexture2D target, const Rectangle dst)
+{
+    const Rectangle src = { 0.0f, 0.0f, (float)source.texture.width, -(float)source.texture.height };
+
+    SetTextureFilter(source.texture, TEXTURE_FILTER_BILINEAR);
+    BeginTextureMode(target);
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+            DrawTexturePro(source.texture, src, dst, (Vector2){0}, 0.0f, WHITE);
+        EndBlendMode();
+    EndTextureMode();
+    SetTextureFilter(source.texture, TEXTURE_FILTER_POINT);
+}
+
+// Rebuilds the smaller levels of one of a chunk's canvases from the full size one
+static void BuildCanvasMips(const Tilemap *tilemap, TileChunk *chunk, const ChunkCanvas which)
+{
+    TileStream *s               = tilemap->stream;
+    const RenderTexture2D *prev = TM_GetChunkCanvas(chunk, which);
+
+    for (u32 l = 0; l < TILEMAP_CANVAS_LEVELS - 1; l++)
+    {
+        RenderTexture2D *mip = &chunk->mips[which][l];
+        const int w = prev->texture.width  / 2;
+        const int h = prev->texture.height / 2;
+
+        if (mip->id == 0) {
+            *mip = LoadRenderTexture(w, h);
+            s->bakedBytes += (u64)w * h * 4;
+        }
+
+        BeginTextureMode(*mip);
+            ClearBackground(BLANK);
+        EndTextureMode();
+        DownsampleCanvas(*prev, *mip, (Rectangle){ 0.0f, 0.0f, (float)w, (float)h });
+        prev = mip;
+    }
+}
+
+// Redraws the chunk's part of the overview from its smallest levels
+static void UpdateOverview(const Tilemap *tilemap, const TileChunk *chunk)
+{
+    const TilemapHeader *h = &tilemap->header;
+    TileStream *s          = tilemap->stream;
+    const TileRect rect    = TM_GetChunkRect(tilemap, chunk);
+
+    if (s->overview.id == 0) {
+        const u64 width  = (u64)h->width  * h->tileWidth;
+        const u64 height = (u64)h->height * h->tileHeight;
+
+        u32 shift = TILEMAP_OVERVIEW_SHIFT;
+        while ((width >> shift) > TILEMAP_OVERVIEW_MAX_SIZE || (height >> shift) > TILEMAP_OVERVIEW_MAX_SIZE) shift++;
+
+        s->overviewShift = shift;
+        s->overview      = LoadRenderTexture((int)(width >> shift), (int)(height >> shift));
+        s->bakedBytes   += (u64)s->overview.texture.width * s->overview.texture.height * 4;
+        BeginTextureMode(s->overview);
+            ClearBackground(BLANK);
+        EndTextureMode();
+    }
+
+    const u32 shift     = s->overviewShift;
+    const Rectangle dst = {
+        (float)((rect.x0 * h->tileWidth)  >> shift),
+        (float)((rect.y0 * h->tileHeight) >> shift),
+        (float)(((rect.x1 - rect.x0) * h->tileWidth)  >> shift),
+        (float)(((rect.y1 - rect.y0) * h->tileHeight) >> shift)
+    };
+
+    BeginTextureMode(s->overview);
+        BeginScissorMode((int)dst.x, (int)dst.y, (int)dst.width, (int)dst.height);
+            ClearBackground(BLANK);
+        EndScissorMode();
+    EndTextureMode();
+
+    DownsampleCanvas(chunk->mips[CHUNK_CANVAS_BELOW][TILEMAP_CANVAS_LEVELS - 2], s->overview, dst);
+
+    // The rest of the background, then the foreground, go over it with the regular blend
+    const ChunkCanvas layered[] = { CHUNK_CANVAS_OVER, CHUNK_CANVAS_ABOVE };
+    for (u32 i = 0; i < sizeof(layered) / sizeof(layered[0]); i++)
     {
-        const Layer *layer = &tilemap->layers[l];
+        if (TM_GetChunkCanvas((TileChunk *)chunk, layered[i])->id == 0) continue;
+
+        const RenderTexture2D mip = chunk->mips[layered[i]][TILEMAP_CANVAS_LEVELS - 2];
+        const Rectangle src = { 0.0f, 0.0f, (float)mip.texture.width, -(float)mip.texture.height };
+
+        SetTextureFilter(mip.texture, TEXTURE_FILTER_BILINEAR);
+        BeginTextureMode(s->overview);
+            DrawTexturePro(mip.texture, src, dst, (Vector2){0}, 0.0f, WHITE);
+        EndTextureMode();
+        SetTextureFilter(mip.texture, TEXTURE_FILTER_POINT);
+    }
+}
+
+// Clears the dirty tiles of a baked chunk and draws back every quad that touches them
+void TM_RebakeDirty(const Tilemap *tilemap, TileChunk *chunk)
+{
+    TRACE_ZONE("TM_RebakeDirty");
 
-        for (u32 y = 0; y < layer->height; y++) {
-            for (u32 x = 0; x < layer->width; x++) {
-                TileDrawInfo info = GetTileDrawInfo(tilemap, layer, x, y);
-                if (info.type != TILE_BORDER) continue;
-                DrawTileById(tilemap, &info, x, y);
+    const TilemapHeader *h = &tilemap->header;
+    TileStream *s          = tilemap->stream;
+    const TileRect rect    = TM_GetChunkRect(tilemap, chunk);
+    TileRect dirty         = chunk->dirty;
+
+    chunk->dirty = (TileRect){0};
+    if (chunk->canva.id == 0) return;
+
+    // Moving the split moves every cell between the canvases, not just the edited ones
+    const u32 animLayer = chunk->animLayer;
+    TM_CollectAnimatedCells(tilemap, chunk);
+    if (chunk->animLayer != animLayer) dirty = rect;
+
+    s->scratch.count = 0;
+    u32 over = 0;
+    const u32 above = TM_CollectQuads(tilemap, (TileRect){
+        .x0 = dirty.x0 > 0 ? dirty.x0 - 1 : 0,
+        .y0 = dirty.y0 > 0 ? dirty.y0 - 1 : 0,
+        .x1 = dirty.x1 < h->width  ? dirty.x1 + 1 : h->width,
+        .y1 = dirty.y1 < h->height ? dirty.y1 + 1 : h->height
+    }, chunk->animLayer, &s->scratch, &over);
+    const u32 below = s->scratch.count - above - over;
+
+    DrawChunkQuads(tilemap, chunk->canva, rect, dirty, s->scratch.quads, below);
+
+    if (over > 0 && chunk->canvaOver.id == 0) chunk->canvaOver = LoadChunkCanvas(tilemap, rect);
+    if (chunk->canvaOver.id != 0)
+        DrawChunkQuads(tilemap, chunk->canvaOver, rect, dirty, s->scratch.quads + below, over);
+
+    if (above > 0 && chunk->canvaAbove.id == 0) chunk->canvaAbove = LoadChunkCanvas(tilemap, rect);
+    if (chunk->canvaAbove.id != 0)
+        DrawChunkQuads(tilemap, chunk->canvaAbove, rect, dirty, s->scratch.quads + below + over, above);
+
+    // The smaller levels are cheap next to the redraw, so they are rebuilt whole
+    for (u32 c = 0; c < CHUNK_CANVAS_COUNT; c++) {
+        if (TM_GetChunkCanvas(chunk, (ChunkCanvas)c)->id != 0) BuildCanvasMips(tilemap, chunk, (ChunkCanvas)c);
+    }
+    UpdateOverview(tilemap, chunk);
+}
+
+void TM_BakeChunk(const Tilemap *tilemap, TileChunk *chunk)
+{
+    TileStream *s          = tilemap->stream;
+    const TileRect rect    = TM_GetChunkRect(tilemap, chunk);
+
+    const TilemapQuad *quads = NULL;
+    u32 quadCount = 0;
+    u32 above     = 0;
+    u32 over      = 0;
+
+    TM_CollectAnimatedCells(tilemap, chunk);
+
+    // Cooked quads are grouped for a bake without animated cells
+    if (tilemap->cookedRanges && !chunk->modified && chunk->animCount == 0) {
+        const TilemapQuadRange range = tilemap->cookedRanges[chunk - s->chunks];
+        quads     = tilemap->cookedQuads + range.first;
+        quadCount = range.count;
+        above     = range.foreground;
+    }
+    else {
+        s->scratch.count = 0;
+        above     = TM_CollectQuads(tilemap, TM_GetChunkApron(tilemap, chunk), chunk->animLayer, &s->scratch, &over);
+        quads     = s->scratch.quads;
+        quadCount = s->scratch.count;
+    }
+
+    const u32 below = quadCount - above - over;
+
+    chunk->dirty = (TileRect){0};
+    chunk->canva = LoadChunkCanvas(tilemap, rect);
+    s->bakedCount++;
+    DrawChunkQuads(tilemap, chunk->canva, rect, (TileRect){0}, quads, below);
+    BuildCanvasMips(tilemap, chunk, CHUNK_CANVAS_BELOW);
+
+    // Only chunks with animated water and something on top of it need the middle canvas
+    if (over > 0) {
+        chunk->canvaOver = LoadChunkCanvas(tilemap, rect);
+        DrawChunkQuads(tilemap, chunk->canvaOver, rect, (TileRect){0}, quads + below, over);
+        BuildCanvasMips(tilemap, chunk, CHUNK_CANVAS_OVER);
+    }
+
+    // Most chunks have nothing above the player and keep a single canvas
+    if (above > 0) {
+        chunk->canvaAbove = LoadChunkCanvas(tilemap, rect);
+        DrawChunkQuads(tilemap, chunk->canvaAbove, rect, (TileRect){0}, quads + below + over, above);
+        BuildCanvasMips(tilemap, chunk, CHUNK_CANVAS_ABOVE);
+    }
+
+    UpdateOverview(tilemap, chunk);
+}
+
+void TM_PushQuad(TileQuadList *list, const u32 tileset, const Rectangle src, const Vector2 dst)
+{
+    if (list->count >= list->capacity) {
+        list->capacity = list->capacity == 0 ? 256 : list->capacity * 2;
+        TilemapQuad *tmp = realloc(list->quads, list->capacity * sizeof(TilemapQuad));
+        assert(tmp && "[ERROR] Failed to realloc tile quads");
+        list->quads = tmp;
+    }
+
+    list->quads[list->count++] = (TilemapQuad){
+        .srcX = src.x, .srcY = src.y, .srcWidth = src.width, .srcHeight = src.height,
+        .dstX = dst.x, .dstY = dst.y,
+        .tileset = tileset
+    };
+}
+
+void TM_DrawQuads(const Tilemap *tilemap, const TilemapQuad *quads, const u32 count)
+{
+    TRACE_ZONE("TM_DrawQuads");
+
+    // raylib keeps appending to one batch until the texture changes, so a run of quads
+    // from one tileset goes out as a single draw call
+    for (u32 i = 0; i < count; i++)
+    {
+        const TilemapQuad *q = &quads[i];
+        if (q->tileset >= tilemap->header.tilesetCount) continue;
+
+        DrawTextureRec(tilemap->tilesets[q->tileset].texture,
+                       (Rectangle){ q->srcX, q->srcY, q->srcWidth, q->srcHeight },
+                       (Vector2){ q->dstX, q->dstY }, WHITE);
+    }
+
+    TileStream *s = tilemap->stream;
+    s->bakeQuads   += count;
+    s->bakeBatches += TM_CountBatches(quads, count);
+}
+
+u32 TM_CountBatches(const TilemapQuad *quads, const u32 count)
+{
+    u32 batches = 0;
+    for (u32 i = 0; i < count; i++) {
+        if (i == 0 || quads[i].tileset != quads[i - 1].tileset) batches++;
+    }
+    return batches;
+}
+
+// Resolves every tile in rect to the sub-tile quads the autotile rules pick in one traversal,
+// then groups them by tileset so each run is one batch. The sort is stable and keyed on
+// (group, border pass, layer, tileset): borders still draw after everything else in their
+// group and layers keep their order, only tilesets within a layer are regrouped. The groups
+// are the background below animLayer, the background from animLayer up and the foreground;
+// the cells TM_CollectAnimatedCells draws live are left out, unless animLayer is
+// TILEMAP_ANIM_STILLS, which bakes animated tiles as their first frame.
+// Returns how many of the appended quads are foreground; they come last, right after the
+// outOver background quads from animLayer up.
+u32 TM_CollectQuads(const Tilemap *tilemap, const TileRect rect, const u32 animLayer,
+                    TileQuadList *out, u32 *outOver)
+{
+    TRACE_ZONE("TM_CollectQuads");
+
+    TileStream *s               = tilemap->stream;
+    TileNeighbourPlanes *planes = &s->neighbours;
+    TileQuadList *mapOrder      = &s->mapOrder;
+    const u32 layerCount        = tilemap->header.layerCount;
+    const u32 tilesetCount      = tilemap->header.tilesetCount;
+    const u32 keyCount          = 6 * layerCount * tilesetCount;
+
+    if (outOver) *outOver = 0;
+    TM_BuildNeighbourPlanes(tilemap, rect, planes);
+    mapOrder->count = 0;
+
+    for (u32 l = 0; l < layerCount; l++)
+    {
+        const u32 *ids = planes->ids + (size_t)l * planes->capacity;
+
+        for (u32 y = rect.y0; y < rect.y1; y++) {
+            for (u32 x = rect.x0; x < rect.x1; x++)
+            {
+                const u32 cell    = (y - rect.y0 + 1) * planes->stride + (x - rect.x0 + 1);
+                TileDrawInfo info = GetPlaneDrawInfo(tilemap, ids[cell], x, y);
+                if (info.type == TILE_NONE) continue;
+                if (IsLiveCell(tilemap, planes, l, cell, info.foreground, animLayer)) continue;
+
+                const u32 first    = mapOrder->count;
+                const u32 capacity = mapOrder->capacity;
+                EmitTileById(tilemap, &info, NeighbourMask(tilemap, planes, l, cell, info.type), mapOrder);
+
+                if (mapOrder->capacity != capacity) {
+                    u32 *tmp = realloc(s->quadKeys, mapOrder->capacity * sizeof(u32));
+                    assert(tmp && "[ERROR] Failed to realloc tile quad keys");
+                    s->quadKeys = tmp;
+                }
+
+                const u32 group = info.foreground ? 2 : (l >= animLayer ? 1 : 0);
+                const u32 pass  = group * 2 + (info.type == TILE_BORDER ? 1 : 0);
+                const u32 key  = (pass * layerCount + l) * tilesetCount + (u32)(info.tileset - tilemap->tilesets);
+                for (u32 i = first; i < mapOrder->count; i++) s->quadKeys[i] = key;
             }
         }
     }
+
+    if (mapOrder->count == 0) return 0;
+    s->mapOrderBatches += TM_CountBatches(mapOrder->quads, mapOrder->count);
+
+    // Counting sort, stable
+    u32 *counts = realloc(s->keyCounts, (keyCount + 1) * sizeof(u32));
+    assert(counts && "[ERROR] Failed to realloc tile quad keys");
+    s->keyCounts = counts;
+    memset(counts, 0, (keyCount + 1) * sizeof(u32));
+
+    for (u32 i = 0; i < mapOrder->count; i++) counts[s->quadKeys[i] + 1]++;
+    for (u32 k = 0; k < keyCount; k++) counts[k + 1] += counts[k];
+
+    const u32 base = out->count;
+    while (out->capacity < base + mapOrder->count) {
+        out->capacity = out->capacity == 0 ? 256 : out->capacity * 2;
+        TilemapQuad *tmp = realloc(out->quads, out->capacity * sizeof(TilemapQuad));
+        assert(tmp && "[ERROR] Failed to realloc tile quads");
+        out->quads = tmp;
+    }
+
+    for (u32 i = 0; i < mapOrder->count; i++)
+        out->quads[base + counts[s->quadKeys[i]]++] = mapOrder->quads[i];
+    out->count = base + mapOrder->count;
+
+    // After the scatter counts[k] is where key k + 1 starts
+    const u32 groupKeys = keyCount / 3;
+    if (outOver) *outOver = counts[2 * groupKeys - 1] - counts[groupKeys - 1];
+    return mapOrder->count - counts[2 * groupKeys - 1];
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "ivy/trace.h"
+
+#if defined(IVY_ENABLE_TRACE)
+
+#include "ivy/platform.h"
+#include "raylib/raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TRACE_EVENT_MASK (TRACE_EVENTS_PER_THREAD - 1)
+
+typedef struct {
+    const char *name;       // NULL for an end event
+    u64         timestamp;
+} TraceEvent;
+
+// Written only by its owning thread; the dump reads it without stopping the writer,
+// so a zone being recorded during the dump may come out torn.
+typedef struct {
+    TraceEvent  events[TRACE_EVENTS_PER_THREAD];
+    u32         count;      // total events written, the ring keeps the last TRACE_EVENTS_PER_THREAD
+    const char *threadName;
+    u32         exited;     // its thread returned; the next new thread takes it over
+} TraceBuffer;
+
+static TraceBuffer     *buffers[TRACE_MAX_THREADS];
+static u32              bufferCount;
+static u64              epoch;
+static u32              droppedReported;
+static __thread TraceBuffer *threadBuffer;
+static __thread bool         threadDropped;
+
+static TraceBuffer *GetThreadBuffer(void)
+{
+    if (threadBuffer || threadDropped) return threadBuffer;
+
+    const u32 taken = __atomic_load_n(&bufferCount, __ATOMIC_ACQUIRE);
+    for (u32 i = 0; i < taken && i < TRACE_MAX_THREADS; i++)
+    {
+        TraceBuffer *b = __atomic_load_n(&buffers[i], __ATOMIC_ACQUIRE);
+        u32 exited     = 1;
+        if (!b || !__atomic_compare_exchange_n(&b->exited, &exited, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            continue;
+
+        threadBuffer = b;
+        return b;
+    }
+
+    const u32 index = __atomic_fetch_add(&bufferCount, 1, __ATOMIC_ACQ_REL);
+    if (index >= TRACE_MAX_THREADS) {
+        threadDropped = true;
+        if (!__atomic_exchange_n(&droppedReported, 1, __ATOMIC_ACQ_REL))
+            TraceLog(LOG_WARNING, "TRACE: More than %d threads alive at once, the rest are not recorded", TRACE_MAX_THREADS);
+        return NULL;
+    }
+
+    u64 expected = 0;
+    __atomic_compare_exchange_n(&epoch, &expected, GetMonotonicMicros(), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+
+    threadBuffer = calloc(1, sizeof(TraceBuffer));
+    if (!threadBuffer) {
+        threadDropped = true;
+        return NULL;
+    }
+
+    __atomic_store_n(&buffers[index], threadBuffer, __ATOMIC_RELEASE);
+    return threadBuffer;
+}
+
+static void Record(const char *name)
+{
+    TraceBuffer *b = GetThreadBuffer();
+    if (!b) return;
+
+    const u32 count = b->count;
+    b->events[count & TRACE_EVENT_MASK] = (TraceEvent){ name, GetMonotonicMicros() };
+    __atomic_store_n(&b->count, count + 1, __ATOMIC_RELEASE);
+}
+
+void TraceBegin(const char *name)
+{
+    Record(name);
+}
+
+void TraceEnd(void)
+{
+    Record(NULL);
+}
+
+void TraceSetThreadName(const char *name)
+{
+    TraceBuffer *b = GetThreadBuffer();
+    if (b) b->threadName = name;
+}
+
+void TraceThreadExit(void)
+{
+    if (!threadBuffer) return;
+
+    __atomic_store_n(&threadBuffer->exited, 1, __ATOMIC_RELEASE);
+    threadBuffer = NULL;
+}
+
+// Zone names come from literals, so only quotes and backslashes need escaping
+static void WriteName(FILE *file, const char *name)
+{
+    for (const char *c = name; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        fputc(*c, file);
+    }
+}
+
+bool DumpTrace(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+
+    const u32 threadCount = __atomic_load_n(&bufferCount, __ATOMIC_ACQUIRE);
+    const u64 start       = __atomic_load_n(&epoch, __ATOMIC_ACQUIRE);
+    bool first = true;
+    u32 written = 0;
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+
+    for (u32 t = 0; t < threadCount && t < TRACE_MAX_THREADS; t++)
+    {
+        const TraceBuffer *b = __atomic_load_n(&buffers[t], __ATOMIC_ACQUIRE);
+        if (!b) continue;
+
+        if (b->threadName) {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", first ? "" : ",\n", t);
+            WriteName(file, b->threadName);
+            fputs("\"}}", file);
+            first = false;
+        }
+
+        const u32 count = __atomic_load_n(&b->count, __ATOMIC_ACQUIRE);
+        const u32 begin = count > TRACE_EVENTS_PER_THREAD ? count - TRACE_EVENTS_PER_THREAD : 0;
+
+        // An end whose begin was overwritten would close a zone the viewer never saw
+        u32 depth = 0;
+        for (u32 i = begin; i < count; i++)
+        {
+            const TraceEvent *e = &b->events[i & TRACE_EVENT_MASK];
+            if (e->name)            depth++;
+            else if (depth > 0)     depth--;
+            else                    continue;
+
+            const u64 ts = e->timestamp >= start ? e->timestamp - start : 0;
+            if (e->name) {
+                fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+                WriteName(file, e->name);
+                fprintf(file, "\",\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%llu}", t, (unsigned long long)ts);
+            }
+            else {
+                fprintf(file, "%s{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%llu}", first ? "" : ",\n", t, (unsigned long long)ts);
+            }
+
+            first = false;
+            written++;
+        }
+    }
+
+    fputs("\n]}\n", file);
+    const bool ok = fclose(file) == 0;
+
+    TraceLog(LOG_INFO, "TRACE: Wrote %u events from %u threads to '%s'", written,
+             threadCount < TRACE_MAX_THREADS ? threadCount : TRACE_MAX_THREADS, path);
+    return ok;
+}
+
+#endif
\ No newline at end of file
@@ -1,96 +1,198 @@
 #include "ivy/utils.h"
+#include "ivy/pack.h"
+#include "ivy/image_codec.h"
+#include "ivy/trace.h"
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <stdint.h>
 
-void ReadExact(FILE *file, void *dest, const size_t n)
+AssetData LoadAssetData(const char *path)
 {
-    const size_t bytes = fread(dest, 1, n, file);
-    assert(bytes == n && "[ERROR] Failed to read file!");
+    TRACE_ZONE("LoadAssetData");
+
+    u32 size = 0;
+    const u8 *packed = PackFind(path, &size);
+    if (packed) return (AssetData){ .data = packed, .size = size, .owned = false };
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        TraceLog(LOG_WARNING, "LoadAssetData: cannot open '%s'", path);
+        return (AssetData){0};
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    u8 *data = malloc(length > 0 ? (size_t)length : 1);
+    assert(data && "[ERROR] Out of memory!");
+
+    const size_t bytes = fread(data, 1, (size_t)length, file);
+    fclose(file);
+    assert(bytes == (size_t)length && "[ERROR] Failed to read file!");
+
+    return (AssetData){ .data = data, .size = (u32)bytes, .owned = true };
 }
 
-u8 *ReadString(FILE *file)
+// Same lookup as LoadAssetData, but a loose file is mapped so callers can keep views into it
+AssetData MapAssetData(const char *path)
 {
-    int len = 0;
-    ReadExact(file, &len, sizeof(u32));
+    u32 size = 0;
+    const u8 *packed = PackFind(path, &size);
+    if (packed) return (AssetData){ .data = packed, .size = size, .owned = false };
+
+    MappedFile mapping;
+    if (!MapFile(path, &mapping) || mapping.size > UINT32_MAX) {
+        UnmapFile(&mapping);
+        return LoadAssetData(path);
+    }
+
+    return (AssetData){ .data = mapping.data, .size = (u32)mapping.size, .owned = false, .mapping = mapping };
+}
+
+void UnloadAssetData(AssetData *asset)
+{
+    if (asset->owned) free((void *)asset->data);
+    UnmapFile(&asset->mapping);
+    *asset = (AssetData){0};
+}
+
+void ReadExact(ByteReader *reader, void *dest, const size_t n)
+{
+    assert(reader->offset + n <= reader->size && "[ERROR] Failed to read file!");
+    memcpy(dest, reader->data + reader->offset, n);
+    reader->offset += (u32)n;
+}
+
+const void *ReadView(ByteReader *reader, const size_t n)
+{
+    assert(reader->offset + n <= reader->size && "[ERROR] Failed to read file!");
+    const void *view = reader->data + reader->offset;
+    reader->offset += (u32)n;
+    return view;
+}
+
+u8 *ReadString(ByteReader *reader)
+{
+    u32 len = 0;
+    ReadExact(reader, &len, sizeof(u32));
 
     u8 *buffer = malloc(len + 1);
     assert(buffer && "[ERROR] Out of memory!");
 
-    ReadExact(file, buffer, len);
+    ReadExact(reader, buffer, len);
     buffer[len] = '\0';
     return buffer;
 }
 
-Texture2D LoadTextureFromBin(const char *path)
+static Image DecodeEncodedImage(const AssetData *asset, bool *outOwned)
 {
-    printf("%s\n", path);
-    FILE *file = fopen(path, "rb");
-    assert(file && "[ERROR] Failed to open binary file!");
+    ImageCodecHeader header;
+    if (!ReadEncodedImageHeader(asset->data, asset->size, &header)) {
+        TraceLog(LOG_WARNING, "DecodeImageBin: unsupported encoded image header");
+        *outOwned = false;
+        return (Image){0};
+    }
+
+    u8 *pixels = malloc((size_t)header.width * header.height * 4);
+    assert(pixels && "[ERROR] Out of memory!");
+
+    if (!DecodeImagePixels(asset->data, asset->size, pixels)) {
+        TraceLog(LOG_WARNING, "DecodeImageBin: corrupt encoded image");
+        free(pixels);
+        *outOwned = false;
+        return (Image){0};
+    }
+
+    *outOwned = true;
+    return (Image) {
+        .data = pixels,
+        .width = (int)header.width,
+        .height = (int)header.height,
+        .mipmaps = 1,
+        .format = (int)header.format
+    };
+}
+
+Image DecodeImageBin(const AssetData *asset, bool *outOwned)
+{
+    u32 magic = 0;
+    if (asset->size >= sizeof(magic)) memcpy(&magic, asset->data, sizeof(magic));
+    if (magic == IMAGE_CODEC_MAGIC) return DecodeEncodedImage(asset, outOwned);
+
+    int header[4];  // width, height, mipmaps, format
+    assert(asset->size >= sizeof(header));
+    memcpy(header, asset->data, sizeof(header));
+
+    const u32 dataSize = (u32)header[0] * (u32)header[1] * 4;  // RGBA = 4 bytes/pixel
+    assert(dataSize <= asset->size - sizeof(header) && "[ERROR] Truncated image data!");
+
+    // Pixels stay in the pack mapping (or the file buffer) and are uploaded from there
+    *outOwned = false;
+    return (Image) {
+        .data = (void *)(asset->data + sizeof(header)),
+        .width = header[0],
+        .height = header[1],
+        .mipmaps = header[2],
+        .format = header[3]
+    };
+}
 
+Image DecodePngBin(const AssetData *asset)
+{
     u32 size = 0;
-    assert(fread(&size, sizeof(u32), 1, file) == 1);
+    assert(asset->size >= sizeof(u32));
+    memcpy(&size, asset->data, sizeof(u32));
+    assert(size <= asset->size - sizeof(u32) && "[ERROR] Truncated tileset data!");
 
-    u8 *data = malloc(size);
-    assert(data && "[ERROR] Failed to allocate memory for tileset data!");
+    return LoadImageFromMemory(".png", asset->data + sizeof(u32), (int)size);
+}
 
-    fread(data, 1, size, file);
-    fclose(file);
+Texture2D LoadTextureFromBin(const char *path)
+{
+    TRACE_ZONE("LoadTextureFromBin");
+
+    AssetData asset = LoadAssetData(path);
+    assert(asset.data && "[ERROR] Failed to open binary file!");
 
-    const Image img = LoadImageFromMemory(".png", data, (int)size);
+    const Image img = DecodePngBin(&asset);
     const Texture2D tex = LoadTextureFromImage(img);
 
     UnloadImage(img);
-    free(data);
+    UnloadAssetData(&asset);
 
     return tex;
 }
 
 Texture2D LoadTextureFromImageBin(const char *path)
 {
-    printf("%s\n", path);
-    FILE *f = fopen(path, "rb");
-    assert(f && "[ERROR] Failed to open binary file!");
+    TRACE_ZONE("LoadTextureFromImageBin");
 
-    int header[4];  // width, height, mipmaps, format
-    fread(header, sizeof(int), 4, f);
+    AssetData asset = LoadAssetData(path);
+    assert(asset.data && "[ERROR] Failed to open binary file!");
 
-    int dataSize = header[0] * header[1] * 4;  // RGBA = 4 bytes/pixel
-    void *data = malloc(dataSize);
-    fread(data, 1, dataSize, f);
-    fclose(f);
+    bool owned = false;
+    const Image image = DecodeImageBin(&asset, &owned);
+    const Texture2D tex = LoadTextureFromImage(image);
 
-    Image image = {
-        .data = data,
-        .width = header[0],
-        .height = header[1],
-        .mipmaps = header[2],
-        .format = header[3]
-    };
-    Texture2D tex = LoadTextureFromImage(image);
-    free(data);
+    if (owned) UnloadImage(image);
+    UnloadAssetData(&asset);
     return tex;
 }
 
 Font LoadFontBin(const char *path, const int fontSize)
 {
-    FILE *f = fopen(path, "rb");
-    if (!f) return (Font){0};
-    assert(f && "[ERROR] Failed to open binary file!");
-
-    fseek(f, 0, SEEK_END);
-    const long size = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    TRACE_ZONE("LoadFontBin");
 
-    unsigned char *data = malloc(size);
-    assert(f && "[ERROR] Failed to allocate memory for fontData!");
-    fread(data, 1, size, f);
-    fclose(f);
+    AssetData asset = LoadAssetData(path);
+    if (!asset.data) return (Font){0};
 
-    const Font font = LoadFontFromMemory(".ttf", data, size, fontSize, NULL, 95);
+    const Font font = LoadFontFromMemory(".ttf", asset.data, (int)asset.size, fontSize, NULL, 95);
 
-    free(data);
+    UnloadAssetData(&asset);
     return font;
 }
 
@@ -0,0 +1,270 @@
+#include "tool_io.h"
+#include "ivy/atlas.h"
+#include "ivy/image_codec.h"
+#include "ivy/pack.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Usage: ivy_atlas_packer <output_root> <root> <group>=<prefix>[,<prefix>...] ...
+// Raw images under <root>/assets whose path starts with one of a group's prefixes
+// are shelf-packed into <output_root>/assets/atlases/<group>_<n>.bin pages, and
+// every region is listed in ATLAS_INDEX_PATH under its original path.
+
+#define MAX_PREFIXES 8
+
+typedef struct {
+    char   *key;
+    u8     *pixels;     // points into data
+    u8     *data;
+    u32     width;
+    u32     height;
+    u32     page;
+    u32     x;
+    u32     y;
+} AtlasInput;
+
+typedef struct {
+    const char *prefixes[MAX_PREFIXES];
+    u32         prefixCount;
+    AtlasInput *inputs;
+    u32         count;
+    u32         capacity;
+} AtlasGroup;
+
+static AtlasPage   *pages;
+static u32          pageCount;
+static AtlasRegion *regions;
+static u32          regionCount;
+
+static void CollectImage(const char *path, const char *key, void *user)
+{
+    AtlasGroup *group = user;
+
+    bool matches = false;
+    for (u32 i = 0; i < group->prefixCount && !matches; i++)
+        matches = strncmp(key, group->prefixes[i], strlen(group->prefixes[i])) == 0;
+    if (!matches) return;
+
+    if (strlen(key) >= ATLAS_PATH_LEN) {
+        fprintf(stderr, "[WARNING] Path too long for the atlas index: '%s'\n", key);
+        return;
+    }
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(path, &size);
+    if (!data) return;
+
+    u32 width, height;
+    if (!IsRawImage(data, size, &width, &height) || width > ATLAS_MAX_SIZE || height > ATLAS_MAX_SIZE) {
+        free(data);
+        return;
+    }
+
+    if (group->count >= group->capacity) {
+        group->capacity = group->capacity == 0 ? 32 : group->capacity * 2;
+        AtlasInput *tmp = realloc(group->inputs, group->capacity * sizeof(AtlasInput));
+        assert(tmp && "[ERROR] Failed to realloc atlas inputs");
+        group->inputs = tmp;
+    }
+
+    group->inputs[group->count++] = (AtlasInput){
+        .key    = strdup(key),
+        .pixels = data + RAW_IMAGE_HEADER_SIZE,
+        .data   = data,
+        .width  = width,
+        .height = height
+    };
+}
+
+static int CompareBySize(const void *a, const void *b)
+{
+    const AtlasInput *ia = a;
+    const AtlasInput *ib = b;
+    if (ia->height != ib->height) return ia->height > ib->height ? -1 : 1;
+    if (ia->width  != ib->width)  return ia->width  > ib->width  ? -1 : 1;
+    return strcmp(ia->key, ib->key);
+}
+
+static int CompareRegions(const void *a, const void *b)
+{
+    const AtlasRegion *ra = a;
+    const AtlasRegion *rb = b;
+    if (ra->hash != rb->hash) return ra->hash < rb->hash ? -1 : 1;
+    return strncmp(ra->path, rb->path, ATLAS_PATH_LEN);
+}
+
+static AtlasPage *AddPage(const char *name, const u32 index)
+{
+    AtlasPage *tmp = realloc(pages, (pageCount + 1) * sizeof(AtlasPage));
+    assert(tmp && "[ERROR] Failed to realloc atlas pages");
+    pages = tmp;
+
+    AtlasPage *page = &pages[pageCount++];
+    memset(page, 0, sizeof(AtlasPage));
+    snprintf(page->path, ATLAS_PATH_LEN, "assets/atlases/%s_%u.bin", name, index);
+    return page;
+}
+
+// Shelf packing: tallest images first, a new shelf when a row is full and a new page when a shelf does not fit.
+static bool PackGroup(const char *outputRoot, const char *name, AtlasGroup *group)
+{
+    if (group->count == 0) return true;
+
+    qsort(group->inputs, group->count, sizeof(AtlasInput), CompareBySize);
+
+    const u32 firstPage = pageCount;
+    AtlasPage *page = AddPage(name, 0);
+    u32 x = 0, y = 0, shelfH = 0;
+
+    for (u32 i = 0; i < group->count; i++)
+    {
+        AtlasInput *in = &group->inputs[i];
+
+        if (x + in->width > ATLAS_MAX_SIZE) {
+            x       = 0;
+            y      += shelfH + ATLAS_PADDING;
+            shelfH  = 0;
+        }
+
+        if (y + in->height > ATLAS_MAX_SIZE) {
+            page = AddPage(name, pageCount - firstPage);
+            x = y = shelfH = 0;
+        }
+
+        in->page = pageCount - 1;
+        in->x    = x;
+        in->y    = y;
+
+        x      += in->width + ATLAS_PADDING;
+        shelfH  = in->height > shelfH ? in->height : shelfH;
+
+        if (in->x + in->width  > page->width)  page->width  = in->x + in->width;
+        if (in->y + in->height > page->height) page->height = in->y + in->height;
+    }
+
+    for (u32 p = firstPage; p < pageCount; p++)
+    {
+        const AtlasPage *pg = &pages[p];
+        u8 *canvas = calloc((size_t)pg->width * pg->height, 4);
+        assert(canvas && "[ERROR] Out of memory!");
+
+        for (u32 i = 0; i < group->count; i++) {
+            const AtlasInput *in = &group->inputs[i];
+            if (in->page != p) continue;
+
+            for (u32 row = 0; row < in->height; row++)
+                memcpy(canvas + (((size_t)in->y + row) * pg->width + in->x) * 4,
+                       in->pixels + (size_t)row * in->width * 4,
+                       (size_t)in->width * 4);
+        }
+
+        u32 encodedSize = 0;
+        u8 *encoded = EncodeImagePixels(canvas, pg->width, pg->height, &encodedSize);
+        assert(encoded && "[ERROR] Out of memory!");
+
+        char dest[1024];
+        snprintf(dest, sizeof(dest), "%s/%s", outputRoot, pg->path);
+        const bool written = WriteWholeFile(dest, encoded, encodedSize);
+
+        printf("Atlas page %s: %ux%u, %llu -> %u bytes\n", pg->path, pg->width, pg->height,
+               (unsigned long long)pg->width * pg->height * 4, encodedSize);
+
+        free(encoded);
+        free(canvas);
+        if (!written) return false;
+    }
+
+    AtlasRegion *tmp = realloc(regions, (regionCount + group->count) * sizeof(AtlasRegion));
+    assert(tmp && "[ERROR] Failed to realloc atlas regions");
+    regions = tmp;
+
+    for (u32 i = 0; i < group->count; i++) {
+        const AtlasInput *in = &group->inputs[i];
+        AtlasRegion *r = &regions[regionCount++];
+
+        memset(r, 0, sizeof(AtlasRegion));
+        snprintf(r->path, ATLAS_PATH_LEN, "%s", in->key);
+        r->hash   = PackHashPath(in->key);
+        r->page   = in->page;
+        r->x      = in->x;
+        r->y      = in->y;
+        r->width  = in->width;
+        r->height = in->height;
+    }
+
+    return true;
+}
+
+static void FreeGroup(AtlasGroup *group)
+{
+    for (u32 i = 0; i < group->count; i++) {
+        free(group->inputs[i].key);
+        free(group->inputs[i].data);
+    }
+    free(group->inputs);
+    memset(group, 0, sizeof(AtlasGroup));
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s <output_root> <root> <group>=<prefix>[,<prefix>...] ...\n", argv[0]);
+        return 1;
+    }
+
+    char assetsDir[1024];
+    snprintf(assetsDir, sizeof(assetsDir), "%s/assets", argv[2]);
+
+    for (int i = 3; i < argc; i++)
+    {
+        char spec[1024];
+        snprintf(spec, sizeof(spec), "%s", argv[i]);
+
+        char *prefixes = strchr(spec, '=');
+        if (!prefixes) {
+            fprintf(stderr, "[ERROR] Bad group '%s', expected <group>=<prefix>\n", argv[i]);
+            return 1;
+        }
+        *prefixes++ = '\0';
+
+        AtlasGroup group = {0};
+        for (char *p = strtok(prefixes, ","); p && group.prefixCount < MAX_PREFIXES; p = strtok(NULL, ","))
+            group.prefixes[group.prefixCount++] = p;
+
+        VisitFiles(assetsDir, "assets", CollectImage, &group);
+
+        const bool ok = PackGroup(argv[1], spec, &group);
+        printf("Atlas group '%s': %u images\n", spec, group.count);
+        FreeGroup(&group);
+        if (!ok) return 1;
+    }
+
+    qsort(regions, regionCount, sizeof(AtlasRegion), CompareRegions);
+
+    const AtlasHeader header = {
+        .magic       = ATLAS_MAGIC,
+        .version     = ATLAS_VERSION,
+        .pageCount   = pageCount,
+        .regionCount = regionCount
+    };
+
+    const u32 indexSize = (u32)(sizeof(header) + pageCount * sizeof(AtlasPage) + regionCount * sizeof(AtlasRegion));
+    u8 *index = malloc(indexSize);
+    assert(index && "[ERROR] Out of memory!");
+
+    memcpy(index, &header, sizeof(header));
+    memcpy(index + sizeof(header), pages, pageCount * sizeof(AtlasPage));
+    memcpy(index + sizeof(header) + pageCount * sizeof(AtlasPage), regions, regionCount * sizeof(AtlasRegion));
+
+    char dest[1024];
+    snprintf(dest, sizeof(dest), "%s/%s", argv[1], ATLAS_INDEX_PATH);
+    const bool written = WriteWholeFile(dest, index, indexSize);
+
+    free(index);
+    free(pages);
+    free(regions);
+    return written ? 0 : 1;
+}
\ No newline at end of file
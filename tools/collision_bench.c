@@ -0,0 +1,224 @@
+#include "tool_io.h"
+#include "ivy/platform.h"
+#include "ivy/collision.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Usage: ivy_collision_bench <maps_root> [queries]
+// Times per-tile solidity queries against the rect scan the player used before the
+// collision bitmap, on every map under <maps_root>/assets/tilemaps and on a large
+// synthetic map, and checks both agree on every query the scan ran. Queries land on
+// random tiles, a few of them outside the map.
+// On the maps it then edits random tiles one at a time with UpdateCollisionRegion and
+// times that against a full rebuild, checking the result matches the rebuild.
+
+#define BENCH_DEFAULT_QUERIES   2000000u
+#define BENCH_SYNTHETIC_SIZE    1024u
+#define BENCH_SYNTHETIC_RECTS   20000u
+#define BENCH_EDITS             500u
+
+typedef struct {
+    u32     queries;
+    u32     mapCount;
+    bool    failed;
+} BenchStats;
+
+static u32 NextRandom(u32 *state)
+{
+    u32 x  = *state;
+    x     ^= x << 13;
+    x     ^= x >> 17;
+    x     ^= x << 5;
+    return *state = x;
+}
+
+// What IsTileSolid did before: the tile center against every rect
+static bool ScanRects(const Collision *collision, const int x, const int y, const float tw, const float th)
+{
+    const Vector2 center = { (float)x * tw + tw * 0.5f, (float)y * th + th * 0.5f };
+    for (u32 i = 0; i < collision->rectCount; i++) {
+        if (CheckCollisionPointRec(center, collision->rect[i])) return true;
+    }
+    return false;
+}
+
+static void RunBench(BenchStats *stats, const char *name, const Collision *collision, const float tw, const float th)
+{
+    const u32 count = stats->queries;
+    int *coords     = malloc((size_t)count * 2 * sizeof(int));
+    u8 *expected    = malloc(count);
+    assert(coords && expected && "[ERROR] Failed to alloc bench queries");
+
+    u32 seed = 0x9E3779B9u;
+    for (u32 i = 0; i < count; i++) {
+        coords[2 * i]     = (int)(NextRandom(&seed) % (collision->width  + 4)) - 2;
+        coords[2 * i + 1] = (int)(NextRandom(&seed) % (collision->height + 4)) - 2;
+    }
+
+    // The scan is far slower, so it only gets a slice of the queries to time
+    const u32 scanCount = collision->rectCount > 256 ? count / 64 : count;
+    u32 solidScan = 0;
+    u64 start     = GetMonotonicMicros();
+    for (u32 i = 0; i < scanCount; i++) {
+        expected[i] = ScanRects(collision, coords[2 * i], coords[2 * i + 1], tw, th);
+        solidScan  += expected[i];
+    }
+    const u64 scanMicros = GetMonotonicMicros() - start;
+
+    u32 solidBits = 0;
+    start = GetMonotonicMicros();
+    for (u32 i = 0; i < count; i++) solidBits += IsCollisionTileSolid(collision, coords[2 * i], coords[2 * i + 1]);
+    const u64 bitMicros = GetMonotonicMicros() - start;
+
+    u32 wrong = 0;
+    for (u32 i = 0; i < scanCount; i++) {
+        if (IsCollisionTileSolid(collision, coords[2 * i], coords[2 * i + 1]) != (bool)expected[i]) wrong++;
+    }
+
+    const double scanRate = (double)scanCount / ((double)(scanMicros ? scanMicros : 1) / 1e6);
+    const double bitRate  = (double)count     / ((double)(bitMicros  ? bitMicros  : 1) / 1e6);
+
+    printf("%-32s %4ux%-4u %6u rects  scan %10.2f M/s  bitmap %10.2f M/s  x%.0f  (%u/%u solid)\n",
+           name, collision->width, collision->height, collision->rectCount,
+           scanRate / 1e6, bitRate / 1e6, bitRate / scanRate, solidBits, count);
+
+    if (wrong > 0) {
+        fprintf(stderr, "[ERROR] %s: bitmap and rects disagree on %u of %u tiles (%u solid by scan)\n",
+                name, wrong, scanCount, solidScan);
+        stats->failed = true;
+    }
+
+    free(coords);
+    free(expected);
+}
+
+// Same solid tiles as a full rebuild, and the rects cover exactly those
+static bool MatchesRebuild(const Collision *collision, const Tilemap *tilemap)
+{
+    const float tw = (float)tilemap->header.tileWidth;
+    const float th = (float)tilemap->header.tileHeight;
+
+    // Painting the rects back into a bitmap gives the tiles they cover
+    RectInfo *rects = malloc((collision->rectCount + 1) * sizeof(RectInfo));
+    assert(rects && "[ERROR] Failed to alloc bench rects");
+    for (u32 i = 0; i < collision->rectCount; i++) {
+        const Rectangle *r = &collision->rect[i];
+        rects[i] = (RectInfo){
+            (int)(r->x / tw + 0.5f), (int)(r->y / th + 0.5f),
+            (int)(r->width / tw + 0.5f), (int)(r->height / th + 0.5f)
+        };
+    }
+
+    Collision *full    = InitCollisionAllLayers(tilemap);
+    Collision *covered = CreateCollision(rects, collision->rectCount, collision->width, collision->height, tw, th);
+    const size_t bytes = (size_t)full->wordsPerRow * full->height * sizeof(u64);
+    const bool same    = memcmp(full->solid, collision->solid, bytes) == 0 && memcmp(full->solid, covered->solid, bytes) == 0;
+
+    DestroyCollision(covered);
+    DestroyCollision(full);
+    free(rects);
+    return same;
+}
+
+// Copies random tiles over random cells of the same layer, solid or not, or clears them
+static void BenchEdits(BenchStats *stats, const char *name, Tilemap *tilemap, Collision *collision)
+{
+    const TilemapHeader *h = &tilemap->header;
+    u32 seed = 0x68E31DA4u;
+
+    u64 updateMicros = 0;
+    for (u32 i = 0; i < BENCH_EDITS; i++)
+    {
+        const u32 layer = NextRandom(&seed) % h->layerCount;
+        const u32 x     = NextRandom(&seed) % h->width;
+        const u32 y     = NextRandom(&seed) % h->height;
+        const u32 from  = TM_GetTileId(tilemap, layer, NextRandom(&seed) % h->width, NextRandom(&seed) % h->height);
+        const u32 gid   = NextRandom(&seed) % 4 == 0 ? 0 : tilemap->tileGids[from];
+
+        SetTile(tilemap, layer, x, y, gid);
+
+        const u64 start = GetMonotonicMicros();
+        UpdateCollisionRegion(collision, tilemap, (TileRect){ x, y, x + 1, y + 1 });
+        updateMicros += GetMonotonicMicros() - start;
+    }
+
+    const u64 start      = GetMonotonicMicros();
+    Collision *full      = InitCollisionAllLayers(tilemap);
+    const u64 fullMicros = GetMonotonicMicros() - start;
+
+    printf("%-32s %u edits  update %8.2f us  rebuild %10.2f us  (%u rects, %u after rebuild)\n",
+           name, BENCH_EDITS, (double)updateMicros / BENCH_EDITS, (double)fullMicros,
+           collision->rectCount, full->rectCount);
+    DestroyCollision(full);
+
+    if (!MatchesRebuild(collision, tilemap)) {
+        fprintf(stderr, "[ERROR] %s: updated collision differs from a rebuild\n", name);
+        stats->failed = true;
+    }
+}
+
+static void BenchMap(const char *path, const char *key, void *user)
+{
+    BenchStats *stats = user;
+    if (!strstr(key, ".bin")) return;
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(path, &size);
+    if (!data) return;
+
+    Tilemap *tilemap     = LoadTilemapFromAsset((AssetData){ .data = data, .size = size, .owned = true });
+    Collision *collision = InitCollisionAllLayers(tilemap);
+
+    RunBench(stats, key, collision, (float)tilemap->header.tileWidth, (float)tilemap->header.tileHeight);
+    BenchEdits(stats, key, tilemap, collision);
+    stats->mapCount++;
+
+    DestroyCollision(collision);
+    UnloadTilemap(tilemap);
+}
+
+// Scattered small rects, about what a large dungeon with furniture leaves after merging
+static void BenchSynthetic(BenchStats *stats)
+{
+    RectInfo *rects = malloc(BENCH_SYNTHETIC_RECTS * sizeof(RectInfo));
+    assert(rects && "[ERROR] Failed to alloc synthetic rects");
+
+    u32 seed = 0x2545F491u;
+    for (u32 i = 0; i < BENCH_SYNTHETIC_RECTS; i++) {
+        rects[i] = (RectInfo){
+            .x = (int)(NextRandom(&seed) % (BENCH_SYNTHETIC_SIZE - 8)),
+            .y = (int)(NextRandom(&seed) % (BENCH_SYNTHETIC_SIZE - 8)),
+            .w = (int)(NextRandom(&seed) % 8) + 1,
+            .h = (int)(NextRandom(&seed) % 8) + 1
+        };
+    }
+
+    Collision *collision = CreateCollision(rects, BENCH_SYNTHETIC_RECTS, BENCH_SYNTHETIC_SIZE, BENCH_SYNTHETIC_SIZE, 32.0f, 32.0f);
+    RunBench(stats, "synthetic", collision, 32.0f, 32.0f);
+
+    DestroyCollision(collision);
+    free(rects);
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc != 2 && argc != 3) {
+        fprintf(stderr, "Usage: %s <maps_root> [queries]\n", argv[0]);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    BenchStats stats = { .queries = argc == 3 ? (u32)strtoul(argv[2], NULL, 10) : BENCH_DEFAULT_QUERIES };
+    if (stats.queries == 0) stats.queries = BENCH_DEFAULT_QUERIES;
+
+    char mapsDir[1024];
+    snprintf(mapsDir, sizeof(mapsDir), "%s/assets/tilemaps", argv[1]);
+    VisitFiles(mapsDir, "assets/tilemaps", BenchMap, &stats);
+    BenchSynthetic(&stats);
+
+    return stats.failed ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,312 @@
+#include "tool_io.h"
+#include "ivy/platform.h"
+#include "ivy/entity.h"
+#include "ivy/player/player.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Usage: ivy_entity_bench <maps_root> [entities] [frames]
+// Random-walks a crowd over every map under <maps_root>/assets/tilemaps and a large
+// synthetic map, timing UpdateEntities per 60 Hz frame. The same crowd also runs as one
+// heap-allocated Player per entity, stepped through StartMoving and UpdateAnimation, which
+// both times the struct-per-NPC layout and checks the store ends every entity on the same
+// tile, pixel and animation frame. The players are allocated in shuffled order between
+// unrelated blocks, the way NPCs created over a session end up spread through the heap.
+// Only an optimized build gives meaningful numbers.
+
+#define BENCH_DEFAULT_ENTITIES  10000u
+#define BENCH_DEFAULT_FRAMES    600u
+#define BENCH_FRAME_TIME        (1.0f / 60.0f)
+#define BENCH_SYNTHETIC_SIZE    512u
+#define BENCH_SYNTHETIC_RECTS   6000u
+#define BENCH_FILLER_MAX        512u    // bytes of unrelated allocation between two players
+
+typedef struct {
+    u32     entities;
+    u32     frames;
+    bool    failed;
+} BenchStats;
+
+static u32 NextRandom(u32 *state)
+{
+    u32 x  = *state;
+    x     ^= x << 13;
+    x     ^= x >> 17;
+    x     ^= x << 5;
+    return *state = x;
+}
+
+static int CompareMicros(const void *a, const void *b)
+{
+    const u64 x = *(const u64 *)a, y = *(const u64 *)b;
+    return (x > y) - (x < y);
+}
+
+// The slowest frame alone is at the mercy of the scheduler; the 99th percentile is not
+static u64 SortedPercentile(u64 *micros, const u32 count, const u32 percent)
+{
+    qsort(micros, count, sizeof(u64), CompareMicros);
+    return micros[(u64)count * percent / 100];
+}
+
+static bool IntentInput(const u8 intent, Vector2 *outDir, Direction *outFacing)
+{
+    static const Vector2 steps[4] = { { 0, 1 }, { 1, 0 }, { -1, 0 }, { 0, -1 } };
+
+    const u32 step = intent & ENTITY_INTENT_DIR_MASK;
+    if (step == 0) return false;
+
+    *outDir    = steps[step - 1];
+    *outFacing = (Direction)(step - 1);
+    return true;
+}
+
+// UpdatePlayerMovement with the keyboard swapped for the intent, minus the turn delay
+static void StepPlayer(Player *player, const u8 intent, const float frameTime,
+                       const Collision *collision, const u32 tileSize)
+{
+    const float ts = (float)tileSize;
+    PlayerMovement *m = &player->movement;
+
+    Vector2   inputDir = {0};
+    Direction nextDir  = player->graphics.direction;
+
+    const bool hasInput  = IntentInput(intent, &inputDir, &nextDir);
+    const bool isRunning = (intent & ENTITY_INTENT_RUN) != 0;
+
+    if (!m->isMoving) {
+        if (!hasInput) player->graphics.action = ACTION_IDLE;
+        else StartMoving(player, inputDir, nextDir, isRunning, collision);
+    }
+
+    if (!m->isMoving) return;
+
+    m->moveTimer += frameTime;
+    float t = m->moveTimer / m->moveDuration;
+
+    if (t >= 1.0f) {
+        m->tilePosition = m->targetTilePosition;
+
+        if (hasInput) {
+            const Vector2 next = { m->tilePosition.x + inputDir.x, m->tilePosition.y + inputDir.y };
+
+            if (!IsTileSolid(next, collision)) {
+                const PlayerAction action = isRunning ? ACTION_RUN : ACTION_WALK;
+                m->targetTilePosition     = next;
+                m->moveTimer             -= m->moveDuration;
+                m->moveDuration           = GetMoveDuration(action);
+                player->graphics.action    = action;
+                player->graphics.direction = nextDir;
+
+                t = m->moveTimer / m->moveDuration;
+            } else {
+                m->isMoving             = false;
+                player->graphics.action = ACTION_IDLE;
+            }
+        } else {
+            m->isMoving             = false;
+            m->moveTimer            = 0.0f;
+            player->graphics.action = ACTION_IDLE;
+            t = 1.0f;
+        }
+    }
+
+    if (t > 1.0f) t = 1.0f;
+
+    const float halfTs = ts * 0.5f;
+    const Vector2 startPos = { m->tilePosition.x * ts + halfTs, m->tilePosition.y * ts + halfTs };
+    const Vector2 endPos   = { m->targetTilePosition.x * ts + halfTs, m->targetTilePosition.y * ts + halfTs };
+
+    m->position.x = startPos.x + (endPos.x - startPos.x) * t;
+    m->position.y = startPos.y + (endPos.y - startPos.y) * t;
+}
+
+static bool SameEntity(const EntityStore *store, const u32 i, const Player *player)
+{
+    const PlayerMovement *m = &player->movement;
+    return store->tileX[i] == (int)m->tilePosition.x && store->tileY[i] == (int)m->tilePosition.y &&
+           store->position[i].x == m->position.x && store->position[i].y == m->position.y &&
+           store->frame[i] == player->animation.currentFrame &&
+           store->action[i] == (u8)player->graphics.action &&
+           store->direction[i] == (u8)player->graphics.direction;
+}
+
+static void RunBench(BenchStats *stats, const char *name, const Collision *collision, const u32 tileSize)
+{
+    const u32 count = stats->entities;
+
+    EntityStore *store = CreateEntityStore(count);
+    Player **players   = malloc(count * sizeof(Player *));
+    void **fillers     = malloc(count * sizeof(void *));
+    u32 *order         = malloc(count * sizeof(u32));
+    u8 *intents        = malloc(count);
+    u64 *storeFrames   = malloc(stats->frames * sizeof(u64));
+    u64 *playerFrames  = malloc(stats->frames * sizeof(u64));
+    assert(players && fillers && order && intents && storeFrames && playerFrames && "[ERROR] Failed to alloc bench entities");
+
+    u32 seed = 0x3C6EF372u;
+    for (u32 i = 0; i < count; i++) order[i] = i;
+    for (u32 i = count; i > 1; i--) {
+        const u32 j = NextRandom(&seed) % i;
+        const u32 t = order[i - 1];
+        order[i - 1] = order[j];
+        order[j]     = t;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        players[order[i]] = calloc(1, sizeof(Player));
+        fillers[i]        = malloc(16 + NextRandom(&seed) % BENCH_FILLER_MAX);
+        assert(players[order[i]] && fillers[i] && "[ERROR] Failed to alloc bench player");
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        int x = 0, y = 0;
+        for (u32 tries = 0; tries < 64; tries++) {
+            x = (int)(NextRandom(&seed) % collision->width);
+            y = (int)(NextRandom(&seed) % collision->height);
+            if (!IsCollisionTileSolid(collision, x, y)) break;
+        }
+
+        const Direction facing = (Direction)(NextRandom(&seed) % 4);
+        SpawnEntity(store, x, y, facing, 0, tileSize);
+
+        Player *player = players[i];
+        player->movement.tilePosition       = (Vector2){ (float)x, (float)y };
+        player->movement.targetTilePosition = player->movement.tilePosition;
+        player->movement.position           = store->position[i];
+        player->movement.moveDuration       = BASE_MOVE_DURATION;
+        player->animation.frameDirection    = 1;
+        player->graphics.direction          = facing;
+        intents[i] = ENTITY_INTENT_NONE;
+    }
+
+    u64 storeMicros = 0, playerMicros = 0;
+    u64 movingFrames = 0;
+
+    for (u32 f = 0; f < stats->frames; f++)
+    {
+        // About one entity in sixteen changes its mind each frame
+        for (u32 i = 0; i < count; i++) {
+            const u32 r = NextRandom(&seed);
+            if (r % 16 != 0) continue;
+
+            const u32 pick = (r >> 4) % 8;
+            intents[i] = pick < 2 ? ENTITY_INTENT_NONE : MakeEntityIntent((Direction)(pick % 4), (r >> 8) % 4 == 0);
+        }
+        memcpy(store->intent, intents, count);
+
+        u64 start = GetMonotonicMicros();
+        UpdateEntities(store, BENCH_FRAME_TIME, collision, tileSize);
+        storeFrames[f] = GetMonotonicMicros() - start;
+        storeMicros   += storeFrames[f];
+
+        start = GetMonotonicMicros();
+        for (u32 i = 0; i < count; i++) {
+            StepPlayer(players[i], intents[i], BENCH_FRAME_TIME, collision, tileSize);
+            UpdateAnimation(players[i], BENCH_FRAME_TIME);
+        }
+        playerFrames[f] = GetMonotonicMicros() - start;
+        playerMicros   += playerFrames[f];
+
+        for (u32 i = 0; i < count; i++) movingFrames += store->moving[i];
+    }
+
+    u32 wrong = 0;
+    for (u32 i = 0; i < count; i++) wrong += !SameEntity(store, i, players[i]);
+
+    const double frames = (double)stats->frames;
+    const u64 storeP99  = SortedPercentile(storeFrames,  stats->frames, 99);
+    const u64 playerP99 = SortedPercentile(playerFrames, stats->frames, 99);
+    printf("%-32s %4ux%-4u %6u entities  store %7.1f us/frame (p99 %6llu, max %6llu)"
+           "  player structs %7.1f us/frame (p99 %6llu, max %6llu)  x%.1f  %4.1f%% moving\n",
+           name, collision->width, collision->height, count,
+           (double)storeMicros / frames, (unsigned long long)storeP99, (unsigned long long)storeFrames[stats->frames - 1],
+           (double)playerMicros / frames, (unsigned long long)playerP99, (unsigned long long)playerFrames[stats->frames - 1],
+           (double)playerMicros / (double)(storeMicros ? storeMicros : 1),
+           100.0 * (double)movingFrames / (frames * count));
+
+    if (wrong > 0) {
+        fprintf(stderr, "[ERROR] %s: %u of %u entities ended up apart from their player twin\n", name, wrong, count);
+        stats->failed = true;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        free(players[i]);
+        free(fillers[i]);
+    }
+    free(players);
+    free(fillers);
+    free(order);
+    free(intents);
+    free(storeFrames);
+    free(playerFrames);
+    DestroyEntityStore(store);
+}
+
+static void BenchMap(const char *path, const char *key, void *user)
+{
+    BenchStats *stats = user;
+    if (!strstr(key, ".bin")) return;
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(path, &size);
+    if (!data) return;
+
+    Tilemap *tilemap     = LoadTilemapFromAsset((AssetData){ .data = data, .size = size, .owned = true });
+    Collision *collision = InitCollisionAllLayers(tilemap);
+
+    RunBench(stats, key, collision, tilemap->header.tileWidth);
+
+    DestroyCollision(collision);
+    UnloadTilemap(tilemap);
+}
+
+// Scattered blocks over a town-sized map, so the crowd keeps bumping into things
+static void BenchSynthetic(BenchStats *stats)
+{
+    RectInfo *rects = malloc(BENCH_SYNTHETIC_RECTS * sizeof(RectInfo));
+    assert(rects && "[ERROR] Failed to alloc synthetic rects");
+
+    u32 seed = 0x2545F491u;
+    for (u32 i = 0; i < BENCH_SYNTHETIC_RECTS; i++) {
+        rects[i] = (RectInfo){
+            .x = (int)(NextRandom(&seed) % (BENCH_SYNTHETIC_SIZE - 6)),
+            .y = (int)(NextRandom(&seed) % (BENCH_SYNTHETIC_SIZE - 6)),
+            .w = (int)(NextRandom(&seed) % 6) + 1,
+            .h = (int)(NextRandom(&seed) % 6) + 1
+        };
+    }
+
+    Collision *collision = CreateCollision(rects, BENCH_SYNTHETIC_RECTS, BENCH_SYNTHETIC_SIZE, BENCH_SYNTHETIC_SIZE, 32.0f, 32.0f);
+    RunBench(stats, "synthetic", collision, 32);
+
+    DestroyCollision(collision);
+    free(rects);
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc < 2 || argc > 4) {
+        fprintf(stderr, "Usage: %s <maps_root> [entities] [frames]\n", argv[0]);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    BenchStats stats = {
+        .entities = argc >= 3 ? (u32)strtoul(argv[2], NULL, 10) : BENCH_DEFAULT_ENTITIES,
+        .frames   = argc >= 4 ? (u32)strtoul(argv[3], NULL, 10) : BENCH_DEFAULT_FRAMES
+    };
+    if (stats.entities == 0) stats.entities = BENCH_DEFAULT_ENTITIES;
+    if (stats.frames == 0)   stats.frames   = BENCH_DEFAULT_FRAMES;
+
+    char mapsDir[1024];
+    snprintf(mapsDir, sizeof(mapsDir), "%s/assets/tilemaps", argv[1]);
+    VisitFiles(mapsDir, "assets/tilemaps", BenchMap, &stats);
+    BenchSynthetic(&stats);
+
+    return stats.failed ? 1 : 0;
+}
\ No newline at end of file
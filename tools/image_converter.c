@@ -0,0 +1,115 @@
+#include "tool_io.h"
+#include "ivy/image_codec.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Usage: ivy_image_converter <output_root> <root>
+// Every raw RGBA image .bin under <root>/assets is encoded to the same path under
+// <output_root>/assets, so the pack builder can overlay it on the sources.
+// Each image is decoded again and compared before it is written. The load each image costs
+// the game is timed too: reading the raw file against reading what ships and decoding it.
+// Both reads come straight after the file was read or written, so they hit the page cache,
+// as on any launch after the first.
+
+typedef struct {
+    const char *outputRoot;
+    u32         imageCount;
+    u64         rawBytes;
+    u64         encodedBytes;
+    double      rawLoadSeconds;     // ReadWholeFile of the raw .bin
+    double      loadSeconds;        // ReadWholeFile of what ships, plus the decode when it is encoded
+    bool        failed;
+} ConvertStats;
+
+static void ConvertFile(const char *source, const char *key, void *user)
+{
+    ConvertStats *stats = user;
+    if (!strstr(key, ".bin")) return;
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(source, &size);
+    if (!data) return;
+
+    u32 width, height;
+    if (!IsRawImage(data, size, &width, &height)) {
+        free(data);
+        return;
+    }
+
+    const u8 *pixels = data + RAW_IMAGE_HEADER_SIZE;
+    const u32 pixelBytes = size - RAW_IMAGE_HEADER_SIZE;
+
+    u32 encodedSize = 0;
+    u8 *encoded = EncodeImagePixels(pixels, width, height, &encodedSize);
+    assert(encoded && "[ERROR] Out of memory!");
+
+    u8 *check = malloc(pixelBytes);
+    assert(check && "[ERROR] Out of memory!");
+
+    const bool matches = DecodeImagePixels(encoded, encodedSize, check) && memcmp(check, pixels, pixelBytes) == 0;
+
+    char dest[1024];
+    snprintf(dest, sizeof(dest), "%s/%s", stats->outputRoot, key);
+    bool shipsEncoded = false;
+
+    if (!matches) {
+        fprintf(stderr, "[ERROR] Round trip mismatch for '%s'\n", source);
+        stats->failed = true;
+    }
+    // Only ship the encoded file when it actually wins
+    else if (encodedSize < size) {
+        shipsEncoded = WriteWholeFile(dest, encoded, encodedSize);
+        if (!shipsEncoded) stats->failed = true;
+    }
+
+    u32 loadedSize = 0;
+    clock_t start  = clock();
+    u8 *loaded     = ReadWholeFile(source, &loadedSize);
+    stats->rawLoadSeconds += (double)(clock() - start) / CLOCKS_PER_SEC;
+    free(loaded);
+
+    start  = clock();
+    loaded = ReadWholeFile(shipsEncoded ? dest : source, &loadedSize);
+    if (loaded && shipsEncoded && !DecodeImagePixels(loaded, loadedSize, check)) {
+        fprintf(stderr, "[ERROR] Cannot decode '%s' after writing it\n", dest);
+        stats->failed = true;
+    }
+    stats->loadSeconds += (double)(clock() - start) / CLOCKS_PER_SEC;
+    free(loaded);
+
+    stats->imageCount++;
+    stats->rawBytes     += size;
+    stats->encodedBytes += encodedSize < size ? encodedSize : size;
+
+    free(check);
+    free(encoded);
+    free(data);
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <output_root> <root>\n", argv[0]);
+        return 1;
+    }
+
+    char assetsDir[1024];
+    snprintf(assetsDir, sizeof(assetsDir), "%s/assets", argv[2]);
+
+    ConvertStats stats = { .outputRoot = argv[1] };
+    VisitFiles(assetsDir, "assets", ConvertFile, &stats);
+    if (stats.failed) return 1;
+
+    const double mb = (double)stats.rawBytes / (1024.0 * 1024.0);
+    printf("Encoded %u images: %llu -> %llu bytes (%.1f%%)\n", stats.imageCount, stats.rawBytes, stats.encodedBytes,
+           stats.rawBytes ? 100.0 * (double)stats.encodedBytes / (double)stats.rawBytes : 0.0);
+    if (stats.rawLoadSeconds > 0.0 && stats.loadSeconds > 0.0)
+        printf("Load: raw read %.2f ms (%.0f MB/s), shipped read + decode %.2f ms (%.0f MB/s)\n",
+               stats.rawLoadSeconds * 1000.0, mb / stats.rawLoadSeconds, stats.loadSeconds * 1000.0, mb / stats.loadSeconds);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,327 @@
+#include "tool_io.h"
+#include "ivy/tilemap/tilemap_format.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Usage: ivy_map_chunker <output_root> <root>
+// Every v1 map under <root>/assets/tilemaps is rewritten as a chunked map at the
+// same path under <output_root>. Tileset names are NUL-padded to 4 bytes so the loader
+// can use the property arrays in place; the layers are cut into TILEMAP_CHUNK_TILES^2
+// blobs so the game only touches the chunks it looks at, and their gids are swapped for
+// compact local ids so the loader's tile tables only hold the tiles the map uses.
+
+typedef struct {
+    const char *outputRoot;
+    u32         mapCount;
+    bool        failed;
+} ChunkerStats;
+
+static u32 Align(const u32 value)
+{
+    return (value + TILEMAP_BLOB_ALIGNMENT - 1) & ~(u32)(TILEMAP_BLOB_ALIGNMENT - 1);
+}
+
+static bool ReadU32(const u8 *data, const u32 size, u32 *offset, u32 *out)
+{
+    if (*offset + sizeof(u32) > size) return false;
+    memcpy(out, data + *offset, sizeof(u32));
+    *offset += sizeof(u32);
+    return true;
+}
+
+// Returns the offset of the first layer record, or 0 when the tileset block is malformed.
+// When out is set the tilesets are also re-emitted there with padded names; outSize
+// receives the padded block size either way.
+static u32 SkipTilesets(const u8 *data, const u32 size, const TilemapHeader *header, u8 *out, u32 *outSize)
+{
+    u32 offset  = sizeof(TilemapHeader);
+    u32 written = 0;
+
+    for (u32 i = 0; i < header->tilesetCount; i++)
+    {
+        u32 firstGid, propCount, nameLength;
+        if (!ReadU32(data, size, &offset, &firstGid))   return 0;
+        if (!ReadU32(data, size, &offset, &propCount))  return 0;
+        if (!ReadU32(data, size, &offset, &nameLength)) return 0;
+
+        const u32 propBytes = propCount * (u32)sizeof(TileProp);
+        if ((u64)offset + nameLength + propBytes > size) return 0;
+
+        const u32 padded = (nameLength + 3u) & ~3u;
+        if (out) {
+            memcpy(out + written,      &firstGid, sizeof(u32));
+            memcpy(out + written + 4,  &propCount, sizeof(u32));
+            memcpy(out + written + 8,  &padded, sizeof(u32));
+            memcpy(out + written + 12, data + offset, nameLength);
+            memset(out + written + 12 + nameLength, 0, padded - nameLength);
+            memcpy(out + written + 12 + padded, data + offset + nameLength, propBytes);
+        }
+
+        offset  += nameLength + propBytes;
+        written += 3 * (u32)sizeof(u32) + padded + propBytes;
+    }
+
+    *outSize = written;
+    return offset;
+}
+
+static int CompareU32(const void *a, const void *b)
+{
+    const u32 x = *(const u32 *)a, y = *(const u32 *)b;
+    return (x > y) - (x < y);
+}
+
+// Property of gid in the tileset with the highest firstGid not above it, 0 when it has none
+static u32 FindTileProp(const u8 *data, const TilemapHeader *header, const u32 gid)
+{
+    u32 offset = sizeof(TilemapHeader);
+    u32 bestFirst = 0, bestProps = 0, bestCount = 0;
+    bool found = false;
+
+    // SkipTilesets has validated the block already
+    for (u32 i = 0; i < header->tilesetCount; i++)
+    {
+        u32 firstGid, propCount, nameLength;
+        memcpy(&firstGid,   data + offset,     sizeof(u32));
+        memcpy(&propCount,  data + offset + 4, sizeof(u32));
+        memcpy(&nameLength, data + offset + 8, sizeof(u32));
+        offset += 3 * sizeof(u32) + nameLength;
+
+        if (firstGid <= gid && (!found || firstGid > bestFirst)) {
+            bestFirst = firstGid;
+            bestProps = offset;
+            bestCount = propCount;
+            found     = true;
+        }
+        offset += propCount * (u32)sizeof(TileProp);
+    }
+
+    for (u32 p = 0; found && p < bestCount; p++) {
+        TileProp prop;
+        memcpy(&prop, data + bestProps + p * sizeof(TileProp), sizeof(prop));
+        if (prop.id == gid - bestFirst) return prop.type;
+    }
+    return 0;
+}
+
+// Every gid the layers use plus the later frames of their animated tiles, ascending and unique
+static u32 *CollectTileGids(const u8 *data, const TilemapHeader *header, const u32 layersOffset, u32 *outCount)
+{
+    const u32 cellCount  = header->width * header->height;
+    const u32 layerBytes = 2 * sizeof(u32) + cellCount * sizeof(u32);
+
+    u32 count = 0, capacity = 256;
+    u32 *gids = malloc(capacity * sizeof(u32));
+    assert(gids && "[ERROR] Out of memory!");
+
+    for (u32 l = 0; l < header->layerCount; l++) {
+        const u8 *cells = data + layersOffset + l * layerBytes + 2 * sizeof(u32);
+        for (u32 i = 0; i < cellCount; i++)
+        {
+            u32 gid;
+            memcpy(&gid, cells + i * sizeof(u32), sizeof(u32));
+            if (gid == 0) continue;
+
+            const u32 frames = (FindTileProp(data, header, gid) >> TILE_PROP_FRAMES_SHIFT) & TILE_PROP_FRAMES_MASK;
+            for (u32 f = 0; f <= frames; f++) {
+                if (count == capacity) {
+                    capacity *= 2;
+                    gids = realloc(gids, capacity * sizeof(u32));
+                    assert(gids && "[ERROR] Out of memory!");
+                }
+                gids[count++] = gid + f;
+            }
+        }
+    }
+
+    qsort(gids, count, sizeof(u32), CompareU32);
+    u32 unique = 0;
+    for (u32 i = 0; i < count; i++) {
+        if (unique == 0 || gids[i] != gids[unique - 1]) gids[unique++] = gids[i];
+    }
+
+    *outCount = unique;
+    return gids;
+}
+
+static u8 *ChunkMap(const u8 *data, const u32 size, u32 *outSize, u32 *outChunks, u32 *outEmpty, u32 *outTiles)
+{
+    if (size < sizeof(TilemapHeader)) return NULL;
+
+    TilemapHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    u32 tilesetBytes = 0;
+    const u32 layersOffset = SkipTilesets(data, size, &header, NULL, &tilesetBytes);
+    if (layersOffset == 0) return NULL;
+
+    const u32 cellCount  = header.width * header.height;
+    const u32 layerBytes = 2 * sizeof(u32) + cellCount * sizeof(u32);
+    if ((u64)layersOffset + (u64)layerBytes * header.layerCount > size) return NULL;
+
+    u32 maxGid = 0;
+    for (u32 l = 0; l < header.layerCount; l++)
+    {
+        const u8 *record = data + layersOffset + l * layerBytes;
+        u32 width, height;
+        memcpy(&width,  record,               sizeof(u32));
+        memcpy(&height, record + sizeof(u32), sizeof(u32));
+        if (width != header.width || height != header.height) return NULL;
+
+        for (u32 i = 0; i < cellCount; i++) {
+            u32 gid;
+            memcpy(&gid, record + 2 * sizeof(u32) + i * sizeof(u32), sizeof(u32));
+            if (gid > maxGid) maxGid = gid;
+        }
+    }
+
+    const u32 chunksX    = (header.width  + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT;
+    const u32 chunksY    = (header.height + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT;
+    const u32 chunkCount = chunksX * chunksY;
+    const u32 chunkBytes = header.layerCount * TILEMAP_CHUNK_TILES * TILEMAP_CHUNK_TILES * sizeof(u32);
+    const u32 metaBytes  = (u32)sizeof(TilemapHeader) + tilesetBytes;
+
+    u32 tileCount = 0;
+    u32 *tileGids = CollectTileGids(data, &header, layersOffset, &tileCount);
+
+    const u32 tileOffset  = Align((u32)sizeof(TilemapFileHeader) + metaBytes);
+    const u32 indexOffset = Align(tileOffset + tileCount * (u32)sizeof(u32));
+    const u32 blobsOffset = Align(indexOffset + chunkCount * (u32)sizeof(TilemapChunkEntry));
+
+    // Worst case: no empty chunks
+    const u64 capacity = (u64)blobsOffset + (u64)chunkCount * Align(chunkBytes);
+    if (capacity > UINT32_MAX) {
+        free(tileGids);
+        return NULL;
+    }
+
+    u8 *out = calloc(1, (size_t)capacity);
+    u32 *blob = malloc(chunkBytes);
+    assert(out && blob && "[ERROR] Out of memory!");
+
+    const TilemapFileHeader file = {
+        .magic       = TILEMAP_MAGIC,
+        .version     = TILEMAP_VERSION,
+        .chunkTiles  = TILEMAP_CHUNK_TILES,
+        .chunksX     = chunksX,
+        .chunksY     = chunksY,
+        .maxGid      = maxGid,
+        .indexOffset = indexOffset,
+        .tileOffset  = tileOffset,
+        .tileCount   = tileCount
+    };
+    memcpy(out, &file, sizeof(file));
+    memcpy(out + sizeof(file), &header, sizeof(header));
+    SkipTilesets(data, size, &header, out + sizeof(file) + sizeof(header), &tilesetBytes);
+    memcpy(out + tileOffset, tileGids, tileCount * sizeof(u32));
+
+    u32 cursor = blobsOffset;
+    u32 empty  = 0;
+
+    for (u32 c = 0; c < chunkCount; c++)
+    {
+        const u32 x0 = (c % chunksX) << TILEMAP_CHUNK_SHIFT;
+        const u32 y0 = (c / chunksX) << TILEMAP_CHUNK_SHIFT;
+        const u32 x1 = x0 + TILEMAP_CHUNK_TILES < header.width  ? x0 + TILEMAP_CHUNK_TILES : header.width;
+        const u32 y1 = y0 + TILEMAP_CHUNK_TILES < header.height ? y0 + TILEMAP_CHUNK_TILES : header.height;
+
+        memset(blob, 0, chunkBytes);
+        bool any = false;
+
+        for (u32 l = 0; l < header.layerCount; l++)
+        {
+            const u8 *cells = data + layersOffset + l * layerBytes + 2 * sizeof(u32);
+            u32 *plane      = blob + (l << (2 * TILEMAP_CHUNK_SHIFT));
+
+            for (u32 y = y0; y < y1; y++) {
+                for (u32 x = x0; x < x1; x++) {
+                    u32 gid;
+                    memcpy(&gid, cells + ((size_t)y * header.width + x) * sizeof(u32), sizeof(u32));
+                    if (gid == 0) continue;
+
+                    const u32 *id = bsearch(&gid, tileGids, tileCount, sizeof(u32), CompareU32);
+                    plane[((y - y0) << TILEMAP_CHUNK_SHIFT) + (x - x0)] = (u32)(id - tileGids) + 1;
+                    any = true;
+                }
+            }
+        }
+
+        TilemapChunkEntry entry = {0};
+        if (any) {
+            entry.offset = cursor;
+            entry.size   = chunkBytes;
+            memcpy(out + cursor, blob, chunkBytes);
+            cursor = Align(cursor + chunkBytes);
+        }
+        else empty++;
+
+        memcpy(out + indexOffset + c * sizeof(entry), &entry, sizeof(entry));
+    }
+
+    free(blob);
+    free(tileGids);
+
+    *outSize   = cursor;
+    *outChunks = chunkCount;
+    *outEmpty  = empty;
+    *outTiles  = tileCount;
+    return out;
+}
+
+static void ConvertMap(const char *source, const char *key, void *user)
+{
+    ChunkerStats *stats = user;
+    if (!strstr(key, ".bin")) return;
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(source, &size);
+    if (!data) return;
+
+    u32 magic = 0;
+    if (size >= sizeof(u32)) memcpy(&magic, data, sizeof(u32));
+    if (magic == TILEMAP_MAGIC) {
+        free(data);
+        return;
+    }
+
+    u32 outSize = 0, chunks = 0, empty = 0, tiles = 0;
+    u8 *out = ChunkMap(data, size, &outSize, &chunks, &empty, &tiles);
+
+    if (!out) {
+        fprintf(stderr, "[ERROR] Malformed map '%s'\n", source);
+        stats->failed = true;
+        free(data);
+        return;
+    }
+
+    char dest[1024];
+    snprintf(dest, sizeof(dest), "%s/%s", stats->outputRoot, key);
+    if (!WriteWholeFile(dest, out, outSize)) stats->failed = true;
+
+    printf("Map %s: %u chunks (%u empty), %u tiles in use, %u -> %u bytes\n", key, chunks, empty, tiles, size, outSize);
+    stats->mapCount++;
+
+    free(out);
+    free(data);
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <output_root> <root>\n", argv[0]);
+        return 1;
+    }
+
+    char mapsDir[1024];
+    snprintf(mapsDir, sizeof(mapsDir), "%s/assets/tilemaps", argv[2]);
+
+    ChunkerStats stats = { .outputRoot = argv[1] };
+    VisitFiles(mapsDir, "assets/tilemaps", ConvertMap, &stats);
+
+    printf("Chunked %u maps\n", stats.mapCount);
+    return stats.failed ? 1 : 0;
+}
\ No newline at end of file
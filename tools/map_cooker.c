@@ -0,0 +1,183 @@
+#include "tool_io.h"
+#include "ivy/collision.h"
+#include "ivy/tilemap/tilemap.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Usage: ivy_map_cooker <maps_root> <root>
+// Every v3 map under <maps_root>/assets/tilemaps gets its collision rects and the
+// autotile draw list of each chunk bake computed once and appended as cooked sections
+// (see tilemap_format.h). Tileset sizes come from the PNG headers under <root>.
+// Re-cooking a map replaces its previous sections.
+
+typedef struct {
+    const char *root;
+    u32         mapCount;
+    bool        failed;
+} CookerStats;
+
+static u32 ReadBigEndian32(const u8 *p)
+{
+    return ((u32)p[0] << 24) | ((u32)p[1] << 16) | ((u32)p[2] << 8) | (u32)p[3];
+}
+
+// Tileset .bin files are a u32 size followed by a PNG; its IHDR holds the size
+static bool ReadTilesetSize(const char *root, const char *key, int *outWidth, int *outHeight)
+{
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", root, key);
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(path, &size);
+    if (!data) return false;
+
+    static const u8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    const u8 *png = data + sizeof(u32);
+    const bool ok = size >= sizeof(u32) + 24 &&
+                    memcmp(png, signature, sizeof(signature)) == 0 &&
+                    memcmp(png + 12, "IHDR", 4) == 0;
+
+    if (ok) {
+        *outWidth  = (int)ReadBigEndian32(png + 16);
+        *outHeight = (int)ReadBigEndian32(png + 20);
+    }
+
+    free(data);
+    return ok;
+}
+
+static u32 Align(const u32 value)
+{
+    return (value + TILEMAP_BLOB_ALIGNMENT - 1) & ~(u32)(TILEMAP_BLOB_ALIGNMENT - 1);
+}
+
+static void CookMap(const char *path, const char *key, void *user)
+{
+    CookerStats *stats = user;
+    if (!strstr(key, ".bin")) return;
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(path, &size);
+    if (!data) return;
+
+    TilemapFileHeader file = {0};
+    if (size >= sizeof(file)) memcpy(&file, data, sizeof(file));
+    if (file.magic != TILEMAP_MAGIC) {
+        fprintf(stderr, "[WARNING] '%s' is not a chunked map, run ivy_map_chunker first\n", key);
+        free(data);
+        return;
+    }
+
+    // Drop the sections of an earlier cook; they always sit after the chunk blobs
+    u32 baseSize = size;
+    if (file.sectionOffset != 0 && (u64)file.sectionOffset + sizeof(u32) <= size)
+    {
+        u32 count;
+        memcpy(&count, data + file.sectionOffset, sizeof(u32));
+        baseSize = file.sectionOffset;
+
+        for (u32 i = 0; i < count && (u64)file.sectionOffset + sizeof(u32) + (i + 1) * sizeof(TilemapSection) <= size; i++) {
+            TilemapSection section;
+            memcpy(&section, data + file.sectionOffset + sizeof(u32) + i * sizeof(section), sizeof(section));
+            if (section.offset < baseSize) baseSize = section.offset;
+        }
+    }
+    file.sectionOffset = 0;
+    memcpy(data, &file, sizeof(file));
+
+    Tilemap *tilemap = LoadTilemapFromAsset((AssetData){ .data = data, .size = baseSize, .owned = true });
+
+    for (u32 i = 0; i < tilemap->header.tilesetCount; i++)
+    {
+        Tileset *ts = &tilemap->tilesets[i];
+        if (!ReadTilesetSize(stats->root, ts->texturePath, &ts->texture.width, &ts->texture.height)) {
+            fprintf(stderr, "[ERROR] Cannot read tileset '%s' of '%s'\n", ts->texturePath, key);
+            stats->failed = true;
+            UnloadTilemap(tilemap);
+            return;
+        }
+    }
+
+    TM_BuildDrawInfo(tilemap);
+
+    RectInfo *rects       = NULL;
+    const u32 rectCount   = CollectCollisionRects(tilemap, &rects);
+
+    const TileStream *s   = tilemap->stream;
+    const u32 chunkCount  = s->chunksX * s->chunksY;
+    TilemapQuadRange *ranges = calloc(chunkCount, sizeof(TilemapQuadRange));
+    TileQuadList quads    = {0};
+    assert(ranges && "[ERROR] Out of memory!");
+
+    u32 batches = 0;
+    for (u32 c = 0; c < chunkCount; c++) {
+        ranges[c].first = quads.count;
+        ranges[c].foreground = TM_CollectQuads(tilemap, TM_GetChunkApron(tilemap, &s->chunks[c]),
+                                               TILEMAP_ANIM_STILLS, &quads, NULL);
+        ranges[c].count      = quads.count - ranges[c].first;
+        batches += TM_CountBatches(quads.quads + ranges[c].first, ranges[c].count);
+    }
+
+    const u32 collisionOffset = Align(baseSize);
+    const u32 collisionSize   = (u32)(sizeof(u32) + rectCount * sizeof(TilemapRect));
+    const u32 quadsOffset     = Align(collisionOffset + collisionSize);
+    const u32 quadsSize       = (u32)(chunkCount * sizeof(TilemapQuadRange) + quads.count * sizeof(TilemapQuad));
+    const u32 tableOffset     = Align(quadsOffset + quadsSize);
+    const u32 sectionCount    = 2;
+    const u32 outSize         = (u32)(tableOffset + sizeof(u32) + sectionCount * sizeof(TilemapSection));
+
+    u8 *out = calloc(1, outSize);
+    assert(out && "[ERROR] Out of memory!");
+    memcpy(out, tilemap->source.data, baseSize);
+
+    file.sectionOffset = tableOffset;
+    memcpy(out, &file, sizeof(file));
+
+    memcpy(out + collisionOffset, &rectCount, sizeof(u32));
+    for (u32 i = 0; i < rectCount; i++) {
+        const TilemapRect r = { (u32)rects[i].x, (u32)rects[i].y, (u32)rects[i].w, (u32)rects[i].h };
+        memcpy(out + collisionOffset + sizeof(u32) + i * sizeof(r), &r, sizeof(r));
+    }
+
+    memcpy(out + quadsOffset, ranges, chunkCount * sizeof(TilemapQuadRange));
+    memcpy(out + quadsOffset + chunkCount * sizeof(TilemapQuadRange), quads.quads, quads.count * sizeof(TilemapQuad));
+
+    const TilemapSection sections[2] = {
+        { TILEMAP_SECTION_COLLISION, collisionOffset, collisionSize },
+        { TILEMAP_SECTION_QUADS,     quadsOffset,     quadsSize     }
+    };
+    memcpy(out + tableOffset, &sectionCount, sizeof(u32));
+    memcpy(out + tableOffset + sizeof(u32), sections, sizeof(sections));
+
+    if (!WriteWholeFile(path, out, outSize)) stats->failed = true;
+
+    printf("Cooked %s: %u collision rects, %u quads in %u batches (%u in map order), %u -> %u bytes\n",
+           key, rectCount, quads.count, batches, s->mapOrderBatches, baseSize, outSize);
+    stats->mapCount++;
+
+    free(out);
+    free(quads.quads);
+    free(ranges);
+    free(rects);
+    UnloadTilemap(tilemap);
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <maps_root> <root>\n", argv[0]);
+        return 1;
+    }
+
+    char mapsDir[1024];
+    snprintf(mapsDir, sizeof(mapsDir), "%s/assets/tilemaps", argv[1]);
+
+    CookerStats stats = { .root = argv[2] };
+    VisitFiles(mapsDir, "assets/tilemaps", CookMap, &stats);
+
+    printf("Cooked %u maps\n", stats.mapCount);
+    return stats.failed ? 1 : 0;
+}
\ No newline at end of file
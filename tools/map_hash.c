@@ -0,0 +1,186 @@
+#include "tool_io.h"
+#include "ivy/platform.h"
+#include "ivy/tilemap/tilemap_compose.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Usage: ivy_map_hash <maps_root> <root> [golden]
+// Composites every map under <maps_root>/assets/tilemaps on the CPU, background and
+// foreground, and prints one "<key> <background hash> <foreground hash>" line per map.
+// Tilesets are read from <root>, so source and chunked maps hash the same. With a golden
+// file in the same format every map is checked against it and any difference fails the
+// run; tools/map_hashes.txt is the one kept in the tree, refreshed by redirecting the
+// output after an intended rendering change.
+// Set IVY_MAP_HASH_DUMP to a directory to also export the composited images as PNG.
+
+typedef struct {
+    const char *root;
+    const char *golden;     // file contents, NULL when only printing
+    u32         mapCount;
+    u32         mismatches;
+    bool        failed;
+} HashStats;
+
+// FNV-1a over the size and the pixels
+static u64 HashImage(const Image *image)
+{
+    u64 hash = 0xCBF29CE484222325ull;
+    const u32 header[2] = { (u32)image->width, (u32)image->height };
+
+    const u8 *parts[2]  = { (const u8 *)header, image->data };
+    const size_t len[2] = { sizeof(header), (size_t)image->width * image->height * 4 };
+
+    for (u32 p = 0; p < 2; p++) {
+        for (size_t i = 0; i < len[p]; i++) {
+            hash ^= parts[p][i];
+            hash *= 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
+
+// Tileset .bin files are a u32 size followed by a PNG
+static bool LoadTilesetImage(const char *root, const char *key, Image *out)
+{
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", root, key);
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(path, &size);
+    if (!data) return false;
+
+    u32 pngSize = 0;
+    if (size >= sizeof(u32)) memcpy(&pngSize, data, sizeof(u32));
+    if (pngSize == 0 || pngSize > size - sizeof(u32)) pngSize = size - sizeof(u32);
+
+    *out = LoadImageFromMemory(".png", data + sizeof(u32), (int)pngSize);
+    free(data);
+    if (!out->data) return false;
+
+    ImageFormat(out, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    return true;
+}
+
+static void DumpImage(const char *key, const char *suffix, const Image *image)
+{
+    const char *dir = getenv("IVY_MAP_HASH_DUMP");
+    if (!dir || image->width == 0) return;
+
+    const char *name = strrchr(key, '/');
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s_%s.png", dir, name ? name + 1 : key, suffix);
+    ExportImage(*image, path);
+}
+
+static void CheckGolden(HashStats *stats, const char *line)
+{
+    if (!stats->golden) return;
+
+    // The key ends at the first space; the whole line has to match
+    const size_t keyLen = strchr(line, ' ') - line + 1;
+    for (const char *g = stats->golden; *g; )
+    {
+        const char *end   = strchr(g, '\n');
+        const size_t len  = end ? (size_t)(end - g) : strlen(g);
+
+        if (len >= keyLen && strncmp(g, line, keyLen) == 0) {
+            if (len == strlen(line) && strncmp(g, line, len) == 0) return;
+            fprintf(stderr, "[ERROR] Hash mismatch, expected: %.*s\n", (int)len, g);
+            stats->mismatches++;
+            return;
+        }
+        g = end ? end + 1 : g + len;
+    }
+
+    fprintf(stderr, "[ERROR] '%.*s' has no golden hash\n", (int)keyLen - 1, line);
+    stats->mismatches++;
+}
+
+static void HashMap(const char *path, const char *key, void *user)
+{
+    HashStats *stats = user;
+    if (!strstr(key, ".bin")) return;
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(path, &size);
+    if (!data) return;
+
+    Tilemap *tilemap = LoadTilemapFromAsset((AssetData){ .data = data, .size = size, .owned = true });
+    const u32 tilesetCount = tilemap->header.tilesetCount;
+    Image *images = calloc(tilesetCount ? tilesetCount : 1, sizeof(Image));
+
+    for (u32 i = 0; i < tilesetCount; i++)
+    {
+        Tileset *ts = &tilemap->tilesets[i];
+        if (!LoadTilesetImage(stats->root, ts->texturePath, &images[i])) {
+            fprintf(stderr, "[ERROR] Cannot read tileset '%s' of '%s'\n", ts->texturePath, key);
+            stats->failed = true;
+            goto done;
+        }
+        ts->texture.width  = images[i].width;
+        ts->texture.height = images[i].height;
+    }
+
+    TM_BuildDrawInfo(tilemap);
+
+    const TileRect whole = { 0, 0, tilemap->header.width, tilemap->header.height };
+    const u64 start      = GetMonotonicMicros();
+    Image below          = ComposeTilemapImage(tilemap, images, whole, false);
+    Image above          = ComposeTilemapImage(tilemap, images, whole, true);
+    const u64 elapsed    = GetMonotonicMicros() - start;
+
+    char line[1024];
+    snprintf(line, sizeof(line), "%s %016llx %016llx", key,
+             (unsigned long long)HashImage(&below), (unsigned long long)HashImage(&above));
+    printf("%s\n", line);
+    fprintf(stderr, "%s: %dx%d px in %.2f ms\n", key, below.width, below.height, (double)elapsed / 1000.0);
+
+    CheckGolden(stats, line);
+    DumpImage(key, "below", &below);
+    DumpImage(key, "above", &above);
+    stats->mapCount++;
+
+    UnloadImage(below);
+    UnloadImage(above);
+
+done:
+    for (u32 i = 0; i < tilesetCount; i++) UnloadImage(images[i]);
+    free(images);
+    UnloadTilemap(tilemap);
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc != 3 && argc != 4) {
+        fprintf(stderr, "Usage: %s <maps_root> <root> [golden]\n", argv[0]);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    HashStats stats = { .root = argv[2] };
+    u8 *golden = NULL;
+    if (argc == 4) {
+        u32 size = 0;
+        u8 *data = ReadWholeFile(argv[3], &size);
+        if (!data) {
+            fprintf(stderr, "[ERROR] Cannot read golden file '%s'\n", argv[3]);
+            return 1;
+        }
+
+        golden = calloc(size + 1, 1);
+        memcpy(golden, data, size);
+        free(data);
+        stats.golden = (const char *)golden;
+    }
+
+    char mapsDir[1024];
+    snprintf(mapsDir, sizeof(mapsDir), "%s/assets/tilemaps", argv[1]);
+    VisitFiles(mapsDir, "assets/tilemaps", HashMap, &stats);
+
+    free(golden);
+    if (stats.golden) fprintf(stderr, "Checked %u maps, %u mismatches\n", stats.mapCount, stats.mismatches);
+    return stats.failed || stats.mismatches > 0 ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "ivy/pack.h"
+
+#include <assert.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// Usage: ivy_pack_builder <output.pack> <root> [<root> ...]
+// Every file under <root>/assets is stored with its "assets/..." path as key.
+// Later roots override earlier ones, so generated assets can overlay sources.
+
+typedef struct {
+    char   *key;
+    char   *source;
+    u32     hash;
+    u32     size;
+} PackInput;
+
+static PackInput   *inputs;
+static u32          inputCount;
+static u32          inputCapacity;
+
+static void AddInput(const char *key, const char *source, const u32 size)
+{
+    const u32 hash = PackHashPath(key);
+
+    for (u32 i = 0; i < inputCount; i++) {
+        if (inputs[i].hash == hash && strcmp(inputs[i].key, key) == 0) {
+            free(inputs[i].source);
+            inputs[i].source = strdup(source);
+            inputs[i].size   = size;
+            return;
+        }
+    }
+
+    if (inputCount >= inputCapacity) {
+        inputCapacity = inputCapacity == 0 ? 64 : inputCapacity * 2;
+        PackInput *tmp = realloc(inputs, inputCapacity * sizeof(PackInput));
+        assert(tmp && "[ERROR] Failed to realloc pack inputs");
+        inputs = tmp;
+    }
+
+    inputs[inputCount++] = (PackInput){
+        .key    = strdup(key),
+        .source = strdup(source),
+        .hash   = hash,
+        .size   = size
+    };
+}
+
+static void CollectDirectory(const char *dirPath, const char *keyPrefix)
+{
+    DIR *dir = opendir(dirPath);
+    if (!dir) return;
+
+    const struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL)
+    {
+        if (ent->d_name[0] == '.') continue;
+
+        char path[1024];
+        char key[1024];
+        snprintf(path, sizeof(path), "%s/%s", dirPath, ent->d_name);
+        snprintf(key,  sizeof(key),  "%s/%s", keyPrefix, ent->d_name);
+
+        struct stat st;
+        if (stat(path, &st) != 0) continue;
+
+        if (S_ISDIR(st.st_mode))      CollectDirectory(path, key);
+        else if (S_ISREG(st.st_mode)) AddInput(key, path, (u32)st.st_size);
+    }
+
+    closedir(dir);
+}
+
+static int CompareInputs(const void *a, const void *b)
+{
+    const PackInput *ia = a;
+    const PackInput *ib = b;
+    if (ia->hash != ib->hash) return ia->hash < ib->hash ? -1 : 1;
+
+    // Byte-wise ordering, matching the runtime lookup
+    const size_t la = strlen(ia->key);
+    const size_t lb = strlen(ib->key);
+    const int cmp = memcmp(ia->key, ib->key, la < lb ? la : lb);
+    if (cmp != 0) return cmp;
+    return (la > lb) - (la < lb);
+}
+
+static u64 AlignUp(const u64 value)
+{
+    return (value + PACK_ALIGNMENT - 1) & ~(u64)(PACK_ALIGNMENT - 1);
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <output.pack> <root> [<root> ...]\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 2; i < argc; i++) {
+        char assetsDir[1024];
+        snprintf(assetsDir, sizeof(assetsDir), "%s/assets", argv[i]);
+        CollectDirectory(assetsDir, "assets");
+    }
+
+    qsort(inputs, inputCount, sizeof(PackInput), CompareInputs);
+
+    PackEntry *entries = calloc(inputCount ? inputCount : 1, sizeof(PackEntry));
+    assert(entries && "[ERROR] Failed to alloc pack entries");
+
+    u32 stringTableSize = 0;
+    for (u32 i = 0; i < inputCount; i++)
+        stringTableSize += (u32)strlen(inputs[i].key);
+
+    u64 offset = AlignUp(sizeof(PackHeader) + (u64)inputCount * sizeof(PackEntry) + stringTableSize);
+    u32 pathOffset = 0;
+
+    for (u32 i = 0; i < inputCount; i++) {
+        const u32 len = (u32)strlen(inputs[i].key);
+        entries[i] = (PackEntry){
+            .hash       = inputs[i].hash,
+            .pathOffset = pathOffset,
+            .pathLength = len,
+            .size       = inputs[i].size,
+            .offset     = offset
+        };
+        pathOffset += len;
+        offset      = AlignUp(offset + inputs[i].size);
+    }
+
+    FILE *out = fopen(argv[1], "wb");
+    if (!out) {
+        fprintf(stderr, "[ERROR] Cannot create '%s'\n", argv[1]);
+        return 1;
+    }
+
+    const PackHeader header = {
+        .magic           = PACK_MAGIC,
+        .version         = PACK_VERSION,
+        .entryCount      = inputCount,
+        .stringTableSize = stringTableSize
+    };
+
+    fwrite(&header, sizeof(header), 1, out);
+    fwrite(entries, sizeof(PackEntry), inputCount, out);
+    for (u32 i = 0; i < inputCount; i++)
+        fwrite(inputs[i].key, 1, strlen(inputs[i].key), out);
+
+    static const u8 padding[PACK_ALIGNMENT] = {0};
+    u64 written = sizeof(PackHeader) + (u64)inputCount * sizeof(PackEntry) + stringTableSize;
+    u64 totalBytes = 0;
+
+    for (u32 i = 0; i < inputCount; i++)
+    {
+        fwrite(padding, 1, (size_t)(entries[i].offset - written), out);
+        written = entries[i].offset;
+
+        FILE *in = fopen(inputs[i].source, "rb");
+        if (!in) {
+            fprintf(stderr, "[ERROR] Cannot open '%s'\n", inputs[i].source);
+            fclose(out);
+            return 1;
+        }
+
+        u8 buffer[1 << 16];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+            fwrite(buffer, 1, n, out);
+            written += n;
+        }
+        fclose(in);
+
+        totalBytes += inputs[i].size;
+    }
+
+    fclose(out);
+    printf("Packed %u assets (%llu bytes) into %s\n", inputCount, totalBytes, argv[1]);
+
+    for (u32 i = 0; i < inputCount; i++) {
+        free(inputs[i].key);
+        free(inputs[i].source);
+    }
+    free(inputs);
+    free(entries);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,413 @@
+#include "tool_io.h"
+#include "ivy/platform.h"
+#include "ivy/pathfinding.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Usage: ivy_path_bench <maps_root> [queries]
+// Creates a path service for every map under <maps_root>/assets/tilemaps and for two
+// large synthetic maps (scattered blocks, and rooms joined by doorways), then:
+//   - serves random queries between open tiles through RequestPath / UpdatePathService
+//     with the per-frame budget the game uses, straight after creation so the frames
+//     also pay for building the clusters, and reports the frames needed and the slowest
+//   - times the same queries with FindPath
+//   - checks every route is walkable and joins its ends, and that a breadth-first
+//     search agrees on which goals can be reached; routes it finds are compared to
+//     the shortest ones
+//   - opens and closes random blocks, invalidates them and checks queries again
+// Fails when a route is broken or reachability disagrees.
+
+#define BENCH_DEFAULT_QUERIES   2000u
+#define BENCH_CHECKED_QUERIES   200u        // queries also solved by breadth-first search
+#define BENCH_EDITS             64u
+
+typedef struct {
+    u32     queries;
+    bool    failed;
+} BenchStats;
+
+typedef struct {
+    u32     *dist;
+    u32     *queue;
+    u32     capacity;
+} BfsScratch;
+
+static u32 NextRandom(u32 *state)
+{
+    u32 x  = *state;
+    x     ^= x << 13;
+    x     ^= x >> 17;
+    x     ^= x << 5;
+    return *state = x;
+}
+
+static bool IsOpen(const Collision *collision, const int x, const int y)
+{
+    return (u32)x < collision->width && (u32)y < collision->height && !IsCollisionTileSolid(collision, x, y);
+}
+
+static PathTile RandomOpenTile(const Collision *collision, u32 *seed)
+{
+    for (u32 tries = 0; tries < 1000000; tries++) {
+        const PathTile t = { (int)(NextRandom(seed) % collision->width), (int)(NextRandom(seed) % collision->height) };
+        if (IsOpen(collision, t.x, t.y)) return t;
+    }
+    return (PathTile){ -1, -1 };
+}
+
+// Steps on the shortest route, UINT32_MAX when there is none
+static u32 ShortestSteps(const Collision *collision, BfsScratch *bfs, const PathTile start, const PathTile goal)
+{
+    const u32 w     = collision->width;
+    const u32 cells = w * collision->height;
+    if (cells > bfs->capacity) {
+        free(bfs->dist);
+        free(bfs->queue);
+        bfs->dist     = malloc(cells * sizeof(u32));
+        bfs->queue    = malloc(cells * sizeof(u32));
+        bfs->capacity = cells;
+        assert(bfs->dist && bfs->queue && "[ERROR] Failed to alloc bench search");
+    }
+    memset(bfs->dist, 0xFF, cells * sizeof(u32));
+
+    u32 head = 0;
+    u32 tail = 0;
+    const u32 target = (u32)goal.y * w + (u32)goal.x;
+    bfs->dist[(u32)start.y * w + (u32)start.x] = 0;
+    bfs->queue[tail++] = (u32)start.y * w + (u32)start.x;
+
+    while (head < tail)
+    {
+        const u32 i = bfs->queue[head++];
+        if (i == target) return bfs->dist[i];
+
+        const int x = (int)(i % w);
+        const int y = (int)(i / w);
+        const int next[4][2] = { { x + 1, y }, { x - 1, y }, { x, y + 1 }, { x, y - 1 } };
+
+        for (u32 k = 0; k < 4; k++) {
+            if (!IsOpen(collision, next[k][0], next[k][1])) continue;
+            const u32 n = (u32)next[k][1] * w + (u32)next[k][0];
+            if (bfs->dist[n] != UINT32_MAX) continue;
+            bfs->dist[n]       = bfs->dist[i] + 1;
+            bfs->queue[tail++] = n;
+        }
+    }
+    return UINT32_MAX;
+}
+
+static bool IsValidPath(const Collision *collision, const Path *path, const PathTile start, const PathTile goal)
+{
+    if (path->count == 0) return false;
+    if (path->tiles[0].x != start.x || path->tiles[0].y != start.y) return false;
+    if (path->tiles[path->count - 1].x != goal.x || path->tiles[path->count - 1].y != goal.y) return false;
+
+    for (u32 i = 0; i < path->count; i++) {
+        if (!IsOpen(collision, path->tiles[i].x, path->tiles[i].y)) return false;
+        if (i > 0 && abs(path->tiles[i].x - path->tiles[i - 1].x) + abs(path->tiles[i].y - path->tiles[i - 1].y) != 1) return false;
+    }
+    return true;
+}
+
+static void MakeQueries(const Collision *collision, const u32 count, const u32 seedValue, PathTile *starts, PathTile *goals)
+{
+    u32 seed = seedValue;
+    for (u32 i = 0; i < count; i++) {
+        starts[i] = RandomOpenTile(collision, &seed);
+        goals[i]  = RandomOpenTile(collision, &seed);
+    }
+}
+
+// Solves every query, checks the first BENCH_CHECKED_QUERIES against breadth-first search
+static void CheckQueries(BenchStats *stats, const char *name, PathService *service, const Collision *collision,
+                         const PathTile *starts, const PathTile *goals, const u32 count, BfsScratch *bfs)
+{
+    Path path = {0};
+    u32 found = 0;
+    u64 micros = 0;
+    u64 steps = 0;
+    u64 shortest = 0;
+    u32 broken = 0;
+    u32 disagree = 0;
+
+    for (u32 i = 0; i < count; i++)
+    {
+        const u64 start = GetMonotonicMicros();
+        const bool ok   = FindPath(service, starts[i], goals[i], &path);
+        micros         += GetMonotonicMicros() - start;
+
+        if (ok) {
+            found++;
+            if (!IsValidPath(collision, &path, starts[i], goals[i])) broken++;
+        }
+
+        if (i >= BENCH_CHECKED_QUERIES) continue;
+
+        const u32 best = ShortestSteps(collision, bfs, starts[i], goals[i]);
+        if ((best != UINT32_MAX) != ok) disagree++;
+        if (ok && best != UINT32_MAX) {
+            steps    += path.count - 1;
+            shortest += best;
+        }
+    }
+
+    const PathServiceStats ps = GetPathServiceStats(service);
+    printf("%-28s %5u queries  %8.1f us avg  %5.1f%% found  %+.2f%% longer than shortest  (%u direct, %u graph, %u cluster builds)\n",
+           name, count, (double)micros / count, 100.0 * found / count,
+           shortest ? 100.0 * ((double)steps / (double)shortest - 1.0) : 0.0, ps.directSearches, ps.clusterSearches,
+           ps.clusterRebuilds);
+
+    if (broken > 0 || disagree > 0) {
+        fprintf(stderr, "[ERROR] %s: %u broken routes, %u reachability disagreements\n", name, broken, disagree);
+        stats->failed = true;
+    }
+    FreePath(&path);
+}
+
+static int CompareMicros(const void *a, const void *b)
+{
+    const u64 x = *(const u64 *)a;
+    const u64 y = *(const u64 *)b;
+    return (x > y) - (x < y);
+}
+
+static void ServeBatched(BenchStats *stats, const char *name, PathService *service, const Collision *collision,
+                         const PathTile *starts, const PathTile *goals, const u32 count)
+{
+    PathRequest *requests = malloc(count * sizeof(PathRequest));
+    assert(requests && "[ERROR] Failed to alloc bench requests");
+
+    u32 issued = 0;
+    u32 collected = 0;
+    u32 frames = 0;
+    u32 broken = 0;
+    u64 total = 0;
+    u64 *frameMicros = NULL;
+    u32 frameCapacity = 0;
+    Path path = {0};
+
+    while (collected < count)
+    {
+        while (issued < count) {
+            const PathRequest r = RequestPath(service, starts[issued], goals[issued]);
+            if (r == 0) break;
+            requests[issued++] = r;
+        }
+
+        const u64 start = GetMonotonicMicros();
+        UpdatePathService(service, PATH_FRAME_BUDGET_US);
+        const u64 frame = GetMonotonicMicros() - start;
+
+        if (frames >= frameCapacity) {
+            frameCapacity = frameCapacity == 0 ? 1024 : frameCapacity * 2;
+            u64 *tmp      = realloc(frameMicros, frameCapacity * sizeof(u64));
+            assert(tmp && "[ERROR] Failed to realloc bench frame times");
+            frameMicros = tmp;
+        }
+        frameMicros[frames++] = frame;
+        total += frame;
+
+        for (u32 i = collected; i < issued; i++) {
+            const PathStatus status = CollectPath(service, requests[i], &path);
+            if (status == PATH_PENDING) break;
+            if (status == PATH_NONE) {
+                fprintf(stderr, "[ERROR] %s: request %u was lost\n", name, i);
+                stats->failed = true;
+            }
+            if (status == PATH_FOUND && !IsValidPath(collision, &path, starts[i], goals[i])) broken++;
+            collected++;
+        }
+    }
+
+    // The slowest frame alone is at the mercy of the scheduler; the 99th percentile is not
+    qsort(frameMicros, frames, sizeof(u64), CompareMicros);
+    printf("%-28s %5u requests in %u frames of %u us, %.1f us avg, 99th percentile %llu us, slowest %llu us\n",
+           name, count, frames, PATH_FRAME_BUDGET_US, (double)total / frames,
+           (unsigned long long)frameMicros[(u64)frames * 99 / 100], (unsigned long long)frameMicros[frames - 1]);
+
+    if (broken > 0) {
+        fprintf(stderr, "[ERROR] %s: %u broken routes from requests\n", name, broken);
+        stats->failed = true;
+    }
+
+    FreePath(&path);
+    free(frameMicros);
+    free(requests);
+}
+
+// Flips random blocks of tiles, then checks the service against the new map
+static void BenchEdits(BenchStats *stats, const char *name, PathService *service, Collision *collision,
+                       const u32 count, BfsScratch *bfs)
+{
+    u32 seed = 0x1B873593u;
+    const PathServiceStats before = GetPathServiceStats(service);
+
+    for (u32 e = 0; e < BENCH_EDITS; e++)
+    {
+        const u32 w = 1 + NextRandom(&seed) % 4;
+        const u32 h = 1 + NextRandom(&seed) % 4;
+        const u32 x = NextRandom(&seed) % collision->width;
+        const u32 y = NextRandom(&seed) % collision->height;
+        const TileRect r = { x, y, x + w < collision->width ? x + w : collision->width, y + h < collision->height ? y + h : collision->height };
+
+        for (u32 ty = r.y0; ty < r.y1; ty++) {
+            for (u32 tx = r.x0; tx < r.x1; tx++)
+                collision->solid[ty * collision->wordsPerRow + (tx >> 6)] ^= 1ull << (tx & 63);
+        }
+
+        InvalidatePathRegion(service, r);
+    }
+
+    // Ends may have been walled in; skip those
+    PathTile *s = malloc(count * sizeof(PathTile));
+    PathTile *g = malloc(count * sizeof(PathTile));
+    assert(s && g && "[ERROR] Failed to alloc bench queries");
+    MakeQueries(collision, count, 0x85EBCA6Bu, s, g);
+
+    char label[256];
+    snprintf(label, sizeof(label), "%s (edited)", name);
+    CheckQueries(stats, label, service, collision, s, g, count, bfs);
+
+    // The searches above rebuilt whatever clusters they crossed
+    const PathServiceStats after = GetPathServiceStats(service);
+    printf("%-28s %5u edits  %u clusters rebuilt\n", name, BENCH_EDITS, after.clusterRebuilds - before.clusterRebuilds);
+
+    free(s);
+    free(g);
+}
+
+static void BenchCollision(BenchStats *stats, const char *name, Collision *collision)
+{
+    const u64 start       = GetMonotonicMicros();
+    PathService *service  = CreatePathService(collision);
+    const u64 buildMicros = GetMonotonicMicros() - start;
+    const PathServiceStats ps = GetPathServiceStats(service);
+
+    printf("%-28s %ux%u tiles, %u clusters, created in %.2f ms\n",
+           name, collision->width, collision->height, ps.clusters, (double)buildMicros / 1000.0);
+
+    const u32 count  = stats->queries;
+    PathTile *starts = malloc(count * sizeof(PathTile));
+    PathTile *goals  = malloc(count * sizeof(PathTile));
+    assert(starts && goals && "[ERROR] Failed to alloc bench queries");
+    MakeQueries(collision, count, 0x9E3779B9u, starts, goals);
+
+    BfsScratch bfs = {0};
+    if (starts[0].x >= 0) {
+        ServeBatched(stats, name, service, collision, starts, goals, count);
+        CheckQueries(stats, name, service, collision, starts, goals, count, &bfs);
+        BenchEdits(stats, name, service, collision, count, &bfs);
+    }
+
+    free(bfs.dist);
+    free(bfs.queue);
+    free(starts);
+    free(goals);
+    DestroyPathService(service);
+}
+
+static void BenchMap(const char *path, const char *key, void *user)
+{
+    BenchStats *stats = user;
+    if (!strstr(key, ".bin")) return;
+
+    u32 size = 0;
+    u8 *data = ReadWholeFile(path, &size);
+    if (!data) return;
+
+    Tilemap *tilemap     = LoadTilemapFromAsset((AssetData){ .data = data, .size = size, .owned = true });
+    Collision *collision = InitCollisionAllLayers(tilemap);
+
+    BenchCollision(stats, key, collision);
+
+    DestroyCollision(collision);
+    UnloadTilemap(tilemap);
+}
+
+// Scattered blocks over open ground
+static Collision *MakeScatteredMap(const u32 size, const u32 blocks)
+{
+    RectInfo *rects = malloc(blocks * sizeof(RectInfo));
+    assert(rects && "[ERROR] Failed to alloc synthetic rects");
+
+    u32 seed = 0x2545F491u;
+    for (u32 i = 0; i < blocks; i++) {
+        rects[i] = (RectInfo){
+            .x = (int)(NextRandom(&seed) % (size - 8)),
+            .y = (int)(NextRandom(&seed) % (size - 8)),
+            .w = (int)(NextRandom(&seed) % 8) + 1,
+            .h = (int)(NextRandom(&seed) % 8) + 1
+        };
+    }
+
+    Collision *collision = CreateCollision(rects, blocks, size, size, 32.0f, 32.0f);
+    free(rects);
+    return collision;
+}
+
+// Rooms of 12x12 tiles walled off from each other, with one or two doorways per wall
+static Collision *MakeRoomsMap(const u32 size)
+{
+    const u32 room  = 13;
+    const u32 rooms = size / room;
+    RectInfo *rects = malloc(rooms * rooms * 6 * sizeof(RectInfo));
+    assert(rects && "[ERROR] Failed to alloc synthetic rects");
+
+    u32 count = 0;
+    u32 seed  = 0x6C8E9CF5u;
+    for (u32 ry = 0; ry < rooms; ry++) {
+        for (u32 rx = 0; rx < rooms; rx++)
+        {
+            const int x = (int)(rx * room);
+            const int y = (int)(ry * room);
+
+            // Top wall with a door, left wall with a door; a few rooms get a second one
+            const int doorX = 1 + (int)(NextRandom(&seed) % (room - 2));
+            const int doorY = 1 + (int)(NextRandom(&seed) % (room - 2));
+            rects[count++] = (RectInfo){ x, y, doorX, 1 };
+            rects[count++] = (RectInfo){ x + doorX + 1, y, (int)room - doorX - 1, 1 };
+            if (doorY > 1) rects[count++] = (RectInfo){ x, y + 1, 1, doorY - 1 };
+            rects[count++] = (RectInfo){ x, y + doorY + 1, 1, (int)room - doorY - 1 };
+
+            if (NextRandom(&seed) % 4 == 0) {
+                const int pillar = 3 + (int)(NextRandom(&seed) % (room - 6));
+                rects[count++] = (RectInfo){ x + pillar, y + pillar, 2, 2 };
+            }
+        }
+    }
+
+    Collision *collision = CreateCollision(rects, count, size, size, 32.0f, 32.0f);
+    free(rects);
+    return collision;
+}
+
+int main(const int argc, char **argv)
+{
+    if (argc != 2 && argc != 3) {
+        fprintf(stderr, "Usage: %s <maps_root> [queries]\n", argv[0]);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    BenchStats stats = { .queries = argc == 3 ? (u32)strtoul(argv[2], NULL, 10) : BENCH_DEFAULT_QUERIES };
+    if (stats.queries == 0) stats.queries = BENCH_DEFAULT_QUERIES;
+
+    char mapsDir[1024];
+    snprintf(mapsDir, sizeof(mapsDir), "%s/assets/tilemaps", argv[1]);
+    VisitFiles(mapsDir, "assets/tilemaps", BenchMap, &stats);
+
+    Collision *scattered = MakeScatteredMap(1024, 20000);
+    BenchCollision(&stats, "synthetic scattered", scattered);
+    DestroyCollision(scattered);
+
+    Collision *rooms = MakeRoomsMap(2048);
+    BenchCollision(&stats, "synthetic rooms", rooms);
+    DestroyCollision(rooms);
+
+    return stats.failed ? 1 : 0;
+}
\ No newline at end of file
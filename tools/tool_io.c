@@ -0,0 +1,96 @@
+#include "tool_io.h"
+#include "ivy/image_codec.h"
+
+#include <assert.h>
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+u8 *ReadWholeFile(const char *path, u32 *outSize)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    const long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    u8 *data = malloc(length > 0 ? (size_t)length : 1);
+    assert(data && "[ERROR] Out of memory!");
+
+    *outSize = (u32)fread(data, 1, (size_t)length, file);
+    fclose(file);
+    return data;
+}
+
+bool WriteWholeFile(const char *path, const u8 *data, const u32 size)
+{
+    MakeParentDirs(path);
+
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        fprintf(stderr, "[ERROR] Cannot create '%s'\n", path);
+        return false;
+    }
+
+    const bool ok = fwrite(data, 1, size, out) == size;
+    fclose(out);
+    return ok;
+}
+
+void MakeParentDirs(const char *path)
+{
+    char buffer[1024];
+    snprintf(buffer, sizeof(buffer), "%s", path);
+
+    for (char *p = buffer + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(buffer, 0755) != 0 && errno != EEXIST)
+            fprintf(stderr, "[ERROR] Cannot create '%s'\n", buffer);
+        *p = '/';
+    }
+}
+
+void VisitFiles(const char *dirPath, const char *keyPrefix, const VisitFileFunc visit, void *user)
+{
+    DIR *dir = opendir(dirPath);
+    if (!dir) return;
+
+    const struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL)
+    {
+        if (ent->d_name[0] == '.') continue;
+
+        char path[1024];
+        char key[1024];
+        snprintf(path, sizeof(path), "%s/%s", dirPath, ent->d_name);
+        snprintf(key,  sizeof(key),  "%s/%s", keyPrefix, ent->d_name);
+
+        struct stat st;
+        if (stat(path, &st) != 0) continue;
+
+        if (S_ISDIR(st.st_mode))      VisitFiles(path, key, visit, user);
+        else if (S_ISREG(st.st_mode)) visit(path, key, user);
+    }
+
+    closedir(dir);
+}
+
+bool IsRawImage(const u8 *data, const u32 size, u32 *outWidth, u32 *outHeight)
+{
+    int header[4];
+    if (size < RAW_IMAGE_HEADER_SIZE) return false;
+    memcpy(header, data, RAW_IMAGE_HEADER_SIZE);
+
+    if (header[0] <= 0 || header[1] <= 0 || header[2] != 1) return false;
+    if (header[3] != IMAGE_CODEC_FORMAT) return false;
+    if ((u64)header[0] * (u64)header[1] * 4 != (u64)size - RAW_IMAGE_HEADER_SIZE) return false;
+
+    *outWidth  = (u32)header[0];
+    *outHeight = (u32)header[1];
+    return true;
+}
\ No newline at end of file
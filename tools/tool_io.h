@@ -0,0 +1,20 @@
+#ifndef IVY_TOOL_IO_H
+#define IVY_TOOL_IO_H
+
+#include "ivy/types.h"
+
+#include <stdbool.h>
+
+#define RAW_IMAGE_HEADER_SIZE 16    // width, height, mipmaps, format
+
+typedef void (*VisitFileFunc)(const char *path, const char *key, void *user);
+
+u8     *ReadWholeFile(const char *path, u32 *outSize);
+bool    WriteWholeFile(const char *path, const u8 *data, u32 size);
+void    MakeParentDirs(const char *path);
+
+void    VisitFiles(const char *dirPath, const char *keyPrefix, VisitFileFunc visit, void *user);
+
+bool    IsRawImage(const u8 *data, u32 size, u32 *outWidth, u32 *outHeight);
+
+#endif
\ No newline at end of file